@@ -0,0 +1,292 @@
+/**
+  ******************************************************************************
+  * @file    dpl_bench.c
+  * @brief   动态数据长度、应答附带数据和不要求应答的主机端测试
+  * @note    仿真器件使用8MHz硬件SPI、2Mbps空中速率，按空中时间发射：
+  *            - 4字节命令：固定宽度（补齐到32字节）与动态数据长度的发送吞吐量、每包SPI字节数、接收端每包SPI字节数
+  *            - NRF_FEATURE_NO_ACK：每包只发射一次，链路中断时也不重发
+  *            - 请求/应答：切换收发模式与应答附带数据的往返时间，以及连续请求时每次交换的时间
+  *            - 接收端写入应答附带数据、TX FIFO满时拒绝，动态长度无效时清空RX FIFO
+  *          dpl_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_STEP_NS     1000      // 主循环每次检查IRQ引脚的间隔（1us）
+#define CMD_LEN           4         // 命令/应答长度
+
+static NrfDevice g_dev;
+static uint8_t g_link_ok = 1;
+static uint32_t g_air_count;
+static uint8_t g_air_len;
+
+/* 远端（接收端）模型：收到请求后准备应答，随下一包的应答发出 */
+static uint8_t g_remote_request;
+static uint8_t g_remote_loaded[CMD_LEN];
+static uint8_t g_remote_loaded_len;
+
+static uint8_t air_tx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    (void)addr;
+    g_air_count++;
+    g_air_len = len;
+    g_remote_request = data[0];
+    return g_link_ok;
+}
+
+static uint8_t air_ack(uint8_t *data)
+{
+    uint8_t len = g_remote_loaded_len;
+    
+    /* 发出已写入的应答附带数据，再为刚收到的请求准备应答 */
+    memcpy(data, g_remote_loaded, len);
+    g_remote_loaded[0] = 0xA0;
+    g_remote_loaded[1] = g_remote_request;
+    g_remote_loaded[2] = (uint8_t)~g_remote_request;
+    g_remote_loaded[3] = 0x5A;
+    g_remote_loaded_len = CMD_LEN;
+    return len;
+}
+
+static void setup(NrfMode mode, uint8_t features)
+{
+    NrfConfig config = nrf_bench_config(0x0E, features);
+    
+    nrf_bench_init(&g_dev, &nrf_transport_hw_spi, &config, air_tx);
+    nrf_sim.air_ack = air_ack;
+    nrf24l01_set_mode_ex(&g_dev, mode);
+    g_link_ok = 1;
+    g_air_count = 0;
+    g_remote_loaded_len = 0;
+}
+
+static void poll_irq(void)
+{
+    nrf_sim_advance(BENCH_STEP_NS);
+    if (nrf_sim_irq() == 0) {
+        nrf24l01_irq_handler(&g_dev);
+    }
+}
+
+/**
+  * @brief  流水线发送count个命令
+  * @retval 仿真时间（ns）
+  */
+static uint64_t send_commands(uint32_t count, uint8_t len, uint8_t no_ack)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint64_t t0 = nrf_sim.now_ns;
+    uint32_t sent = 0;
+    
+    while (sent < count || nrf24l01_tx_pending(&g_dev) > 0) {
+        while (sent < count) {
+            payload[0] = (uint8_t)sent;
+            if ((no_ack ? nrf24l01_send_noack(&g_dev, payload, len) :
+                          nrf24l01_send_queued(&g_dev, payload, len)) != NRF_OK) {
+                break;
+            }
+            sent++;
+        }
+        poll_irq();
+        CHECK(nrf_sim.now_ns - t0 < 10000000000ull);
+    }
+    return nrf_sim.now_ns - t0;
+}
+
+/**
+  * @brief  4字节命令：固定宽度（补齐到32字节）与动态数据长度
+  */
+static void bench_short_command(uint32_t count)
+{
+    uint8_t payload[CMD_LEN] = {1, 2, 3, 4};
+    NrfPacket batch[NRF_FIFO_DEPTH];
+    uint64_t ns_static, ns_dpl, ns_noack;
+    uint32_t bytes_static, bytes_dpl, rx_static, rx_dpl, i;
+    
+    setup(NRF_MODE_TX, 0);
+    bytes_static = nrf_sim.spi_bytes;
+    ns_static = send_commands(count, NRF_MAX_PAYLOAD, 0);
+    bytes_static = nrf_sim.spi_bytes - bytes_static;
+    CHECK(g_air_len == NRF_MAX_PAYLOAD);
+    
+    setup(NRF_MODE_TX, NRF_FEATURE_DYN_PAYLOAD);
+    CHECK(nrf_sim.reg[FEATURE] == NRF_FEATURE_DYN_PAYLOAD && nrf_sim.reg[DYNPD] == 0x01);
+    bytes_dpl = nrf_sim.spi_bytes;
+    ns_dpl = send_commands(count, CMD_LEN, 0);
+    bytes_dpl = nrf_sim.spi_bytes - bytes_dpl;
+    CHECK(g_air_len == CMD_LEN);
+    
+    /* 不要求应答：链路中断也只发射一次，回调NRF_OK */
+    setup(NRF_MODE_TX, NRF_FEATURE_DYN_PAYLOAD | NRF_FEATURE_NO_ACK);
+    g_link_ok = 0;
+    ns_noack = send_commands(count, CMD_LEN, 1);
+    CHECK(g_air_count == count && g_dev.tx_lost == 0);
+    
+    printf("4-byte command  fixed width %5.0f pps %4.1f SPI bytes | dynamic %5.0f pps %4.1f SPI bytes | "
+           "no_ack %5.0f pps\n",
+           count * 1e9 / ns_static, (double)bytes_static / count, count * 1e9 / ns_dpl,
+           (double)bytes_dpl / count, count * 1e9 / ns_noack);
+    CHECK(ns_dpl < ns_static && ns_noack < ns_dpl && bytes_dpl < bytes_static);
+    
+    /* 接收端：固定宽度每包读32字节，动态数据长度按R_RX_PL_WID读实际长度 */
+    setup(NRF_MODE_RX, 0);
+    rx_static = nrf_sim.spi_bytes;
+    CHECK(nrf_sim_rx_inject(0, payload, NRF_MAX_PAYLOAD));
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, NRF_FIFO_DEPTH) == 1 && batch[0].len == NRF_MAX_PAYLOAD);
+    rx_static = nrf_sim.spi_bytes - rx_static;
+    
+    setup(NRF_MODE_RX, NRF_FEATURE_DYN_PAYLOAD);
+    rx_dpl = nrf_sim.spi_bytes;
+    CHECK(nrf_sim_rx_inject(0, payload, CMD_LEN));
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, NRF_FIFO_DEPTH) == 1 && batch[0].len == CMD_LEN);
+    CHECK(memcmp(batch[0].data, payload, CMD_LEN) == 0);
+    rx_dpl = nrf_sim.spi_bytes - rx_dpl;
+    printf("receive 1 packet  fixed width %u SPI bytes | dynamic %u SPI bytes\n", rx_static, rx_dpl);
+    CHECK(rx_dpl < rx_static);
+    
+    /* 逐包接收按实际长度返回 */
+    for (i = 0; i < 2; i++) {
+        CHECK(nrf_sim_rx_inject(0, payload, (uint8_t)(2 + i)));
+    }
+    CHECK(nrf24l01_receive_packet_ex(&g_dev, batch[0].data, NRF_MAX_PAYLOAD) == 2);
+    CHECK(nrf24l01_receive_packet_ex(&g_dev, batch[0].data, NRF_MAX_PAYLOAD) == 3);
+}
+
+/**
+  * @brief  空中时间：一次发射加应答（含应答附带数据）
+  */
+static uint64_t exchange_airtime_ns(uint8_t len, uint8_t ack_len)
+{
+    return 260000 + (uint64_t)(len + 10 + ack_len + 10) * 8 * 1000000 / 2000;
+}
+
+/**
+  * @brief  请求/应答往返：切换收发模式与应答附带数据
+  */
+static void bench_round_trip(uint32_t count)
+{
+    uint8_t request[CMD_LEN] = {0x42, 0, 0, 0};
+    uint8_t reply[NRF_MAX_PAYLOAD];
+    uint64_t t0, t_switch, t_mode, t_ack, t_pipe;
+    uint32_t got, i;
+    uint8_t pipe;
+    
+    /* 切换收发模式：发送请求，切换到接收，远端同样切换后发回应答，再切换回发送 */
+    setup(NRF_MODE_TX, NRF_FEATURE_DYN_PAYLOAD);
+    t0 = nrf_sim.now_ns;
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_TX);
+    t_mode = nrf_sim.now_ns - t0;
+    
+    t0 = nrf_sim.now_ns;
+    CHECK(nrf24l01_send_packet_ex(&g_dev, request, CMD_LEN) == NRF_OK);
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    while (nrf_sim.now_ns < t0 + exchange_airtime_ns(CMD_LEN, 0) + t_mode + exchange_airtime_ns(CMD_LEN, 0)) {
+        nrf_sim_advance(BENCH_STEP_NS);
+    }
+    reply[0] = 0xA0;
+    reply[1] = request[0];
+    CHECK(nrf_sim_rx_inject(0, reply, CMD_LEN));
+    while (nrf24l01_receive_packet_ex(&g_dev, reply, sizeof(reply)) == 0) {
+        nrf_sim_advance(BENCH_STEP_NS);
+    }
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_TX);
+    t_switch = nrf_sim.now_ns - t0;
+    
+    /* 应答附带数据：请求的应答随下一包（轮询包）的应答返回，不切换模式 */
+    setup(NRF_MODE_TX, NRF_FEATURE_ACK_PAYLOAD);
+    CHECK(nrf_sim.reg[FEATURE] == (NRF_FEATURE_ACK_PAYLOAD | NRF_FEATURE_DYN_PAYLOAD));
+    t0 = nrf_sim.now_ns;
+    CHECK(nrf24l01_send_queued(&g_dev, request, CMD_LEN) == NRF_OK);
+    request[0] = 0x00;
+    CHECK(nrf24l01_send_queued(&g_dev, request, 1) == NRF_OK);
+    for (;;) {
+        poll_irq();
+        if (nrf24l01_receive_queued(&g_dev, reply, sizeof(reply), &pipe) > 0) {
+            break;
+        }
+        CHECK(nrf_sim.now_ns - t0 < 100000000ull);
+    }
+    t_ack = nrf_sim.now_ns - t0;
+    CHECK(pipe == 0 && reply[0] == 0xA0 && reply[1] == 0x42 && reply[2] == (uint8_t)~0x42);
+    
+    /* 连续请求：每包的应答带回上一个请求的应答 */
+    setup(NRF_MODE_TX, NRF_FEATURE_ACK_PAYLOAD);
+    t0 = nrf_sim.now_ns;
+    for (i = 0, got = 0; i <= count || got < count; ) {
+        if (i <= count) {
+            request[0] = (uint8_t)(i + 1);
+            if (nrf24l01_send_queued(&g_dev, request, CMD_LEN) == NRF_OK) {
+                i++;
+            }
+        }
+        poll_irq();
+        while (nrf24l01_receive_queued(&g_dev, reply, sizeof(reply), NULL) == CMD_LEN) {
+            CHECK(reply[1] == (uint8_t)(got + 1));
+            got++;
+        }
+        CHECK(nrf_sim.now_ns - t0 < 10000000000ull);
+    }
+    t_pipe = nrf_sim.now_ns - t0;
+    CHECK(g_dev.rx_overflow == 0);
+    
+    printf("request/reply  mode switching %7.1f us | ack payload %6.1f us | pipelined %6.1f us per exchange\n",
+           t_switch / 1000.0, t_ack / 1000.0, t_pipe / 1000.0 / count);
+    CHECK(t_ack < t_switch && t_pipe / count < t_ack);
+    CHECK(t_ack <= 2 * exchange_airtime_ns(CMD_LEN, CMD_LEN) + 200000);
+}
+
+/**
+  * @brief  接收端写入应答附带数据；参数与特性检查；无效长度
+  */
+static void test_receiver(void)
+{
+    uint8_t payload[CMD_LEN] = {9, 8, 7, 6};
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t i;
+    
+    /* 未启用特性时拒绝 */
+    setup(NRF_MODE_RX, 0);
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 1, payload, CMD_LEN) == NRF_ERROR);
+    CHECK(nrf24l01_send_noack(&g_dev, payload, CMD_LEN) == NRF_ERROR);
+    
+    setup(NRF_MODE_RX, NRF_FEATURE_ACK_PAYLOAD);
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 6, payload, CMD_LEN) == NRF_ERROR);
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 1, payload, CMD_LEN) == NRF_ERROR);     /* 只启用了通道0 */
+    for (i = 0; i < NRF_FIFO_DEPTH; i++) {
+        payload[0] = i;
+        CHECK(nrf24l01_write_ack_payload(&g_dev, 0, payload, CMD_LEN) == NRF_OK);
+    }
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 0, payload, CMD_LEN) == NRF_ERROR);
+    
+    /* 收到数据包：最早写入的应答附带数据随应答发出，置位TX_DS */
+    CHECK(nrf_sim_rx_inject(0, payload, 2));
+    CHECK(nrf_sim.ack_tx_count == 1 && nrf_sim.ack_tx.pipe == 0 && nrf_sim.ack_tx.data[0] == 0);
+    CHECK(nrf_sim.tx_count == 2 && (nrf_sim.reg[STATUS] & TX_OK));
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf_sim_irq() == 1 && nrf24l01_tx_pending(&g_dev) == 0);
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &i) == 2 && i == 0);
+    
+    /* 动态长度无效：清空RX FIFO */
+    CHECK(nrf_sim_rx_inject(0, payload, CMD_LEN));
+    nrf_sim.rx_fifo[0].len = NRF_MAX_PAYLOAD + 1;
+    CHECK(nrf24l01_receive_packet_ex(&g_dev, buf, sizeof(buf)) == 0);
+    CHECK(nrf_sim.rx_count == 0);
+    printf("receiver  ack payloads queued in TX FIFO, sent with the next ACK; invalid width flushes RX FIFO\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t count = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 100 : 1000;
+    
+    bench_short_command(count);
+    bench_round_trip(count);
+    test_receiver();
+    
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,444 @@
+/**
+  ******************************************************************************
+  * @file    hub_bench.c
+  * @brief   多通道接收（星形网络中心节点）主机端测试
+  * @note    5个机器人节点（通道1~5，通道1~3为8字节固定宽度，通道4、5为动态数据长度）每5ms各发一包遥测，
+  *          未收到应答时按500us间隔自动重发，最多15次。对比：
+  *            multiplex - 单通道接收，每1ms把RX_ADDR_P0切换到下一个节点（原分时做法）
+  *            hub       - nrf24l01_hub_config()同时接收5个通道，通道1~3交给处理函数，通道4、5进入接收队列
+  *          统计送达率、每包重发次数和延迟；检查寄存器配置、按地址和宽度接收、按通道路由和统计、
+  *          nrf24l01_hub_send()下行发送（重发/丢失计数、恢复接收、不自动应答的节点）、按通道的应答附带数据
+  *          hub_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_STEP_NS     10000     // 仿真步长（10us）
+#define NODE_COUNT        5         // 机器人节点数（通道1~5）
+#define NODE_PERIOD_NS    5000000   // 每个节点的发送周期（5ms）
+#define NODE_ARD_NS       500000    // 节点自动重发间隔（500us）
+#define NODE_RETRIES      15        // 节点自动重发次数
+#define SLOT_NS           1000000   // 分时接收每个节点的时隙（1ms）
+#define TELEMETRY_LEN     8         // 固定宽度节点的数据长度
+
+typedef enum {
+    MODE_MULTIPLEX = 0,
+    MODE_HUB
+} BenchMode;
+
+/**
+  * @brief  机器人节点（发送端）模型
+  */
+typedef struct {
+    uint8_t addr[RX_ADR_WIDTH];
+    uint8_t len;                    // 数据长度
+    uint16_t seq;                   // 当前数据包序号
+    uint8_t retries;                // 当前数据包已重发次数
+    uint64_t offset_ns;             // 第一包产生时间（各节点不同步）
+    uint64_t created_ns;            // 当前数据包产生时间
+    uint64_t next_ns;               // 下次发射时间
+    uint32_t sent, delivered, retransmits, lost;
+    uint16_t next_rx_seq;           // 中心节点下一个应收到的序号
+    uint64_t latency_ns;            // 送达延迟累计
+} Node;
+
+static NrfDevice g_dev;
+static Node g_nodes[NRF_PIPE_COUNT];
+static uint32_t g_handled[NRF_PIPE_COUNT];
+static const uint8_t g_p1_addr[RX_ADR_WIDTH] = {0xA1, 0x52, 0x4F, 0x42, 0x4F};
+
+/* 下行发送：节点应答情况 */
+static uint32_t g_air_fail;
+static uint8_t g_air_addr[RX_ADR_WIDTH];
+static uint8_t g_air_dynpd;
+static uint8_t g_air_en_aa;
+
+static uint8_t air_tx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    (void)data;
+    (void)len;
+    memcpy(g_air_addr, addr, RX_ADR_WIDTH);
+    g_air_dynpd = nrf_sim.reg[DYNPD];
+    g_air_en_aa = nrf_sim.reg[EN_AA];
+    if (g_air_fail > 0) {
+        g_air_fail--;
+        return 0;
+    }
+    return 1;
+}
+
+static void hub_config_make(NrfHubConfig *hub)
+{
+    uint8_t pipe;
+    
+    memset(hub, 0, sizeof(NrfHubConfig));
+    hub->pipes = 0x3E;
+    hub->auto_ack = 0x3E;
+    memset(hub->p0_addr, 0xE7, RX_ADR_WIDTH);
+    memcpy(hub->p1_addr, g_p1_addr, RX_ADR_WIDTH);
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        hub->addr_lsb[pipe] = (uint8_t)(0xA0 + pipe);
+        hub->width[pipe] = (pipe <= 3) ? TELEMETRY_LEN : 0;
+    }
+}
+
+static void setup(uint8_t features)
+{
+    NrfConfig config = nrf_bench_config(0x0E, features);
+    uint8_t pipe;
+    
+    nrf_bench_init(&g_dev, &nrf_transport_hw_spi, &config, air_tx);
+    g_air_fail = 0;
+    
+    memset(g_nodes, 0, sizeof(g_nodes));
+    memset(g_handled, 0, sizeof(g_handled));
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        memcpy(g_nodes[pipe].addr, g_p1_addr, RX_ADR_WIDTH);
+        g_nodes[pipe].addr[0] = (uint8_t)(0xA0 + pipe);
+        g_nodes[pipe].len = (pipe <= 3) ? TELEMETRY_LEN : (uint8_t)(4 + pipe * 3);
+        g_nodes[pipe].offset_ns = (uint64_t)pipe * 1730000 % NODE_PERIOD_NS;
+        g_nodes[pipe].created_ns = g_nodes[pipe].offset_ns;
+        g_nodes[pipe].next_ns = g_nodes[pipe].offset_ns;
+    }
+}
+
+/**
+  * @brief  中心节点收到一包：检查序号（节点重发不会产生重复包），统计延迟
+  */
+static void delivered(uint8_t pipe, const uint8_t *data, uint8_t len)
+{
+    Node *node = &g_nodes[pipe];
+    uint16_t seq = (uint16_t)(data[1] | (data[2] << 8));
+    
+    CHECK(pipe >= 1 && pipe < NRF_PIPE_COUNT && data[0] == pipe && len == node->len);
+    CHECK(seq >= node->next_rx_seq);
+    node->next_rx_seq = (uint16_t)(seq + 1);
+    node->delivered++;
+    node->latency_ns += nrf_sim.now_ns - (node->offset_ns + (uint64_t)seq * NODE_PERIOD_NS);
+}
+
+static void on_pipe_packet(NrfDevice *dev, const NrfPacket *packet)
+{
+    CHECK(dev == &g_dev);
+    g_handled[packet->pipe]++;
+    delivered(packet->pipe, packet->data, packet->len);
+}
+
+/**
+  * @brief  节点发射：中心节点收下则为送达，否则等待ARD后重发，重发用尽则丢弃
+  */
+static void nodes_run(void)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t pipe;
+    Node *node;
+    
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        node = &g_nodes[pipe];
+        if (nrf_sim.now_ns < node->next_ns) {
+            continue;
+        }
+        
+        memset(payload, pipe, sizeof(payload));
+        payload[1] = (uint8_t)node->seq;
+        payload[2] = (uint8_t)(node->seq >> 8);
+        if (nrf_sim_air_rx(node->addr, payload, node->len) != 0xFF) {
+            node->sent++;
+        } else if (node->retries < NODE_RETRIES) {
+            node->retries++;
+            node->retransmits++;
+            node->next_ns += NODE_ARD_NS;
+            continue;
+        } else {
+            node->sent++;
+            node->lost++;
+        }
+        
+        /* 下一包 */
+        node->seq++;
+        node->retries = 0;
+        node->created_ns += NODE_PERIOD_NS;
+        node->next_ns = node->created_ns;
+    }
+}
+
+static void bench_mode(BenchMode mode, uint64_t duration_ns)
+{
+    NrfHubConfig hub;
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t pipe, len, slot_pipe = 1;
+    uint64_t next_slot = 0;
+    uint32_t sent = 0, got = 0, retransmits = 0, lost = 0;
+    uint64_t latency = 0;
+    uint32_t spi_bytes;
+    
+    if (mode == MODE_MULTIPLEX) {
+        setup(NRF_FEATURE_DYN_PAYLOAD);
+        nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    } else {
+        setup(0);
+        hub_config_make(&hub);
+        CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_OK);
+        for (pipe = 1; pipe <= 3; pipe++) {
+            CHECK(nrf24l01_set_pipe_handler(&g_dev, pipe, on_pipe_packet) == NRF_OK);
+        }
+    }
+    nrf_sim.now_ns = 0;
+    spi_bytes = nrf_sim.spi_bytes;
+    
+    while (nrf_sim.now_ns < duration_ns) {
+        if (mode == MODE_MULTIPLEX && nrf_sim.now_ns >= next_slot) {
+            /* 切换到下一个节点的地址 */
+            nrf24l01_write_buf_ex(&g_dev, NRF_WRITE_REG + RX_ADDR_P0, g_nodes[slot_pipe].addr, RX_ADR_WIDTH);
+            slot_pipe = (uint8_t)(slot_pipe % NODE_COUNT + 1);
+            next_slot += SLOT_NS;
+        }
+        
+        nodes_run();
+        nrf_sim_advance(BENCH_STEP_NS);
+        if (nrf_sim_irq() == 0) {
+            nrf24l01_irq_handler(&g_dev);
+        }
+        
+        /* 主循环取出接收队列：分时接收时通道号总是0，按数据包内容区分节点 */
+        while ((len = nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe)) > 0) {
+            if (mode == MODE_MULTIPLEX) {
+                CHECK(pipe == 0);
+                pipe = buf[0];
+            } else {
+                CHECK(pipe == 4 || pipe == 5);
+            }
+            delivered(pipe, buf, len);
+        }
+    }
+    
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        sent += g_nodes[pipe].sent;
+        got += g_nodes[pipe].delivered;
+        retransmits += g_nodes[pipe].retransmits;
+        lost += g_nodes[pipe].lost;
+        latency += g_nodes[pipe].latency_ns;
+        if (mode == MODE_HUB) {
+            /* 中心节点的统计与节点一致，固定宽度通道全部交给处理函数 */
+            CHECK(nrf24l01_pipe_stats(&g_dev, pipe)->rx_packets == g_nodes[pipe].delivered);
+            CHECK(g_handled[pipe] == ((pipe <= 3) ? g_nodes[pipe].delivered : 0));
+        }
+    }
+    CHECK(got == sent - lost);
+    
+    printf("%-9s  delivered %5u/%5u (%5.1f%%)  %5.2f retransmits per packet  latency %7.1f us  "
+           "%6.0f SPI bytes per second\n",
+           mode == MODE_HUB ? "hub" : "multiplex", got, sent, 100.0 * got / sent, (double)retransmits / sent,
+           got > 0 ? latency / 1000.0 / got : 0.0, (nrf_sim.spi_bytes - spi_bytes) * 1e9 / duration_ns);
+    
+    if (mode == MODE_HUB) {
+        CHECK(lost == 0 && retransmits == 0 && g_dev.rx_overflow == 0);
+        CHECK(latency / got < 5 * BENCH_STEP_NS);
+    } else {
+        CHECK(retransmits > sent);
+    }
+}
+
+/**
+  * @brief  寄存器配置、参数检查、按地址和宽度接收
+  */
+static void test_config(void)
+{
+    NrfHubConfig hub;
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint8_t pipe, rx_pipe, len;
+    
+    setup(0);
+    hub_config_make(&hub);
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_OK);
+    CHECK(nrf_sim.reg[EN_RXADDR] == 0x3E && nrf_sim.reg[EN_AA] == 0x3E);
+    CHECK(memcmp(nrf_sim.rx_addr[0], hub.p0_addr, RX_ADR_WIDTH) == 0);
+    CHECK(memcmp(nrf_sim.rx_addr[1], g_p1_addr, RX_ADR_WIDTH) == 0);
+    for (pipe = 2; pipe < NRF_PIPE_COUNT; pipe++) {
+        CHECK(nrf_sim.reg[RX_ADDR_P0 + pipe] == 0xA0 + pipe);
+    }
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        CHECK(nrf_sim.reg[RX_PW_P0 + pipe] == ((pipe <= 3) ? TELEMETRY_LEN : NRF_MAX_PAYLOAD));
+    }
+    CHECK(nrf_sim.reg[DYNPD] == 0x30 && nrf_sim.reg[FEATURE] == NRF_FEATURE_DYN_PAYLOAD);
+    CHECK((nrf_sim.reg[CONFIG] & 0x03) == 0x03 && nrf_sim.ce == 1);
+    
+    /* 每个节点按自己的通道收下；未知地址、固定宽度通道长度不符时不接收 */
+    for (pipe = 1; pipe < NRF_PIPE_COUNT; pipe++) {
+        payload[0] = pipe;
+        CHECK(nrf_sim_air_rx(g_nodes[pipe].addr, payload, g_nodes[pipe].len) == pipe);
+        nrf24l01_irq_handler(&g_dev);
+        len = nrf24l01_receive_queued(&g_dev, payload, sizeof(payload), &rx_pipe);
+        CHECK(rx_pipe == pipe && payload[0] == pipe && len == g_nodes[pipe].len);
+        CHECK(nrf24l01_pipe_stats(&g_dev, pipe)->rx_packets == 1);
+    }
+    payload[0] = 0x77;
+    CHECK(nrf_sim_air_rx(hub.p0_addr, payload, 4) == 0xFF);
+    CHECK(nrf_sim_air_rx(g_nodes[2].addr, payload, TELEMETRY_LEN + 1) == 0xFF);
+    CHECK(nrf_sim.rx_count == 0);
+    
+    /* 参数检查 */
+    hub.pipes = 0;
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_ERROR);
+    hub.pipes = 0x40;
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_ERROR);
+    hub.pipes = 0x3E;
+    hub.width[3] = NRF_MAX_PAYLOAD + 1;
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_ERROR);
+    hub.width[3] = TELEMETRY_LEN;
+    hub.auto_ack = 0x2E;                                                        /* 通道4动态数据长度但不自动应答 */
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_ERROR);
+    hub.auto_ack = 0x3E;
+    CHECK(nrf24l01_set_pipe_handler(&g_dev, NRF_PIPE_COUNT, on_pipe_packet) == NRF_ERROR);
+    CHECK(nrf24l01_pipe_stats(&g_dev, NRF_PIPE_COUNT) == NULL);
+    CHECK(nrf24l01_hub_send(&g_dev, 0, payload, 4) == NRF_ERROR);
+    
+    /* 恢复只用通道0 */
+    CHECK(nrf24l01_hub_config(&g_dev, NULL) == NRF_OK);
+    CHECK(nrf_sim.reg[EN_RXADDR] == 0x01 && nrf_sim.reg[DYNPD] == 0x00);
+    CHECK(nrf24l01_hub_send(&g_dev, 1, payload, 4) == NRF_ERROR);
+    printf("config    6 pipe addresses, widths and DYNPD programmed; packets routed by pipe\n");
+}
+
+/**
+  * @brief  下行发送：按节点地址发送，统计重发和丢失，结束后恢复多通道接收
+  */
+static void test_hub_send(void)
+{
+    NrfHubConfig hub;
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    const NrfPipeStats *stats;
+    uint8_t pipe;
+    
+    setup(0);
+    hub_config_make(&hub);
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_OK);
+    
+    /* 发送前已收到的数据包不受影响 */
+    payload[0] = 1;
+    CHECK(nrf_sim_air_rx(g_nodes[1].addr, payload, TELEMETRY_LEN) == 1);
+    
+    g_air_fail = 2;
+    CHECK(nrf24l01_hub_send(&g_dev, 3, payload, TELEMETRY_LEN) == NRF_OK);
+    CHECK(memcmp(g_air_addr, g_nodes[3].addr, RX_ADR_WIDTH) == 0);
+    stats = nrf24l01_pipe_stats(&g_dev, 3);
+    CHECK(stats->tx_packets == 1 && stats->tx_retransmits == 2 && stats->tx_lost == 0);
+    
+    /* 动态数据长度的节点：发送期间DYNPD包含通道0 */
+    CHECK(nrf24l01_hub_send(&g_dev, 4, payload, 5) == NRF_OK);
+    CHECK(memcmp(g_air_addr, g_nodes[4].addr, RX_ADR_WIDTH) == 0 && g_air_dynpd == 0x31);
+    
+    /* 节点不应答：自动重发10次后失败 */
+    g_air_fail = 100;
+    CHECK(nrf24l01_hub_send(&g_dev, 5, payload, 4) == NRF_ERROR);
+    stats = nrf24l01_pipe_stats(&g_dev, 5);
+    CHECK(stats->tx_packets == 0 && stats->tx_retransmits == 10 && stats->tx_lost == 1);
+    CHECK(nrf_sim.tx_count == 0);
+    g_air_fail = 0;
+    
+    /* 恢复多通道接收 */
+    CHECK((nrf_sim.reg[CONFIG] & 0x03) == 0x03 && nrf_sim.ce == 1);
+    CHECK(memcmp(nrf_sim.rx_addr[0], hub.p0_addr, RX_ADR_WIDTH) == 0);
+    CHECK(nrf_sim.reg[EN_RXADDR] == 0x3E && nrf_sim.reg[EN_AA] == 0x3E && nrf_sim.reg[DYNPD] == 0x30);
+    payload[0] = 2;
+    CHECK(nrf_sim_air_rx(g_nodes[2].addr, payload, TELEMETRY_LEN) == 2);
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe) == TELEMETRY_LEN && pipe == 1 && buf[0] == 1);
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe) == TELEMETRY_LEN && pipe == 2 && buf[0] == 2);
+    CHECK(nrf_sim_irq() == 1);
+    
+    /* 发送队列非空时不清空TX FIFO */
+    g_air_fail = 100;
+    CHECK(nrf24l01_send_queued(&g_dev, payload, 4) == NRF_OK && nrf24l01_tx_pending(&g_dev) == 1);
+    CHECK(nrf24l01_hub_send(&g_dev, 3, payload, TELEMETRY_LEN) == NRF_ERROR);
+    CHECK(nrf24l01_tx_pending(&g_dev) == 1 && nrf_sim.tx_count == 1);
+    g_air_fail = 0;
+    printf("hub_send  node addressed by pipe, retransmits 2, lost after 10 retries, listening restored\n");
+}
+
+/**
+  * @brief  下行发送到不自动应答的节点：发送端不等待应答，发出一次即成功
+  */
+static void test_hub_send_noack(void)
+{
+    NrfHubConfig hub;
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    const NrfPipeStats *stats;
+    uint32_t air_packets;
+    
+    setup(0);
+    hub_config_make(&hub);
+    hub.auto_ack = 0x3A;                                                        /* 通道2固定宽度，不自动应答 */
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_OK);
+    CHECK(nrf_sim.reg[EN_AA] == 0x3A);
+    
+    /* 节点不发应答：仍只发射一次并报告成功 */
+    g_air_fail = 100;
+    air_packets = nrf_sim.air_packets;
+    CHECK(nrf24l01_hub_send(&g_dev, 2, payload, TELEMETRY_LEN) == NRF_OK);
+    CHECK(nrf_sim.air_packets - air_packets == 1 && (g_air_en_aa & 0x01) == 0);
+    stats = nrf24l01_pipe_stats(&g_dev, 2);
+    CHECK(stats->tx_packets == 1 && stats->tx_retransmits == 0 && stats->tx_lost == 0);
+    
+    /* 自动应答的节点仍等待应答 */
+    g_air_fail = 0;
+    CHECK(nrf24l01_hub_send(&g_dev, 3, payload, TELEMETRY_LEN) == NRF_OK && (g_air_en_aa & 0x01) == 1);
+    CHECK(nrf_sim.reg[EN_AA] == 0x3A && (nrf_sim.reg[CONFIG] & 0x03) == 0x03);
+    printf("hub_send  node without auto-ack: sent once, reported delivered without waiting for an ACK\n");
+}
+
+/**
+  * @brief  按通道的应答附带数据；接收队列满时按通道计数
+  */
+static void test_ack_payload(void)
+{
+    NrfHubConfig hub;
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint8_t i;
+    
+    setup(NRF_FEATURE_ACK_PAYLOAD);
+    hub_config_make(&hub);
+    CHECK(nrf24l01_hub_config(&g_dev, &hub) == NRF_OK);
+    CHECK(nrf_sim.reg[DYNPD] == 0x3E);
+    
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 0, payload, 2) == NRF_ERROR);           /* 通道0未启用 */
+    payload[0] = 0x53;
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 3, payload, 2) == NRF_OK);
+    payload[0] = 0x55;
+    CHECK(nrf24l01_write_ack_payload(&g_dev, 5, payload, 2) == NRF_OK);
+    CHECK(nrf_sim_air_rx(g_nodes[5].addr, payload, 6) == 5);
+    CHECK(nrf_sim.ack_tx.pipe == 5 && nrf_sim.ack_tx.data[0] == 0x55);
+    CHECK(nrf_sim_air_rx(g_nodes[3].addr, payload, 6) == 3);
+    CHECK(nrf_sim.ack_tx.pipe == 3 && nrf_sim.ack_tx.data[0] == 0x53);
+    nrf24l01_irq_handler(&g_dev);
+    
+    /* 接收队列满：丢弃的数据包计入该通道 */
+    for (i = 0; i < NRF_RX_QUEUE_SIZE; i++) {
+        CHECK(nrf_sim_air_rx(g_nodes[4].addr, payload, 6) == 4);
+        nrf24l01_irq_handler(&g_dev);
+    }
+    CHECK(nrf24l01_pipe_stats(&g_dev, 4)->rx_packets == NRF_RX_QUEUE_SIZE);
+    CHECK(nrf24l01_pipe_stats(&g_dev, 4)->rx_dropped == 2 && g_dev.rx_overflow == 2);
+    printf("ack       ack payload sent on its own pipe; queue overflow counted per pipe\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t duration = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 500000000ull : 5000000000ull;
+    
+    bench_mode(MODE_MULTIPLEX, duration);
+    bench_mode(MODE_HUB, duration);
+    test_config();
+    test_hub_send();
+    test_hub_send_noack();
+    test_ack_payload();
+    
+    printf("OK\n");
+    return 0;
+}
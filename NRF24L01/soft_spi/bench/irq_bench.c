@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file    irq_bench.c
+  * @brief   中断驱动收发主机端测试
+  * @note    仿真器件使用硬件SPI传输层，SPI每字节1us（8MHz），按空中时间发射：
+  *            - 链路正常/中断（无应答）时，阻塞发送nrf24l01_send_packet_ex()占用调用者的时间，
+  *              与nrf24l01_send_async()返回前的时间及IRQ后tx_done回调的时延对比
+  *            - MAX_RT后回调NRF_ERROR并清空TX FIFO，上一包未结束时拒绝发送
+  *            - 接收数据包进入队列（含通道号），队列满时计数丢弃，RX FIFO清空后IRQ释放
+  *            - 每次中断处理的SPI事务数
+  *            - DMA传输层：中断处理中的长传输不使用DMA；异步传输进行中到来的IRQ在传输完成后补处理
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_STEP_NS     10000     // 主循环每次检查IRQ引脚的间隔（10us）
+
+static NrfDevice g_dev;
+static uint8_t g_link_ok = 1;
+static uint32_t g_tx_done;
+static NrfStatus g_tx_result;
+static uint32_t g_rx_ready;
+
+static uint8_t air_tx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    (void)addr;
+    (void)data;
+    (void)len;
+    return g_link_ok;
+}
+
+static void on_tx_done(NrfDevice *dev, NrfStatus result)
+{
+    CHECK(dev == &g_dev);
+    g_tx_done++;
+    g_tx_result = result;
+}
+
+static void on_rx_ready(NrfDevice *dev)
+{
+    CHECK(dev == &g_dev);
+    g_rx_ready++;
+}
+
+static const NrfCallbacks g_callbacks = {on_tx_done, on_rx_ready};
+
+static void setup(NrfMode mode)
+{
+    nrf_bench_init(&g_dev, &nrf_transport_hw_spi, NULL, air_tx);
+    nrf24l01_set_callbacks(&g_dev, &g_callbacks);
+    nrf24l01_set_mode_ex(&g_dev, mode);
+    g_tx_done = 0;
+    g_rx_ready = 0;
+}
+
+/**
+  * @brief  主循环：每BENCH_STEP_NS检查一次IRQ引脚，为低时调用中断处理，直到tx_done回调
+  * @retval 从调用到回调的仿真时间（ns）
+  */
+static uint64_t wait_tx_done(void)
+{
+    uint64_t start = nrf_sim.now_ns;
+    uint32_t done = g_tx_done;
+    
+    while (g_tx_done == done) {
+        nrf_sim_advance(BENCH_STEP_NS);
+        if (nrf_sim_irq() == 0) {
+            nrf24l01_irq_handler(&g_dev);
+        }
+        CHECK(nrf_sim.now_ns - start < 1000000000ull);
+    }
+    return nrf_sim.now_ns - start;
+}
+
+/**
+  * @brief  发送：阻塞与非阻塞占用调用者的时间
+  */
+static void test_send(uint8_t link_ok)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint64_t t0, blocking, call, latency;
+    uint32_t transactions;
+    NrfStatus ret;
+    
+    memset(payload, 0x42, sizeof(payload));
+    g_link_ok = link_ok;
+    
+    /* 阻塞发送 */
+    setup(NRF_MODE_TX);
+    t0 = nrf_sim.now_ns;
+    ret = nrf24l01_send_packet_ex(&g_dev, payload, NRF_MAX_PAYLOAD);
+    blocking = nrf_sim.now_ns - t0;
+    CHECK(ret == (link_ok ? NRF_OK : NRF_ERROR));
+    
+    /* 非阻塞发送 */
+    setup(NRF_MODE_TX);
+    t0 = nrf_sim.now_ns;
+    CHECK(nrf24l01_send_async(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_OK);
+    call = nrf_sim.now_ns - t0;
+    CHECK(call == (NRF_MAX_PAYLOAD + 1) * 1000ull);
+    CHECK(nrf24l01_send_async(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_ERROR);
+    
+    transactions = nrf_sim.transactions;
+    latency = wait_tx_done() + call;
+    CHECK(g_tx_done == 1 && g_tx_result == (link_ok ? NRF_OK : NRF_ERROR));
+    CHECK(nrf24l01_tx_pending(&g_dev) == 0 && nrf_sim.tx_count == 0 && nrf_sim_irq() == 1);
+    /* NOP读STATUS + 清除标志（MAX_RT另加FLUSH_TX） */
+    CHECK(nrf_sim.transactions - transactions == (link_ok ? 2u : 3u));
+    if (!link_ok) {
+        CHECK((nrf_sim.reg[OBSERVE_TX] & 0x0F) == 10);
+    }
+    
+    printf("%-8s  blocking send %7.1f us in caller | send_async %4.1f us in caller, tx_done after %7.1f us, "
+           "handler %u SPI transactions\n",
+           link_ok ? "link ok" : "no ack", blocking / 1000.0, call / 1000.0, latency / 1000.0,
+           nrf_sim.transactions - transactions);
+    
+    /* 回调后可以立即发送下一包 */
+    CHECK(nrf24l01_send_async(&g_dev, payload, 4) == NRF_OK);
+    g_link_ok = 1;
+}
+
+/**
+  * @brief  接收队列
+  */
+static void test_receive(void)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t i, pipe;
+    uint32_t transactions;
+    
+    setup(NRF_MODE_RX);
+    
+    /* 无中断标志：只读一次STATUS */
+    transactions = nrf_sim.transactions;
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf_sim.transactions - transactions == 1 && g_rx_ready == 0);
+    
+    /* 两个数据包：一次中断全部取出 */
+    for (i = 0; i < 2; i++) {
+        memset(payload, i, sizeof(payload));
+        CHECK(nrf_sim_rx_inject(i, payload, NRF_MAX_PAYLOAD));
+    }
+    CHECK(nrf_sim_irq() == 0);
+    transactions = nrf_sim.transactions;
+    nrf24l01_irq_handler(&g_dev);
+    printf("receive   2 packets in one interrupt: %u SPI transactions\n", nrf_sim.transactions - transactions);
+    CHECK(g_rx_ready == 1 && nrf_sim.rx_count == 0 && nrf_sim_irq() == 1);
+    
+    /* 缓冲区长度为0：不取出，数据包留在队列中 */
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, 0, &pipe) == 0);
+    CHECK(nrf24l01_receive_queued(&g_dev, NULL, sizeof(buf), &pipe) == 0);
+    for (i = 0; i < 2; i++) {
+        CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe) == NRF_MAX_PAYLOAD);
+        CHECK(pipe == i && buf[0] == i && buf[NRF_MAX_PAYLOAD - 1] == i);
+    }
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe) == 0);
+    
+    /* 队列满：多出的数据包丢弃并计数，RX FIFO仍被清空 */
+    for (i = 0; i < NRF_RX_QUEUE_SIZE + 1; i++) {
+        memset(payload, 0x10 + i, sizeof(payload));
+        CHECK(nrf_sim_rx_inject(1, payload, NRF_MAX_PAYLOAD));
+        if (nrf_sim.rx_count == 3 || i == NRF_RX_QUEUE_SIZE) {
+            nrf24l01_irq_handler(&g_dev);
+        }
+    }
+    CHECK(g_dev.rx_overflow == 1 && nrf_sim.rx_count == 0 && nrf_sim_irq() == 1);
+    for (i = 0; i < NRF_RX_QUEUE_SIZE; i++) {
+        CHECK(nrf24l01_receive_queued(&g_dev, buf, 4, NULL) == 4 && buf[0] == 0x10 + i);
+    }
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), NULL) == 0);
+}
+
+/**
+  * @brief  DMA传输层上的中断处理：DMA完成中断不会在IRQ处理中到来（同优先级），处理中不能等待DMA
+  */
+static void test_dma(void)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint32_t dma_calls, transactions;
+    
+    nrf_bench_init(&g_dev, &nrf_transport_hw_spi_dma, NULL, air_tx);
+    nrf24l01_set_callbacks(&g_dev, &g_callbacks);
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    nrf_sim.dma_deferred = 1;
+    g_rx_ready = 0;
+    memset(payload, 0x5C, sizeof(payload));
+    
+    /* 33字节的RD_RX_PLOAD在中断处理中阻塞完成，不启动DMA */
+    CHECK(nrf_sim_rx_inject(1, payload, NRF_MAX_PAYLOAD));
+    dma_calls = nrf_sim.dma_calls;
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf_sim.dma_calls == dma_calls && nrf_sim.dma_pending == NULL);
+    CHECK(g_rx_ready == 1 && nrf_sim_irq() == 1);
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), NULL) == NRF_MAX_PAYLOAD && buf[0] == 0x5C);
+    
+    /* 异步传输进行中到来的IRQ：不访问SPI，传输完成后在完成中断中补处理 */
+    CHECK(nrf24l01_transfer_async(&g_dev, W_ACK_PAYLOAD, payload, NULL, NRF_MAX_PAYLOAD, NULL) == NRF_OK);
+    CHECK(g_dev.xfer_busy && nrf_sim.dma_pending == &g_dev);
+    CHECK(nrf_sim_rx_inject(2, payload, NRF_MAX_PAYLOAD));
+    transactions = nrf_sim.transactions;
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf_sim.transactions == transactions && g_rx_ready == 1 && nrf_sim_irq() == 0);
+    CHECK(nrf_sim_dma_complete());
+    CHECK(!g_dev.xfer_busy && g_rx_ready == 2 && nrf_sim_irq() == 1);
+    CHECK(nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), NULL) == NRF_MAX_PAYLOAD && buf[0] == 0x5C);
+    printf("dma       receive in handler without DMA, IRQ during async transfer handled on completion\n");
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+    
+    test_send(1);
+    test_send(0);
+    test_receive();
+    test_dma();
+    
+    printf("OK\n");
+    return 0;
+}
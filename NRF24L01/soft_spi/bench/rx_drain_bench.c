@@ -0,0 +1,185 @@
+/**
+  ******************************************************************************
+  * @file    rx_drain_bench.c
+  * @brief   RX FIFO读空主机端测试
+  * @note    向仿真器件的RX FIFO连续注入3包（不同通道）后读取，对比：
+  *            legacy  - 原nrf24l01_receive_packet()的做法：读一包后FLUSH_RX（用公开接口复现）
+  *            packet  - nrf24l01_receive_packet_ex()，每次一包，其余留在RX FIFO
+  *            batch   - nrf24l01_receive_batch()，一次读出全部
+  *            irq     - nrf24l01_irq_handler()读入接收队列
+  *          检查数据包全部按顺序到达、通道号正确、RX_DR在RX FIFO读空后才清除，
+  *          统计每包的SPI事务数和字节数
+  *          rx_drain_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BURST   NRF_FIFO_DEPTH
+
+typedef enum {
+    MODE_LEGACY = 0,
+    MODE_PACKET,
+    MODE_BATCH,
+    MODE_IRQ
+} BenchMode;
+
+static const char *const g_mode_names[] = {"legacy", "packet", "batch", "irq"};
+
+static NrfDevice g_dev;
+
+/**
+  * @brief  原接收流程：读STATUS，RX_DR时读一包、FLUSH_RX、清除标志
+  */
+static uint8_t legacy_receive(uint8_t *data, uint8_t len)
+{
+    uint8_t sta = nrf24l01_read_reg_ex(&g_dev, STATUS);
+    
+    if (sta & RX_OK) {
+        nrf24l01_read_buf_ex(&g_dev, RD_RX_PLOAD, data, len);
+        nrf24l01_write_reg_ex(&g_dev, FLUSH_RX, 0xFF);
+        nrf24l01_write_reg_ex(&g_dev, NRF_WRITE_REG + STATUS, sta);
+        return len;
+    }
+    return 0;
+}
+
+/**
+  * @brief  读出当前RX FIFO中的数据包，检查序号和通道号
+  * @retval 读到的数据包数
+  */
+static uint32_t drain(BenchMode mode, uint32_t *next_seq)
+{
+    NrfPacket batch[BURST];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t n, pipe;
+    uint32_t got = 0;
+    
+    switch (mode) {
+    case MODE_LEGACY:
+        while (legacy_receive(buf, NRF_MAX_PAYLOAD) > 0) {
+            *next_seq = buf[0] + 1u;
+            got++;
+        }
+        break;
+    case MODE_PACKET:
+        while (nrf24l01_receive_packet_ex(&g_dev, buf, sizeof(buf)) > 0) {
+            CHECK(buf[0] == (uint8_t)*next_seq);
+            (*next_seq)++;
+            got++;
+            /* 最后一包读出前RX_DR保持置位 */
+            CHECK((nrf_sim.rx_count > 0) == ((nrf_sim.reg[STATUS] & RX_OK) != 0));
+        }
+        break;
+    case MODE_BATCH:
+        n = nrf24l01_receive_batch(&g_dev, batch, BURST);
+        for (pipe = 0; pipe < n; pipe++) {
+            CHECK(batch[pipe].data[0] == (uint8_t)*next_seq && batch[pipe].pipe == *next_seq % 6);
+            CHECK(batch[pipe].len == NRF_MAX_PAYLOAD);
+            (*next_seq)++;
+        }
+        got = n;
+        break;
+    case MODE_IRQ:
+        if (nrf_sim_irq() == 0) {
+            nrf24l01_irq_handler(&g_dev);
+        }
+        while (nrf24l01_receive_queued(&g_dev, buf, sizeof(buf), &pipe) > 0) {
+            CHECK(buf[0] == (uint8_t)*next_seq && pipe == *next_seq % 6);
+            (*next_seq)++;
+            got++;
+        }
+        break;
+    }
+    return got;
+}
+
+static void bench_mode(BenchMode mode, uint32_t bursts)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint32_t b, k, seq = 0, next_seq = 0, got = 0;
+    uint32_t transactions, bytes;
+    
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, &nrf_transport_hw_spi, NULL) == NRF_OK);
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    transactions = nrf_sim.transactions;
+    bytes = nrf_sim.spi_bytes;
+    
+    for (b = 0; b < bursts; b++) {
+        for (k = 0; k < BURST; k++, seq++) {
+            memset(payload, (int)seq, sizeof(payload));
+            CHECK(nrf_sim_rx_inject((uint8_t)(seq % 6), payload, NRF_MAX_PAYLOAD));
+        }
+        got += drain(mode, &next_seq);
+        /* 读取后RX FIFO为空，IRQ释放 */
+        CHECK(nrf_sim.rx_count == 0 && nrf_sim_irq() == 1);
+    }
+    
+    transactions = nrf_sim.transactions - transactions;
+    bytes = nrf_sim.spi_bytes - bytes;
+    printf("%-6s  received %5u/%5u packets  %5.2f SPI transactions, %5.1f bytes per packet\n",
+           g_mode_names[mode], got, seq, (double)transactions / got, (double)bytes / got);
+    
+    if (mode == MODE_LEGACY) {
+        /* 每次突发只收到第一包 */
+        CHECK(got == bursts);
+    } else {
+        CHECK(got == seq && next_seq == seq);
+    }
+    if (mode == MODE_BATCH || mode == MODE_IRQ) {
+        /* FIFO_STATUS + 每包（读出 + FIFO_STATUS）+ 清除RX_DR + 确认 */
+        CHECK(transactions == bursts * (1 + 2 * BURST + 2));
+    }
+}
+
+/**
+  * @brief  batch容量不足：剩余数据包保留，RX_DR保持置位
+  */
+static void test_partial_batch(void)
+{
+    NrfPacket batch[BURST];
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint8_t i;
+    
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, &nrf_transport_hw_spi, NULL) == NRF_OK);
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, BURST) == 0);
+    
+    for (i = 0; i < BURST; i++) {
+        payload[0] = i;
+        CHECK(nrf_sim_rx_inject(i, payload, NRF_MAX_PAYLOAD));
+    }
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, 2) == 2);
+    CHECK(batch[0].pipe == 0 && batch[1].pipe == 1 && batch[1].data[0] == 1);
+    CHECK(nrf_sim.rx_count == 1 && nrf_sim_irq() == 0);
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, 2) == 1);
+    CHECK(batch[0].pipe == 2 && batch[0].data[0] == 2);
+    CHECK(nrf_sim.rx_count == 0 && nrf_sim_irq() == 1);
+    
+    /* RX_DR置位但RX FIFO为空：清除标志 */
+    nrf_sim.reg[STATUS] |= RX_OK;
+    CHECK(nrf24l01_receive_batch(&g_dev, batch, BURST) == 0 && nrf_sim_irq() == 1);
+    nrf_sim.reg[STATUS] |= RX_OK;
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(nrf_sim_irq() == 1);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t bursts = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 100 : 10000;
+    int mode;
+    
+    for (mode = MODE_LEGACY; mode <= MODE_IRQ; mode++) {
+        bench_mode((BenchMode)mode, bursts);
+    }
+    test_partial_batch();
+    
+    printf("OK\n");
+    return 0;
+}
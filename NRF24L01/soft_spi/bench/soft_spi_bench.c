@@ -0,0 +1,106 @@
+/**
+  ******************************************************************************
+  * @file    soft_spi_bench.c
+  * @brief   软件SPI高速模式主机端测试
+  * @note    按不同配置编译为多个程序：
+  *            default    - 默认软件SPI：每位调用user_nrf_sck_write()/mosi/miso，两次user_delay_us(1)
+  *            fast_hooks - NRF_SOFT_SPI_FAST=1，引脚访问宏使用默认的user_nrf_xxx()
+  *            fast       - NRF_SOFT_SPI_FAST=1，引脚访问宏直接读写模拟GPIO寄存器（host/nrf24l01_sim_port.h）
+  *            fast_delay - 同fast，NRF_SPI_HALF_CYCLES=64，按周期计数器延时
+  *          检查寄存器/FIFO读写结果正确，统计每字节用户函数调用次数、GPIO寄存器访问次数和耗时，
+  *          fast_delay检查每字节耗时不少于16个半周期
+  *          soft_spi_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static NrfDevice g_dev;
+
+/**
+  * @brief  寄存器、TX FIFO、RX FIFO读写结果正确
+  */
+static void test_transfers(void)
+{
+    uint8_t addr[5] = {0x3C, 0xA5, 0x0F, 0xF0, 0x81};
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t i;
+    
+    for (i = 0; i < NRF_MAX_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(i * 37 + 11);
+    }
+    
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, NULL, NULL) == NRF_OK);
+    
+    CHECK(nrf24l01_write_buf_ex(&g_dev, NRF_WRITE_REG + RX_ADDR_P0, addr, 5) == 0x0E);
+    CHECK(memcmp(nrf_sim.rx_addr[0], addr, 5) == 0);
+    CHECK(nrf24l01_read_buf_ex(&g_dev, RX_ADDR_P0, buf, 5) == 0x0E);
+    CHECK(memcmp(buf, addr, 5) == 0);
+    
+    nrf24l01_write_reg_ex(&g_dev, NRF_WRITE_REG + RF_CH, 0x6B);
+    CHECK(nrf24l01_read_reg_ex(&g_dev, RF_CH) == 0x6B);
+    
+    nrf24l01_write_buf_ex(&g_dev, WR_TX_PLOAD, payload, NRF_MAX_PAYLOAD);
+    CHECK(nrf_sim.tx_count == 1 && memcmp(nrf_sim.tx_fifo[0].data, payload, NRF_MAX_PAYLOAD) == 0);
+    
+    CHECK(nrf_sim_rx_inject(1, payload, NRF_MAX_PAYLOAD));
+    CHECK(nrf24l01_read_buf_ex(&g_dev, RD_RX_PLOAD, buf, NRF_MAX_PAYLOAD) == (RX_OK | (1 << 1)));
+    CHECK(memcmp(buf, payload, NRF_MAX_PAYLOAD) == 0 && nrf_sim.rx_count == 0);
+}
+
+int main(int argc, char **argv)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint32_t count = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 2000 : 100000;
+    uint32_t i, bytes;
+    uint64_t t0, t1;
+    double per_byte;
+    
+    printf("soft_spi_bench: NRF_SOFT_SPI_FAST=%d NRF_SPI_HALF_CYCLES=%d\n", NRF_SOFT_SPI_FAST, NRF_SPI_HALF_CYCLES);
+    test_transfers();
+    
+    /* 每次32字节写入：一个SPI事务33字节 */
+    memset(payload, 0x5A, sizeof(payload));
+    nrf_sim_reset();
+    t0 = bench_now();
+    for (i = 0; i < count; i++) {
+        nrf24l01_write_buf_ex(&g_dev, NRF_WRITE_REG + TX_ADDR, payload, NRF_MAX_PAYLOAD);
+    }
+    t1 = bench_now();
+    
+    bytes = nrf_sim.spi_bytes;
+    CHECK(bytes == count * (NRF_MAX_PAYLOAD + 1));
+    per_byte = (double)(t1 - t0) / bytes;
+    printf("per byte: hooks %.2f (sck %.2f mosi %.2f miso %.2f delay %.2f)  gpio writes %.2f reads %.2f  %.1f %s\n",
+           (double)(nrf_sim.sck_calls + nrf_sim.mosi_calls + nrf_sim.miso_calls + nrf_sim.delay_calls) / bytes,
+           (double)nrf_sim.sck_calls / bytes, (double)nrf_sim.mosi_calls / bytes,
+           (double)nrf_sim.miso_calls / bytes, (double)nrf_sim.delay_calls / bytes,
+           (double)nrf_sim.gpio_writes / bytes, (double)nrf_sim.gpio_reads / bytes, per_byte, BENCH_UNIT);
+    
+#if !NRF_SOFT_SPI_FAST
+    /* 每位SCK两次、MOSI一次、MISO一次、延时两次，每字节结束再拉低一次SCK */
+    CHECK(nrf_sim.sck_calls == bytes * 17 && nrf_sim.delay_calls == bytes * 16);
+#else
+    /* 不调用user_delay_us()；SCK每次传输结束只拉低一次 */
+    CHECK(nrf_sim.delay_calls == 0);
+    if (nrf_sim.gpio_writes > 0) {
+        CHECK(nrf_sim.sck_calls == 0 && nrf_sim.mosi_calls == 0 && nrf_sim.miso_calls == 0);
+        CHECK(nrf_sim.gpio_writes == bytes * 16 + count && nrf_sim.gpio_reads == bytes * 8);
+    } else {
+        CHECK(nrf_sim.sck_calls == bytes * 16 + count && nrf_sim.mosi_calls == bytes * 8);
+    }
+#if NRF_SPI_HALF_CYCLES > 0
+    CHECK(per_byte >= 16.0 * NRF_SPI_HALF_CYCLES);
+#endif
+#endif
+    
+    printf("OK\n");
+    return 0;
+}
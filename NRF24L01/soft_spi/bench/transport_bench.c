@@ -0,0 +1,220 @@
+/**
+  ******************************************************************************
+  * @file    transport_bench.c
+  * @brief   SPI传输层主机端测试
+  * @note    对仿真器件（host/nrf24l01_sim.c）分别使用三种内置传输层：
+  *            soft    - nrf_transport_soft_spi，逐位模拟
+  *            hw      - nrf_transport_hw_spi，user_nrf_spi_exchange()
+  *            hw_dma  - nrf_transport_hw_spi_dma，短传输阻塞、长传输DMA
+  *          执行相同的初始化/配置/收发流程，检查：
+  *            - 三种传输层的SPI字节流完全一致（仿真器记录的输入/输出哈希）
+  *            - 每次缓冲区读写只有一个SPI事务，硬件SPI时只调用一次exchange
+  *            - 异步DMA传输在完成中断前返回，完成后回调并取回数据，忙时拒绝新的传输
+  *          并统计每字节的用户函数调用次数和每次32字节写入的耗时
+  *          transport_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    const NrfTransport *transport;
+} BenchTransport;
+
+static const BenchTransport g_transports[] = {
+    {"soft",   &nrf_transport_soft_spi},
+    {"hw",     &nrf_transport_hw_spi},
+    {"hw_dma", &nrf_transport_hw_spi_dma},
+};
+
+#define TRANSPORT_COUNT  (sizeof(g_transports) / sizeof(g_transports[0]))
+
+static NrfDevice g_dev;
+static uint8_t g_air[NRF_MAX_PAYLOAD];
+static uint8_t g_air_len;
+
+static uint8_t air_tx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    (void)addr;
+    memcpy(g_air, data, len);
+    g_air_len = len;
+    return 1;
+}
+
+/**
+  * @brief  初始化、配置、收发一遍，返回SPI字节流哈希
+  */
+static uint32_t run_sequence(const NrfTransport *transport)
+{
+    NrfConfig config = {0x50, 0x0E, {0x11, 0x22, 0x33, 0x44, 0x55}, {0x11, 0x22, 0x33, 0x44, 0x55}, 0};
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t i;
+    uint32_t transactions, exchanges;
+    
+    nrf_sim_reset();
+    nrf_sim.air_tx = air_tx;
+    
+    CHECK(nrf24l01_init_ex(&g_dev, transport, &config) == NRF_OK);
+    CHECK(g_dev.transport == transport);
+    
+    /* 发送：寄存器写入仿真器件，数据包从空中发出 */
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_TX);
+    CHECK(nrf_sim.reg[RF_CH] == 0x50 && nrf_sim.reg[RF_SETUP] == 0x0E && nrf_sim.reg[CONFIG] == 0x0E);
+    CHECK(memcmp(nrf_sim.tx_addr, config.tx_addr, 5) == 0);
+    CHECK(nrf24l01_read_reg_ex(&g_dev, RF_CH) == 0x50);
+    for (i = 0; i < NRF_MAX_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(i * 7 + 3);
+    }
+    CHECK(nrf24l01_send_packet_ex(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_OK);
+    CHECK(g_air_len == NRF_MAX_PAYLOAD && memcmp(g_air, payload, NRF_MAX_PAYLOAD) == 0);
+    
+    /* 每次缓冲区读写一个SPI事务，硬件SPI只调用一次exchange */
+    transactions = nrf_sim.transactions;
+    exchanges = nrf_sim.exchange_calls + nrf_sim.dma_calls;
+    nrf24l01_read_buf_ex(&g_dev, TX_ADDR, buf, 5);
+    CHECK(memcmp(buf, config.tx_addr, 5) == 0);
+    CHECK(nrf_sim.transactions == transactions + 1);
+    if (transport != &nrf_transport_soft_spi) {
+        CHECK(nrf_sim.exchange_calls + nrf_sim.dma_calls == exchanges + 1);
+    }
+    
+    /* 接收 */
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_RX);
+    CHECK(nrf24l01_receive_packet_ex(&g_dev, buf, sizeof(buf)) == 0);
+    CHECK(nrf_sim_rx_inject(0, payload, NRF_MAX_PAYLOAD));
+    CHECK(nrf24l01_receive_packet_ex(&g_dev, buf, sizeof(buf)) == NRF_MAX_PAYLOAD);
+    CHECK(memcmp(buf, payload, NRF_MAX_PAYLOAD) == 0);
+    CHECK(nrf_sim.rx_count == 0 && (nrf_sim.reg[STATUS] & RX_OK) == 0);
+    
+    /* 超长读写不传输 */
+    transactions = nrf_sim.transactions;
+    CHECK(nrf24l01_write_buf_ex(&g_dev, WR_TX_PLOAD, payload, NRF_MAX_PAYLOAD + 1) == 0xFF);
+    CHECK(nrf_sim.transactions == transactions);
+    
+    return nrf_sim.trace_hash;
+}
+
+static uint8_t g_done_count;
+static uint8_t g_done_status;
+
+static void xfer_done(NrfDevice *dev, uint8_t status)
+{
+    CHECK(dev == &g_dev);
+    g_done_count++;
+    g_done_status = status;
+}
+
+/**
+  * @brief  异步传输：DMA传输在完成中断前返回，短传输/无DMA时立即完成
+  */
+static void test_async(void)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint8_t buf[NRF_MAX_PAYLOAD];
+    uint8_t i;
+    
+    for (i = 0; i < NRF_MAX_PAYLOAD; i++) {
+        payload[i] = (uint8_t)(0xA0 ^ i);
+    }
+    
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, &nrf_transport_hw_spi_dma, NULL) == NRF_OK);
+    nrf_sim.dma_deferred = 1;
+    g_done_count = 0;
+    
+    /* 写TX FIFO：CS保持有效直到完成中断 */
+    CHECK(nrf24l01_transfer_async(&g_dev, WR_TX_PLOAD, payload, NULL, NRF_MAX_PAYLOAD, xfer_done) == NRF_OK);
+    CHECK(g_done_count == 0 && g_dev.xfer_busy && nrf_sim.cs == 0 && nrf_sim.tx_count == 0);
+    CHECK(nrf24l01_transfer_async(&g_dev, NOP, NULL, NULL, 0, xfer_done) == NRF_ERROR);
+    CHECK(nrf_sim_dma_complete());
+    CHECK(g_done_count == 1 && !g_dev.xfer_busy && nrf_sim.cs == 1 && nrf_sim.tx_count == 1);
+    CHECK(g_done_status == 0x0E);
+    CHECK(memcmp(nrf_sim.tx_fifo[0].data, payload, NRF_MAX_PAYLOAD) == 0);
+    
+    /* 读RX FIFO：完成后数据拷贝到rx */
+    CHECK(nrf_sim_rx_inject(2, payload, NRF_MAX_PAYLOAD));
+    memset(buf, 0, sizeof(buf));
+    CHECK(nrf24l01_transfer_async(&g_dev, RD_RX_PLOAD, NULL, buf, NRF_MAX_PAYLOAD, xfer_done) == NRF_OK);
+    CHECK(g_done_count == 1 && buf[0] == 0);
+    CHECK(nrf_sim_dma_complete());
+    CHECK(g_done_count == 2 && memcmp(buf, payload, NRF_MAX_PAYLOAD) == 0);
+    CHECK((g_done_status & 0x0E) == (2 << 1) && (g_done_status & RX_OK));
+    CHECK(nrf_sim.rx_count == 0);
+    
+    /* 短于NRF_DMA_MIN_LEN：阻塞完成，返回前回调 */
+    CHECK(nrf24l01_transfer_async(&g_dev, TX_ADDR, NULL, buf, 5, xfer_done) == NRF_OK);
+    CHECK(g_done_count == 3 && !g_dev.xfer_busy && nrf_sim.dma_pending == NULL);
+    CHECK(buf[0] == 0xA5 && buf[4] == 0xA5);    /* nrf24l01_check_ex()写入的测试数据 */
+    
+    /* 无DMA的传输层：阻塞完成 */
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, &nrf_transport_hw_spi, NULL) == NRF_OK);
+    CHECK(nrf24l01_transfer_async(&g_dev, WR_TX_PLOAD, payload, NULL, NRF_MAX_PAYLOAD, xfer_done) == NRF_OK);
+    CHECK(g_done_count == 4 && nrf_sim.tx_count == 1);
+    
+    /* 默认器件（兼容接口）使用软件SPI */
+    nrf_sim_reset();
+    CHECK(nrf24l01_init(NULL) == NRF_OK);
+    CHECK(nrf_sim.sck_calls > 0 && nrf_sim.exchange_calls == 0);
+    
+    printf("async: DMA write/read complete in ISR, short/non-DMA transfers complete inline\n");
+}
+
+/**
+  * @brief  每字节用户函数调用次数和32字节写入耗时
+  */
+static void bench_transport(const BenchTransport *t, uint32_t count)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint32_t i, calls, bytes;
+    uint64_t t0, t1;
+    
+    nrf_sim_reset();
+    CHECK(nrf24l01_init_ex(&g_dev, t->transport, NULL) == NRF_OK);
+    nrf_sim_reset();
+    
+    t0 = bench_now();
+    for (i = 0; i < count; i++) {
+        nrf24l01_write_buf_ex(&g_dev, NRF_WRITE_REG + TX_ADDR, payload, NRF_MAX_PAYLOAD);
+    }
+    t1 = bench_now();
+    
+    bytes = nrf_sim.spi_bytes;
+    calls = nrf_sim.sck_calls + nrf_sim.mosi_calls + nrf_sim.miso_calls + nrf_sim.exchange_calls + nrf_sim.dma_calls;
+    CHECK(bytes == count * (NRF_MAX_PAYLOAD + 1));
+    CHECK(nrf_sim.transactions == count);
+    printf("%-6s  hook calls %6.2f/byte (sck %u mosi %u miso %u exchange %u dma %u)  write_buf(32) %8.1f %s\n",
+           t->name, (double)calls / bytes,
+           nrf_sim.sck_calls / count, nrf_sim.mosi_calls / count, nrf_sim.miso_calls / count,
+           nrf_sim.exchange_calls / count, nrf_sim.dma_calls / count,
+           (double)(t1 - t0) / count, BENCH_UNIT);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t hash[TRANSPORT_COUNT];
+    uint32_t count = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 2000 : 200000;
+    size_t k;
+    
+    for (k = 0; k < TRANSPORT_COUNT; k++) {
+        hash[k] = run_sequence(g_transports[k].transport);
+        printf("%-6s  sequence OK, SPI trace hash %08x\n", g_transports[k].name, hash[k]);
+        CHECK(hash[k] == hash[0]);
+    }
+    
+    test_async();
+    
+    for (k = 0; k < TRANSPORT_COUNT; k++) {
+        bench_transport(&g_transports[k], count);
+    }
+    
+    printf("OK\n");
+    return 0;
+}
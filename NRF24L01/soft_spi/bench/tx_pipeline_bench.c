@@ -0,0 +1,296 @@
+/**
+  ******************************************************************************
+  * @file    tx_pipeline_bench.c
+  * @brief   流水线发送主机端测试
+  * @note    仿真器件按空中时间发射（含130us发射稳定和应答），对比三种发送方式的吞吐量（仿真时间，包/秒）：
+  *            blocking - nrf24l01_send_packet_ex()逐包阻塞发送（每包FLUSH_TX、清标志、等待IRQ）
+  *            async    - nrf24l01_send_async()，tx_done回调后再发送下一包
+  *            queued   - nrf24l01_send_queued()，TX FIFO保持3包，IRQ中断处理中随TX_DS补充
+  *          分别在8MHz硬件SPI（每字节1us）和约1MHz软件SPI（每字节8us）、1Mbps/2Mbps下测量，
+  *          检查queued达到空中时间上限；链路中断时按软件重发策略恢复，数据包按顺序到达且不重复；
+  *          TX_DS处理推迟到已有两包发送结束后，接着发生的MAX_RT仍对应到实际失败的数据包
+  *          tx_pipeline_bench [--quick]
+  ******************************************************************************
+  */
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_STEP_NS     1000      // 主循环每次检查IRQ引脚的间隔（1us）
+
+typedef enum {
+    MODE_BLOCKING = 0,
+    MODE_ASYNC,
+    MODE_QUEUED
+} BenchMode;
+
+static NrfDevice g_dev;
+static uint16_t g_delivered[1024];          // 接收端收到的序号
+static uint32_t g_delivered_count;
+static uint32_t g_fail_from, g_fail_to;     // 空中发射序号在此范围内时无应答
+static uint32_t g_air_count;
+static uint32_t g_done_ok, g_done_err;
+static NrfStatus g_done_result[16];         // 按顺序记录的tx_done结果
+
+static uint8_t air_tx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    (void)addr;
+    (void)len;
+    g_air_count++;
+    if (g_air_count > g_fail_from && g_air_count <= g_fail_to) {
+        return 0;
+    }
+    if (g_delivered_count < sizeof(g_delivered) / sizeof(g_delivered[0])) {
+        g_delivered[g_delivered_count++] = (uint16_t)(data[0] | (data[1] << 8));
+    }
+    return 1;
+}
+
+static void on_tx_done(NrfDevice *dev, NrfStatus result)
+{
+    (void)dev;
+    if (g_done_ok + g_done_err < sizeof(g_done_result) / sizeof(g_done_result[0])) {
+        g_done_result[g_done_ok + g_done_err] = result;
+    }
+    if (result == NRF_OK) {
+        g_done_ok++;
+    } else {
+        g_done_err++;
+    }
+}
+
+static const NrfCallbacks g_callbacks = {on_tx_done, NULL};
+
+static void setup(uint8_t speed, uint32_t spi_byte_ns)
+{
+    NrfConfig config = nrf_bench_config(speed, 0);
+    
+    nrf_bench_init(&g_dev, &nrf_transport_hw_spi, &config, air_tx);
+    nrf24l01_set_callbacks(&g_dev, &g_callbacks);
+    nrf24l01_set_mode_ex(&g_dev, NRF_MODE_TX);
+    nrf_sim.spi_byte_ns = spi_byte_ns;
+    g_delivered_count = 0;
+    g_air_count = 0;
+    g_fail_from = g_fail_to = 0;
+    g_done_ok = g_done_err = 0;
+}
+
+static void make_packet(uint8_t *payload, uint32_t seq)
+{
+    memset(payload, (int)(seq * 13), NRF_MAX_PAYLOAD);
+    payload[0] = (uint8_t)seq;
+    payload[1] = (uint8_t)(seq >> 8);
+}
+
+/**
+  * @brief  主循环推进BENCH_STEP_NS，IRQ引脚为低时调用中断处理
+  */
+static void poll_irq(void)
+{
+    nrf_sim_advance(BENCH_STEP_NS);
+    if (nrf_sim_irq() == 0) {
+        nrf24l01_irq_handler(&g_dev);
+    }
+}
+
+/**
+  * @brief  按指定方式发送count包
+  * @retval 从第一包开始发送到最后一包结束的仿真时间（ns）
+  */
+static uint64_t run(BenchMode mode, uint32_t count, uint8_t *max_fifo)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint64_t t0 = nrf_sim.now_ns;
+    uint32_t seq = 0;
+    
+    *max_fifo = 0;
+    while (seq < count || (mode != MODE_BLOCKING && nrf24l01_tx_pending(&g_dev) > 0)) {
+        if (mode == MODE_BLOCKING) {
+            make_packet(payload, seq);
+            if (nrf24l01_send_packet_ex(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_OK) {
+                g_done_ok++;
+            } else {
+                g_done_err++;
+            }
+            seq++;
+            continue;
+        }
+        
+        while (seq < count) {
+            make_packet(payload, seq);
+            if (mode == MODE_ASYNC) {
+                if (nrf24l01_send_async(&g_dev, payload, NRF_MAX_PAYLOAD) != NRF_OK) {
+                    break;
+                }
+            } else if (nrf24l01_send_queued(&g_dev, payload, NRF_MAX_PAYLOAD) != NRF_OK) {
+                break;
+            }
+            seq++;
+        }
+        if (nrf_sim.tx_count > *max_fifo) {
+            *max_fifo = nrf_sim.tx_count;
+        }
+        poll_irq();
+        CHECK(nrf_sim.now_ns - t0 < 60000000000ull);
+    }
+    
+    return nrf_sim.now_ns - t0;
+}
+
+/**
+  * @brief  每包最短的空中时间：130us发射稳定 + 帧 + 130us切换 + 应答帧
+  */
+static uint64_t airtime_ns(uint8_t speed)
+{
+    uint32_t kbps = (speed & 0x08) ? 2000 : 1000;
+    
+    return 260000 + (uint64_t)(NRF_MAX_PAYLOAD + 10 + 10) * 8 * 1000000 / kbps;
+}
+
+static void bench_throughput(uint8_t speed, uint32_t spi_byte_ns, uint32_t count)
+{
+    double pps[3];
+    uint64_t ns;
+    uint8_t max_fifo;
+    uint32_t i;
+    int mode;
+    
+    for (mode = MODE_BLOCKING; mode <= MODE_QUEUED; mode++) {
+        setup(speed, spi_byte_ns);
+        ns = run((BenchMode)mode, count, &max_fifo);
+        
+        CHECK(g_done_ok == count && g_done_err == 0 && g_dev.tx_lost == 0);
+        CHECK(g_delivered_count == count);
+        for (i = 0; i < count; i++) {
+            CHECK(g_delivered[i] == i);
+        }
+        pps[mode] = count * 1e9 / ns;
+        if (mode == MODE_QUEUED) {
+            /* TX FIFO保持3包，器件连续发射：每包时间等于空中时间（允许首包写入和末包中断处理） */
+            CHECK(max_fifo == NRF_FIFO_DEPTH);
+            CHECK(ns <= count * airtime_ns(speed) + 200 * (uint64_t)spi_byte_ns + 2 * BENCH_STEP_NS);
+        }
+    }
+    
+    printf("%dMbps SPI %4.1fMHz  blocking %6.0f pps | async %6.0f pps | queued %6.0f pps (air limit %6.0f)  x%.2f\n",
+           (speed & 0x08) ? 2 : 1, 8000.0 / spi_byte_ns, pps[MODE_BLOCKING], pps[MODE_ASYNC], pps[MODE_QUEUED],
+           1e9 / airtime_ns(speed), pps[MODE_QUEUED] / pps[MODE_BLOCKING]);
+    CHECK(pps[MODE_QUEUED] > pps[MODE_ASYNC] && pps[MODE_QUEUED] > pps[MODE_BLOCKING]);
+}
+
+/**
+  * @brief  链路中断：第2包的全部11次发射（1次 + 自动重发10次）无应答，触发MAX_RT
+  */
+static void test_recovery(uint8_t retry_limit)
+{
+    uint8_t max_fifo;
+    uint32_t count = 6;
+    uint32_t i, expect;
+    
+    setup(0x0E, 1000);
+    nrf24l01_set_tx_retry(&g_dev, retry_limit);
+    g_fail_from = 1;
+    g_fail_to = 12;
+    run(MODE_QUEUED, count, &max_fifo);
+    
+    if (retry_limit > 0) {
+        /* 软件重发：第2包仍在TX FIFO队首，清除MAX_RT后重新发射，全部按顺序到达 */
+        CHECK(g_done_ok == count && g_done_err == 0 && g_dev.tx_lost == 0);
+        CHECK(g_delivered_count == count);
+        for (i = 0; i < count; i++) {
+            CHECK(g_delivered[i] == i);
+        }
+    } else {
+        /* 丢弃：清空TX FIFO后重新写入后面的数据包，其余按顺序到达且不重复 */
+        CHECK(g_done_ok == count - 1 && g_done_err == 1 && g_dev.tx_lost == 1);
+        CHECK(g_delivered_count == count - 1);
+        for (i = 0, expect = 0; i < g_delivered_count; i++, expect++) {
+            if (expect == 1) {
+                expect++;
+            }
+            CHECK(g_delivered[i] == expect);
+        }
+    }
+    CHECK(nrf_sim.tx_count == 0 && nrf24l01_tx_pending(&g_dev) == 0);
+    printf("recovery  retry_limit %u: delivered %u/%u in order, lost %u\n",
+           retry_limit, g_delivered_count, count, g_dev.tx_lost);
+}
+
+/**
+  * @brief  中断响应延迟：第0、1包发送结束后才处理TX_DS（按结束1包计），随后第2包的全部发射无应答
+  */
+static void test_delayed_irq(void)
+{
+    uint8_t payload[NRF_MAX_PAYLOAD];
+    uint32_t count = 6, seq = 0;
+    uint32_t i, expect;
+    
+    setup(0x0E, 1000);
+    nrf24l01_set_tx_retry(&g_dev, 0);
+    g_fail_from = 2;
+    g_fail_to = 13;
+    for (; seq < NRF_FIFO_DEPTH; seq++) {
+        make_packet(payload, seq);
+        CHECK(nrf24l01_send_queued(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_OK);
+    }
+    while (nrf_sim.tx_count > 1) {
+        nrf_sim_advance(BENCH_STEP_NS);
+    }
+    CHECK(nrf_sim_irq() == 0 && g_delivered_count == 2 && !(nrf_sim.reg[STATUS] & MAX_TX));
+    nrf24l01_irq_handler(&g_dev);
+    CHECK(g_done_ok == 1);
+    
+    for (; seq < count; seq++) {
+        make_packet(payload, seq);
+        CHECK(nrf24l01_send_queued(&g_dev, payload, NRF_MAX_PAYLOAD) == NRF_OK);
+    }
+    while (nrf24l01_tx_pending(&g_dev) > 0) {
+        poll_irq();
+        CHECK(nrf_sim.now_ns < 1000000000ull);
+    }
+    
+    /* 第2包丢弃且不再发射，回调按顺序对应到每一包 */
+    CHECK(g_done_ok == count - 1 && g_done_err == 1 && g_dev.tx_lost == 1);
+    for (i = 0; i < count; i++) {
+        CHECK(g_done_result[i] == (i == 2 ? NRF_ERROR : NRF_OK));
+    }
+    CHECK(g_delivered_count == count - 1);
+    for (i = 0, expect = 0; i < g_delivered_count; i++, expect++) {
+        if (expect == 2) {
+            expect++;
+        }
+        CHECK(g_delivered[i] == expect);
+    }
+    CHECK(nrf_sim.tx_count == 0);
+    printf("delayed   TX_DS after 2 packets, then MAX_RT: tx_done results in order, lost packet %u\n", 2u);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t count = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 100 : 1000;
+    uint8_t payload[NRF_MAX_PAYLOAD] = {0};
+    uint32_t i;
+    
+    bench_throughput(0x06, 1000, count);
+    bench_throughput(0x0E, 1000, count);
+    bench_throughput(0x0E, 8000, count);
+    
+    test_recovery(1);
+    test_recovery(0);
+    test_delayed_irq();
+    
+    /* 队列满时拒绝，send_async在队列非空时拒绝 */
+    setup(0x0E, 1000);
+    for (i = 0; i < NRF_TX_QUEUE_SIZE; i++) {
+        CHECK(nrf24l01_send_queued(&g_dev, payload, 4) == NRF_OK);
+    }
+    CHECK(nrf24l01_send_queued(&g_dev, payload, 4) == NRF_ERROR);
+    CHECK(nrf24l01_send_async(&g_dev, payload, 4) == NRF_ERROR);
+    CHECK(nrf24l01_tx_pending(&g_dev) == NRF_TX_QUEUE_SIZE && nrf_sim.tx_count == NRF_FIFO_DEPTH);
+    
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file    nrf24l01_bench.h
+  * @brief   主机端测试公用的检查宏和器件初始化
+  * @note    bench/下各测试共用：CHECK失败时打印位置并以1退出，nrf_bench_init()复位仿真器件后初始化器件
+  ******************************************************************************
+  */
+
+#ifndef __NRF24L01_BENCH_H
+#define __NRF24L01_BENCH_H
+
+#include "nrf24l01_soft_spi.h"
+#include "nrf24l01_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(cond)  do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } } while (0)
+
+#define NRF_BENCH_SPI_BYTE_NS  1000     // 初始化后每个SPI字节计入的仿真时间（ns）
+
+/**
+  * @brief  测试用配置：信道0x28，收发地址均为11:22:33:44:55
+  * @param  speed    : 无线速率（RF_SETUP）
+  * @param  features : 特性（NRF_FEATURE_xxx）
+  */
+static inline NrfConfig nrf_bench_config(uint8_t speed, uint8_t features)
+{
+    NrfConfig config = {0x28, speed, {0x11, 0x22, 0x33, 0x44, 0x55}, {0x11, 0x22, 0x33, 0x44, 0x55}, features};
+
+    return config;
+}
+
+/**
+  * @brief  复位仿真器件并初始化器件
+  * @param  dev       : 器件句柄
+  * @param  transport : SPI传输层
+  * @param  config    : 配置（NULL使用驱动默认配置）
+  * @param  air_tx    : 空中发射回调（NULL时总是收到应答）
+  * @note   初始化期间SPI不计时，之后每字节计NRF_BENCH_SPI_BYTE_NS
+  */
+static inline void nrf_bench_init(NrfDevice *dev, const NrfTransport *transport, NrfConfig *config,
+                                  uint8_t (*air_tx)(const uint8_t *addr, const uint8_t *data, uint8_t len))
+{
+    nrf_sim_reset();
+    nrf_sim.air_tx = air_tx;
+    CHECK(nrf24l01_init_ex(dev, transport, config) == NRF_OK);
+    nrf_sim.spi_byte_ns = NRF_BENCH_SPI_BYTE_NS;
+}
+
+#endif /* __NRF24L01_BENCH_H */
@@ -0,0 +1,575 @@
+/**
+  ******************************************************************************
+  * @file    nrf24l01_sim.c
+  * @brief   主机端构建用的NRF24L01仿真模型
+  ******************************************************************************
+  */
+
+#include "nrf24l01_sim.h"
+#include "nrf24l01_sim_port.h"
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+NrfSim nrf_sim;
+
+static void nrf_sim_sck(uint8_t level);
+
+/* ========================= 寄存器模型 ========================= */
+static uint8_t sim_status(void)
+{
+    uint8_t status = nrf_sim.reg[STATUS] & (RX_OK | TX_OK | MAX_TX);
+    
+    status |= (nrf_sim.rx_count > 0) ? (uint8_t)(nrf_sim.rx_fifo[0].pipe << 1) : 0x0E;
+    if (nrf_sim.tx_count == NRF_SIM_FIFO_DEPTH) {
+        status |= 0x01;
+    }
+    return status;
+}
+
+static uint8_t sim_fifo_status(void)
+{
+    uint8_t fifo = 0;
+    
+    if (nrf_sim.tx_count == NRF_SIM_FIFO_DEPTH) {
+        fifo |= 0x20;
+    }
+    if (nrf_sim.tx_count == 0) {
+        fifo |= 0x10;
+    }
+    if (nrf_sim.rx_count == NRF_SIM_FIFO_DEPTH) {
+        fifo |= 0x02;
+    }
+    if (nrf_sim.rx_count == 0) {
+        fifo |= 0x01;
+    }
+    return fifo;
+}
+
+/**
+  * @brief  读寄存器reg的第idx个字节
+  */
+static uint8_t sim_reg_read(uint8_t reg, uint8_t idx)
+{
+    switch (reg) {
+    case STATUS:
+        return sim_status();
+    case NRF_FIFO_STATUS:
+        return sim_fifo_status();
+    case RX_ADDR_P0:
+    case RX_ADDR_P1:
+        return nrf_sim.rx_addr[reg - RX_ADDR_P0][idx % 5];
+    case TX_ADDR:
+        return nrf_sim.tx_addr[idx % 5];
+    default:
+        return nrf_sim.reg[reg];
+    }
+}
+
+static void sim_reg_write(uint8_t reg, uint8_t idx, uint8_t value)
+{
+    switch (reg) {
+    case STATUS:
+        nrf_sim.reg[STATUS] &= (uint8_t)~(value & (RX_OK | TX_OK | MAX_TX));
+        break;
+    case NRF_FIFO_STATUS:
+        break;
+    case RX_ADDR_P0:
+    case RX_ADDR_P1:
+        if (idx < 5) {
+            nrf_sim.rx_addr[reg - RX_ADDR_P0][idx] = value;
+        }
+        break;
+    case TX_ADDR:
+        if (idx < 5) {
+            nrf_sim.tx_addr[idx] = value;
+        }
+        break;
+    case RF_CH:
+        if (idx == 0) {
+            nrf_sim.reg[RF_CH] = value;
+            nrf_sim.reg[OBSERVE_TX] &= 0x0F;    /* 写RF_CH清零PLOS_CNT */
+        }
+        break;
+    case OBSERVE_TX:
+        break;
+    default:
+        if (idx == 0) {
+            nrf_sim.reg[reg] = value;
+        }
+        break;
+    }
+}
+
+/**
+  * @brief  当前命令第idx个数据字节对应的输出
+  */
+static uint8_t sim_data_out(uint8_t idx)
+{
+    if ((nrf_sim.cmd & 0xE0) == NRF_READ_REG) {
+        return sim_reg_read(nrf_sim.cmd & 0x1F, idx);
+    }
+    if (nrf_sim.cmd == R_RX_PL_WID) {
+        return (nrf_sim.rx_count > 0 && idx == 0) ? nrf_sim.rx_fifo[0].len : 0;
+    }
+    if (nrf_sim.cmd == RD_RX_PLOAD) {
+        return (nrf_sim.rx_count > 0 && idx < NRF_MAX_PAYLOAD) ? nrf_sim.rx_fifo[0].data[idx] : 0;
+    }
+    return 0xFF;
+}
+
+/**
+  * @brief  是否为W_ACK_PAYLOAD（低3位为通道号0~5）
+  */
+static uint8_t sim_is_ack_payload(uint8_t cmd)
+{
+    return cmd >= W_ACK_PAYLOAD && cmd <= W_ACK_PAYLOAD + 5;
+}
+
+/**
+  * @brief  是否为写TX FIFO的命令（W_TX_PAYLOAD、W_TX_PAYLOAD_NOACK、W_ACK_PAYLOAD）
+  */
+static uint8_t sim_is_payload_write(uint8_t cmd)
+{
+    return cmd == WR_TX_PLOAD || cmd == W_TX_PAYLOAD_NOACK || sim_is_ack_payload(cmd);
+}
+
+/* ========================= SPI命令解析 ========================= */
+void nrf_sim_reset(void)
+{
+    memset(&nrf_sim, 0, sizeof(nrf_sim));
+    nrf_sim.reg[CONFIG] = 0x08;
+    nrf_sim.reg[EN_AA] = 0x3F;
+    nrf_sim.reg[EN_RXADDR] = 0x03;
+    nrf_sim.reg[SETUP_AW] = 0x03;
+    nrf_sim.reg[SETUP_RETR] = 0x03;
+    nrf_sim.reg[RF_CH] = 0x02;
+    nrf_sim.reg[RF_SETUP] = 0x0F;
+    nrf_sim.reg[RX_ADDR_P2] = 0xC3;
+    nrf_sim.reg[RX_ADDR_P3] = 0xC4;
+    nrf_sim.reg[RX_ADDR_P4] = 0xC5;
+    nrf_sim.reg[RX_ADDR_P5] = 0xC6;
+    memset(nrf_sim.rx_addr[0], 0xE7, 5);
+    memset(nrf_sim.rx_addr[1], 0xC2, 5);
+    memset(nrf_sim.tx_addr, 0xE7, 5);
+    nrf_sim.cs = 1;
+    nrf_sim.trace_hash = FNV_OFFSET;
+}
+
+void nrf_sim_cs(uint8_t level)
+{
+    level = level ? 1 : 0;
+    if (level == nrf_sim.cs) {
+        return;
+    }
+    nrf_sim.cs = level;
+    
+    if (level == 0) {
+        /* 事务开始：第一个移出的字节为STATUS */
+        nrf_sim.pos = 0;
+        nrf_sim.next_out = sim_status();
+        nrf_sim.transactions++;
+        return;
+    }
+    
+    /* 事务结束：执行数据包命令 */
+    if (nrf_sim.pos == 0) {
+        return;
+    }
+    if (sim_is_payload_write(nrf_sim.cmd) && nrf_sim.pos > 1 && nrf_sim.tx_count < NRF_SIM_FIFO_DEPTH) {
+        /* W_TX_PAYLOAD_NOACK需要EN_DYN_ACK，W_ACK_PAYLOAD需要EN_ACK_PAY，否则忽略 */
+        nrf_sim.wr.no_ack = (nrf_sim.cmd == W_TX_PAYLOAD_NOACK);
+        nrf_sim.wr.pipe = sim_is_ack_payload(nrf_sim.cmd) ? (uint8_t)(nrf_sim.cmd & 0x07) : 0;
+        nrf_sim.wr.len = (uint8_t)((nrf_sim.pos - 1 > NRF_MAX_PAYLOAD) ? NRF_MAX_PAYLOAD : nrf_sim.pos - 1);
+        if ((nrf_sim.cmd != W_TX_PAYLOAD_NOACK || (nrf_sim.reg[FEATURE] & NRF_FEATURE_NO_ACK)) &&
+            (!sim_is_ack_payload(nrf_sim.cmd) || (nrf_sim.reg[FEATURE] & NRF_FEATURE_ACK_PAYLOAD))) {
+            nrf_sim.tx_fifo[nrf_sim.tx_count++] = nrf_sim.wr;
+        }
+    } else if (nrf_sim.cmd == RD_RX_PLOAD && nrf_sim.pos > 1 && nrf_sim.rx_count > 0) {
+        memmove(&nrf_sim.rx_fifo[0], &nrf_sim.rx_fifo[1], (nrf_sim.rx_count - 1) * sizeof(NrfSimPacket));
+        nrf_sim.rx_count--;
+    }
+    nrf_sim.trace_hash = (nrf_sim.trace_hash ^ 0x100) * FNV_PRIME;
+}
+
+uint8_t nrf_sim_spi_byte(uint8_t in)
+{
+    uint8_t out = nrf_sim.next_out;
+    
+    if (nrf_sim.cs) {
+        return 0xFF;    /* 未选中，MISO高阻 */
+    }
+    
+    if (nrf_sim.pos == 0) {
+        nrf_sim.cmd = in;
+        if (in == FLUSH_TX) {
+            nrf_sim.tx_count = 0;
+        } else if (in == FLUSH_RX) {
+            nrf_sim.rx_count = 0;
+        }
+    } else if ((nrf_sim.cmd & 0xE0) == NRF_WRITE_REG) {
+        sim_reg_write(nrf_sim.cmd & 0x1F, (uint8_t)(nrf_sim.pos - 1), in);
+    } else if (sim_is_payload_write(nrf_sim.cmd) && nrf_sim.pos <= NRF_MAX_PAYLOAD) {
+        nrf_sim.wr.data[nrf_sim.pos - 1] = in;
+    }
+    
+    if (nrf_sim.pos < 0xFF) {
+        nrf_sim.pos++;
+    }
+    nrf_sim.next_out = sim_data_out((uint8_t)(nrf_sim.pos - 1));
+    
+    nrf_sim.spi_bytes++;
+    nrf_sim.now_ns += nrf_sim.spi_byte_ns;
+    nrf_sim.trace_hash = (nrf_sim.trace_hash ^ in) * FNV_PRIME;
+    nrf_sim.trace_hash = (nrf_sim.trace_hash ^ out) * FNV_PRIME;
+    return out;
+}
+
+/* ========================= 无线部分 ========================= */
+/**
+  * @brief  一次发射（含应答）的空中时间
+  * @note   发射稳定130us + 前导码(1) + 地址(5) + 包控制字(2) + 数据 + CRC(2)；有应答时另加130us切换和应答包
+  *         （应答附带数据时含ack_len字节数据）
+  */
+static uint64_t sim_airtime_ns(uint8_t len, uint8_t acked, uint8_t ack_len)
+{
+    uint32_t kbps = (nrf_sim.reg[RF_SETUP] & 0x20) ? 250 : ((nrf_sim.reg[RF_SETUP] & 0x08) ? 2000 : 1000);
+    uint64_t ns = 130000 + (uint64_t)(len + 10) * 8 * 1000000 / kbps;
+    
+    if (acked) {
+        ns += 130000 + (uint64_t)(ack_len + 10) * 8 * 1000000 / kbps;
+    }
+    return ns;
+}
+
+/**
+  * @brief  开始发射TX FIFO队首的数据包：按SETUP_RETR自动重发，直到收到应答或次数用尽
+  */
+static void sim_tx_start(uint64_t start)
+{
+    NrfSimPacket *pkt = &nrf_sim.tx_fifo[0];
+    uint8_t retries = nrf_sim.reg[SETUP_RETR] & 0x0F;
+    uint64_t ard = (uint64_t)((nrf_sim.reg[SETUP_RETR] >> 4) + 1) * 250000;
+    uint64_t attempt;
+    uint8_t need_ack = (nrf_sim.reg[EN_AA] & 0x01) && !pkt->no_ack;
+    uint8_t acked = 0;
+    uint8_t n;
+    
+    nrf_sim.tx_end_ns = start;
+    nrf_sim.ack_rx.len = 0;
+    for (n = 0; n <= retries; n++) {
+        acked = 1;
+        if (nrf_sim.air_tx != NULL) {
+            acked = nrf_sim.air_tx(nrf_sim.tx_addr, pkt->data, pkt->len);
+        }
+        nrf_sim.air_packets++;
+        if (!need_ack) {
+            nrf_sim.tx_end_ns += sim_airtime_ns(pkt->len, 0, 0);
+            acked = 1;
+            break;
+        }
+        if (acked && nrf_sim.air_ack != NULL && (nrf_sim.reg[FEATURE] & NRF_FEATURE_ACK_PAYLOAD)) {
+            nrf_sim.ack_rx.len = nrf_sim.air_ack(nrf_sim.ack_rx.data);
+        }
+        attempt = sim_airtime_ns(pkt->len, 1, nrf_sim.ack_rx.len);
+        if (acked) {
+            nrf_sim.tx_end_ns += attempt;
+            break;
+        }
+        /* 无应答：等待ARD后重发 */
+        nrf_sim.tx_end_ns += (attempt > ard) ? attempt : ard;
+    }
+    
+    nrf_sim.tx_active = 1;
+    nrf_sim.tx_acked = acked;
+    nrf_sim.tx_retries = (n > retries) ? retries : n;
+}
+
+/**
+  * @brief  发射结束：成功则移出FIFO并置位TX_DS，失败则数据包留在FIFO中并置位MAX_RT
+  */
+static void sim_tx_finish(void)
+{
+    uint8_t plos = nrf_sim.reg[OBSERVE_TX] >> 4;
+    
+    nrf_sim.tx_active = 0;
+    if (nrf_sim.tx_acked) {
+        memmove(&nrf_sim.tx_fifo[0], &nrf_sim.tx_fifo[1], (nrf_sim.tx_count - 1) * sizeof(NrfSimPacket));
+        nrf_sim.tx_count--;
+        nrf_sim.reg[STATUS] |= TX_OK;
+        /* 应答附带数据与TX_DS同时进入RX FIFO（通道0） */
+        if (nrf_sim.ack_rx.len > 0) {
+            nrf_sim_rx_inject(0, nrf_sim.ack_rx.data, nrf_sim.ack_rx.len);
+            nrf_sim.ack_rx.len = 0;
+        }
+    } else {
+        nrf_sim.reg[STATUS] |= MAX_TX;
+        if (plos < 15) {
+            plos++;
+        }
+    }
+    nrf_sim.reg[OBSERVE_TX] = (uint8_t)((plos << 4) | nrf_sim.tx_retries);
+}
+
+void nrf_sim_run(void)
+{
+    uint64_t start;
+    
+    for (;;) {
+        start = nrf_sim.now_ns;
+        if (nrf_sim.tx_active) {
+            if (nrf_sim.now_ns < nrf_sim.tx_end_ns) {
+                return;
+            }
+            sim_tx_finish();
+            start = nrf_sim.tx_end_ns;
+        }
+        
+        /* 发送模式（PWR_UP=1，PRIM_RX=0，CE=1），FIFO非空且MAX_RT已清除时发射下一包 */
+        if (!nrf_sim.ce || (nrf_sim.reg[CONFIG] & 0x03) != 0x02 ||
+            nrf_sim.tx_count == 0 || (nrf_sim.reg[STATUS] & MAX_TX)) {
+            return;
+        }
+        sim_tx_start(start);
+    }
+}
+
+void nrf_sim_advance(uint64_t ns)
+{
+    nrf_sim.now_ns += ns;
+    nrf_sim_run();
+}
+
+uint8_t nrf_sim_rx_inject(uint8_t pipe, const uint8_t *data, uint8_t len)
+{
+    NrfSimPacket *pkt;
+    uint8_t i;
+    
+    if (nrf_sim.rx_count >= NRF_SIM_FIFO_DEPTH || len > NRF_MAX_PAYLOAD) {
+        return 0;
+    }
+    pkt = &nrf_sim.rx_fifo[nrf_sim.rx_count++];
+    memset(pkt, 0, sizeof(NrfSimPacket));
+    memcpy(pkt->data, data, len);
+    pkt->len = len;
+    pkt->pipe = pipe;
+    nrf_sim.reg[STATUS] |= RX_OK;
+    
+    /* 接收端：该通道的应答附带数据随应答发出 */
+    if ((nrf_sim.reg[CONFIG] & 0x01) && (nrf_sim.reg[FEATURE] & NRF_FEATURE_ACK_PAYLOAD)) {
+        for (i = 0; i < nrf_sim.tx_count; i++) {
+            if (nrf_sim.tx_fifo[i].pipe == pipe) {
+                nrf_sim.ack_tx = nrf_sim.tx_fifo[i];
+                nrf_sim.ack_tx_count++;
+                memmove(&nrf_sim.tx_fifo[i], &nrf_sim.tx_fifo[i + 1], (nrf_sim.tx_count - i - 1) * sizeof(NrfSimPacket));
+                nrf_sim.tx_count--;
+                nrf_sim.reg[STATUS] |= TX_OK;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+uint8_t nrf_sim_air_rx(const uint8_t *addr, const uint8_t *data, uint8_t len)
+{
+    uint8_t pipe, dynamic;
+    
+    /* 接收模式：PWR_UP=1，PRIM_RX=1，CE=1 */
+    if (!nrf_sim.ce || (nrf_sim.reg[CONFIG] & 0x03) != 0x03) {
+        return 0xFF;
+    }
+    
+    for (pipe = 0; pipe < 6; pipe++) {
+        if (!(nrf_sim.reg[EN_RXADDR] & (1u << pipe))) {
+            continue;
+        }
+        if (pipe < 2) {
+            if (memcmp(addr, nrf_sim.rx_addr[pipe], 5) != 0) {
+                continue;
+            }
+        } else if (addr[0] != nrf_sim.reg[RX_ADDR_P0 + pipe] || memcmp(&addr[1], &nrf_sim.rx_addr[1][1], 4) != 0) {
+            continue;
+        }
+        
+        dynamic = (nrf_sim.reg[FEATURE] & NRF_FEATURE_DYN_PAYLOAD) && (nrf_sim.reg[DYNPD] & (1u << pipe));
+        if (!dynamic && len != nrf_sim.reg[RX_PW_P0 + pipe]) {
+            return 0xFF;
+        }
+        return nrf_sim_rx_inject(pipe, data, len) ? pipe : 0xFF;
+    }
+    return 0xFF;
+}
+
+uint8_t nrf_sim_irq(void)
+{
+    /* CONFIG的bit6~4为1时屏蔽对应中断 */
+    uint8_t pending = nrf_sim.reg[STATUS] & (uint8_t)~nrf_sim.reg[CONFIG] & (RX_OK | TX_OK | MAX_TX);
+    
+    return pending ? 0 : 1;
+}
+
+uint8_t nrf_sim_dma_complete(void)
+{
+    NrfDevice *dev = nrf_sim.dma_pending;
+    
+    if (dev == NULL) {
+        return 0;
+    }
+    nrf_sim.dma_pending = NULL;
+    nrf24l01_transfer_complete_isr(dev);
+    return 1;
+}
+
+/* ========================= 模拟GPIO端口 ========================= */
+void nrf_sim_gpio_bsrr(uint32_t bsrr)
+{
+    nrf_sim.gpio_writes++;
+    if (bsrr & (NRF_SIM_PIN_MOSI | ((uint32_t)NRF_SIM_PIN_MOSI << 16))) {
+        nrf_sim.mosi = (bsrr & NRF_SIM_PIN_MOSI) ? 1 : 0;
+    }
+    if (bsrr & NRF_SIM_PIN_SCK) {
+        nrf_sim_sck(1);
+    } else if (bsrr & ((uint32_t)NRF_SIM_PIN_SCK << 16)) {
+        nrf_sim_sck(0);
+    }
+}
+
+uint32_t nrf_sim_gpio_idr(void)
+{
+    nrf_sim.gpio_reads++;
+    return ((nrf_sim.shift_out & 0x80) ? NRF_SIM_PIN_MISO : 0) |
+           (nrf_sim.sck ? NRF_SIM_PIN_SCK : 0) | (nrf_sim.mosi ? NRF_SIM_PIN_MOSI : 0);
+}
+
+uint32_t nrf_sim_cpu_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/* ========================= 用户函数（覆盖驱动中的弱定义） ========================= */
+void user_nrf_gpio_init(void)
+{
+}
+
+void user_nrf_ce_write(uint8_t level)
+{
+    nrf_sim.ce_calls++;
+    nrf_sim.ce = level ? 1 : 0;
+}
+
+void user_nrf_cs_write(uint8_t level)
+{
+    nrf_sim.cs_calls++;
+    nrf_sim_cs(level);
+    if (!level) {
+        nrf_sim.bit_cnt = 0;
+        nrf_sim.shift_out = nrf_sim.next_out;
+    }
+}
+
+/*
+ * SPI模式0：上升沿采样MOSI，下降沿移出下一位；
+ * 一个字节的第8个上升沿之后仍输出最低位，直到下一个下降沿才装入下一个字节
+ */
+static void nrf_sim_sck(uint8_t level)
+{
+    if (level == nrf_sim.sck) {
+        return;
+    }
+    nrf_sim.sck = level;
+    if (nrf_sim.cs) {
+        return;
+    }
+    
+    if (level) {
+        nrf_sim.shift_in = (uint8_t)((nrf_sim.shift_in << 1) | nrf_sim.mosi);
+        if (++nrf_sim.bit_cnt == 8) {
+            nrf_sim_spi_byte(nrf_sim.shift_in);
+        }
+    } else if (nrf_sim.bit_cnt == 8) {
+        nrf_sim.bit_cnt = 0;
+        nrf_sim.shift_out = nrf_sim.next_out;
+    } else if (nrf_sim.bit_cnt > 0) {
+        nrf_sim.shift_out <<= 1;
+    }
+}
+
+void user_nrf_sck_write(uint8_t level)
+{
+    nrf_sim.sck_calls++;
+    nrf_sim_sck(level ? 1 : 0);
+}
+
+void user_nrf_mosi_write(uint8_t level)
+{
+    nrf_sim.mosi_calls++;
+    nrf_sim.mosi = level ? 1 : 0;
+}
+
+uint8_t user_nrf_miso_read(void)
+{
+    nrf_sim.miso_calls++;
+    return (nrf_sim.shift_out >> 7) & 1;
+}
+
+void user_nrf_spi_exchange(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    uint16_t i;
+    uint8_t byte;
+    
+    (void)dev;
+    nrf_sim.exchange_calls++;
+    for (i = 0; i < len; i++) {
+        byte = nrf_sim_spi_byte((tx != NULL) ? tx[i] : 0xFF);
+        if (rx != NULL) {
+            rx[i] = byte;
+        }
+    }
+}
+
+uint8_t user_nrf_spi_exchange_dma(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    uint16_t i;
+    
+    nrf_sim.dma_calls++;
+    for (i = 0; i < len; i++) {
+        rx[i] = nrf_sim_spi_byte(tx[i]);
+    }
+    
+    if (nrf_sim.dma_deferred) {
+        nrf_sim.dma_pending = dev;
+    } else {
+        nrf24l01_transfer_complete_isr(dev);
+    }
+    return 1;
+}
+
+uint8_t user_nrf_irq_read(void)
+{
+    nrf_sim_run();
+    return nrf_sim_irq();
+}
+
+void user_delay_us(uint32_t us)
+{
+    nrf_sim.delay_calls++;
+    nrf_sim_advance((uint64_t)us * 1000);
+}
+
+void user_delay_ms(uint32_t ms)
+{
+    nrf_sim_advance((uint64_t)ms * 1000000);
+}
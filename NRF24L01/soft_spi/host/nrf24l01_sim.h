@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file    nrf24l01_sim.h
+  * @brief   主机端构建用的NRF24L01仿真模型
+  * @note    按SPI命令级模拟寄存器、地址寄存器和3级TX/RX FIFO，并覆盖驱动中的弱符号user_xxx()：
+  *            软件SPI - user_nrf_sck_write()/mosi/miso按模式0逐位移入移出
+  *            硬件SPI - user_nrf_spi_exchange()/user_nrf_spi_exchange_dma()逐字节交换
+  *            GPIO寄存器 - nrf_sim_gpio_bsrr()/nrf_sim_gpio_idr()，供软件SPI高速模式的引脚访问宏使用
+  *                         （host/nrf24l01_sim_port.h）
+  *          SPI输出的每个字节只取决于之前移入的字节，与真实器件的全双工时序一致
+  *          CE为高且处于发送模式时按空中时间依次发射TX FIFO中的数据包，由user_nrf_irq_read()、
+  *          user_delay_us()和nrf_sim_advance()推进仿真时间
+  ******************************************************************************
+  */
+
+#ifndef __NRF24L01_SIM_H
+#define __NRF24L01_SIM_H
+
+#include "nrf24l01_soft_spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NRF_SIM_FIFO_DEPTH  3
+
+/**
+  * @brief  FIFO中的一个数据包
+  */
+typedef struct {
+    uint8_t len;
+    uint8_t pipe;                               // RX FIFO：接收通道；TX FIFO：应答附带数据的通道（W_ACK_PAYLOAD）
+    uint8_t no_ack;                             // 不要求应答（W_TX_PAYLOAD_NOACK）
+    uint8_t data[NRF_MAX_PAYLOAD];
+} NrfSimPacket;
+
+/**
+  * @brief  仿真器件状态
+  */
+typedef struct {
+    uint8_t reg[0x20];                          // 单字节寄存器（STATUS/FIFO_STATUS按FIFO状态实时计算）
+    uint8_t rx_addr[2][5];                      // RX_ADDR_P0/P1
+    uint8_t tx_addr[5];                         // TX_ADDR
+    NrfSimPacket tx_fifo[NRF_SIM_FIFO_DEPTH];
+    uint8_t tx_count;
+    NrfSimPacket rx_fifo[NRF_SIM_FIFO_DEPTH];
+    uint8_t rx_count;
+    uint8_t ce;
+    uint8_t cs;
+
+    /* SPI命令解析 */
+    uint8_t cmd;                                // 当前命令字节
+    uint8_t pos;                                // 本次CS有效期内已交换的字节数
+    uint8_t next_out;                           // 下一个要移出的字节
+    NrfSimPacket wr;                            // 正在写入的TX数据包
+
+    /* 软件SPI逐位状态 */
+    uint8_t sck;
+    uint8_t mosi;
+    uint8_t bit_cnt;
+    uint8_t shift_in;
+    uint8_t shift_out;
+
+    /* 时间与发射过程 */
+    uint64_t now_ns;                            // 仿真时间，user_delay_us()/ms()、SPI字节和nrf_sim_advance()推进
+    uint32_t spi_byte_ns;                       // 每个SPI字节的时间（0-不计）
+    uint8_t tx_active;                          // 正在发射TX FIFO队首的数据包
+    uint8_t tx_acked;                           // 本次发射最终是否收到应答
+    uint8_t tx_retries;                         // 本次发射的重发次数
+    uint64_t tx_end_ns;                         // 本次发射结束时间
+    NrfSimPacket ack_rx;                        // 本次发射收到的应答附带数据（len为0表示无），发射结束时进入RX FIFO
+    NrfSimPacket ack_tx;                        // 接收端最近随应答发出的应答附带数据
+    uint32_t ack_tx_count;                      // 接收端随应答发出的应答附带数据数
+
+    /* DMA */
+    uint8_t dma_deferred;                       // 1-DMA交换后不立即完成，由nrf_sim_dma_complete()模拟完成中断
+    NrfDevice *dma_pending;                     // 等待完成的器件
+
+    /**
+      * @brief  空中发射回调，每次发射（含自动重发）调用一次（为NULL时总是收到应答）
+      * @retval 1-收到应答，0-无应答（按SETUP_RETR重发，次数用尽后MAX_RT）
+      */
+    uint8_t (*air_tx)(const uint8_t *addr, const uint8_t *data, uint8_t len);
+
+    /**
+      * @brief  应答附带数据回调，启用EN_ACK_PAY时在收到应答的发射后调用（为NULL时应答不附带数据）
+      * @param  data : 应答附带数据的存放位置（32字节）
+      * @retval 应答附带数据长度（0表示无）
+      */
+    uint8_t (*air_ack)(uint8_t *data);
+
+    /* 计数 */
+    uint32_t cs_calls;                          // user_nrf_cs_write()调用次数
+    uint32_t ce_calls;                          // user_nrf_ce_write()调用次数
+    uint32_t sck_calls;                         // user_nrf_sck_write()调用次数
+    uint32_t mosi_calls;                        // user_nrf_mosi_write()调用次数
+    uint32_t miso_calls;                        // user_nrf_miso_read()调用次数
+    uint32_t delay_calls;                       // user_delay_us()调用次数
+    uint32_t gpio_writes;                       // nrf_sim_gpio_bsrr()调用次数
+    uint32_t gpio_reads;                        // nrf_sim_gpio_idr()调用次数
+    uint32_t exchange_calls;                    // user_nrf_spi_exchange()调用次数
+    uint32_t dma_calls;                         // user_nrf_spi_exchange_dma()调用次数
+    uint32_t transactions;                      // CS有效期（SPI事务）数
+    uint32_t spi_bytes;                         // SPI交换字节数
+    uint32_t trace_hash;                        // 所有事务的输入/输出字节FNV-1a哈希
+    uint32_t air_packets;                       // 已发射的数据包数
+} NrfSim;
+
+extern NrfSim nrf_sim;
+
+/**
+  * @brief  复位仿真器件（寄存器恢复上电默认值，计数清零）
+  */
+void nrf_sim_reset(void);
+
+/**
+  * @brief  CS电平变化
+  */
+void nrf_sim_cs(uint8_t level);
+
+/**
+  * @brief  在CS有效期内交换一个字节
+  * @param  in : 主机移入的字节
+  * @retval 器件移出的字节
+  */
+uint8_t nrf_sim_spi_byte(uint8_t in);
+
+/**
+  * @brief  推进无线部分：完成已到结束时间的发射；CE为高且处于发送模式时开始发射TX FIFO中的下一包
+  * @note   每包的空中时间按RF_SETUP速率、应答和SETUP_RETR重发间隔计算
+  */
+void nrf_sim_run(void);
+
+/**
+  * @brief  仿真时间前进ns纳秒后调用nrf_sim_run()
+  */
+void nrf_sim_advance(uint64_t ns);
+
+/**
+  * @brief  向RX FIFO注入一个从空中收到的数据包并置位RX_DR
+  * @note   接收模式且启用EN_ACK_PAY时，TX FIFO中该通道的第一个应答附带数据随应答发出（移入ack_tx）并置位TX_DS
+  * @retval 1-成功，0-RX FIFO已满
+  */
+uint8_t nrf_sim_rx_inject(uint8_t pipe, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  空中收到发往addr的数据包：按EN_RXADDR和各通道地址（通道2~5为最低字节 + 通道1的高字节）匹配，
+  *         未启用动态数据长度的通道要求len等于RX_PW_Px，匹配后调用nrf_sim_rx_inject()
+  * @retval 接收的通道号，0xFF表示未接收（不在接收模式、地址不匹配、长度不符或RX FIFO已满）
+  */
+uint8_t nrf_sim_air_rx(const uint8_t *addr, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  IRQ引脚电平（低电平有效）
+  */
+uint8_t nrf_sim_irq(void);
+
+/**
+  * @brief  写模拟GPIO端口的BSRR寄存器
+  * @param  bsrr : 低16位置位、高16位复位对应引脚（NRF_SIM_PIN_xxx），同时改变MOSI和SCK时先更新MOSI
+  */
+void nrf_sim_gpio_bsrr(uint32_t bsrr);
+
+/**
+  * @brief  读模拟GPIO端口的IDR寄存器
+  */
+uint32_t nrf_sim_gpio_idr(void);
+
+/**
+  * @brief  CPU周期计数（x86主机为RDTSC，其他主机为纳秒）
+  */
+uint32_t nrf_sim_cpu_cycles(void);
+
+/**
+  * @brief  模拟DMA完成中断：对dma_pending调用nrf24l01_transfer_complete_isr()
+  * @retval 1-有待完成的传输，0-无
+  */
+uint8_t nrf_sim_dma_complete(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NRF24L01_SIM_H */
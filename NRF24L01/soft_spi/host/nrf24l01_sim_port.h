@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    nrf24l01_sim_port.h
+  * @brief   软件SPI高速模式的引脚访问宏（主机端仿真）
+  * @note    以编译选项-include强制包含，先于nrf24l01_soft_spi.h定义NRF_SCK_HIGH()等宏，
+  *          写法与STM32直接访问BSRR/IDR寄存器相同，SCK与MOSI在同一端口，NRF_SCK_LOW_MOSI()合并为一次写入
+  ******************************************************************************
+  */
+
+#ifndef __NRF24L01_SIM_PORT_H
+#define __NRF24L01_SIM_PORT_H
+
+#include <stdint.h>
+
+#define NRF_SIM_PIN_SCK   (1u << 5)
+#define NRF_SIM_PIN_MISO  (1u << 6)
+#define NRF_SIM_PIN_MOSI  (1u << 7)
+
+void nrf_sim_gpio_bsrr(uint32_t bsrr);
+uint32_t nrf_sim_gpio_idr(void);
+uint32_t nrf_sim_cpu_cycles(void);
+
+#define NRF_SCK_HIGH()         nrf_sim_gpio_bsrr(NRF_SIM_PIN_SCK)
+#define NRF_SCK_LOW()          nrf_sim_gpio_bsrr(NRF_SIM_PIN_SCK << 16)
+#define NRF_MOSI_HIGH()        nrf_sim_gpio_bsrr(NRF_SIM_PIN_MOSI)
+#define NRF_MOSI_LOW()         nrf_sim_gpio_bsrr(NRF_SIM_PIN_MOSI << 16)
+#define NRF_SCK_LOW_MOSI(bit)  nrf_sim_gpio_bsrr((NRF_SIM_PIN_SCK << 16) | ((bit) ? NRF_SIM_PIN_MOSI : (NRF_SIM_PIN_MOSI << 16)))
+#define NRF_MISO_READ()        (nrf_sim_gpio_idr() & NRF_SIM_PIN_MISO)
+#define NRF_CPU_CYCLES()       nrf_sim_cpu_cycles()
+
+#endif /* __NRF24L01_SIM_PORT_H */
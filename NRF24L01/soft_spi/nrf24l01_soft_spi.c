@@ -1,8 +1,8 @@
 /**
   ******************************************************************************
   * @file    nrf24l01_soft_spi.c
-  * @brief   NRF24L01无线模块软件SPI驱动实现
-  * @version V1.0.0
+  * @brief   NRF24L01无线模块驱动实现（软件SPI/硬件SPI/硬件SPI+DMA）
+  * @version V1.1.0
   * @date    2025-01-10
   ******************************************************************************
   */
@@ -10,15 +10,81 @@
 #include "nrf24l01_soft_spi.h"
 #include <string.h>
 
+/* ========================= 私有宏定义 ========================= */
+/**
+  * @brief  用户函数默认实现的弱符号属性
+  * @note   用户可在自己的源文件中实现user_xxx()函数覆盖默认实现，无需修改本文件
+  */
+#ifndef NRF_WEAK
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define NRF_WEAK              __attribute__((weak))
+#elif defined(__ICCARM__)
+#define NRF_WEAK              __weak
+#else
+#define NRF_WEAK
+#endif
+#endif
+
+#if NRF_SOFT_SPI_FAST
+/**
+  * @brief  软件SPI高速模式的引脚访问
+  * @note   默认调用user_nrf_xxx()；可在编译选项中定义为直接读写GPIO寄存器，例如STM32：
+  *           NRF_SCK_HIGH()        GPIOA->BSRR = GPIO_PIN_5
+  *           NRF_MISO_READ()       (GPIOA->IDR & GPIO_PIN_6)
+  *         NRF_SCK_LOW_MOSI(bit)在一次写入中拉低SCK并设置MOSI，SCK与MOSI在同一端口时可合并为一次BSRR写：
+  *           GPIOA->BSRR = (GPIO_PIN_5 << 16) | ((bit) ? GPIO_PIN_7 : (GPIO_PIN_7 << 16))
+  */
+#ifndef NRF_SCK_HIGH
+#define NRF_SCK_HIGH()                 user_nrf_sck_write(1)
+#endif
+#ifndef NRF_SCK_LOW
+#define NRF_SCK_LOW()                  user_nrf_sck_write(0)
+#endif
+#ifndef NRF_MOSI_HIGH
+#define NRF_MOSI_HIGH()                user_nrf_mosi_write(1)
+#endif
+#ifndef NRF_MOSI_LOW
+#define NRF_MOSI_LOW()                 user_nrf_mosi_write(0)
+#endif
+#ifndef NRF_SCK_LOW_MOSI
+#define NRF_SCK_LOW_MOSI(bit)          do { NRF_SCK_LOW(); if (bit) { NRF_MOSI_HIGH(); } else { NRF_MOSI_LOW(); } } while (0)
+#endif
+#ifndef NRF_MISO_READ
+#define NRF_MISO_READ()                user_nrf_miso_read()
+#endif
+
+/**
+  * @brief  SCK半周期延时
+  * @note   定义了NRF_CPU_CYCLES()（如DWT->CYCCNT）时按周期计数器等待，否则按NRF_DELAY_LOOP_CYCLES换算循环次数
+  */
+#if NRF_SPI_HALF_CYCLES == 0
+#define NRF_SPI_HALF_DELAY()
+#elif defined(NRF_CPU_CYCLES)
+#define NRF_SPI_HALF_DELAY()           do { uint32_t t0_ = NRF_CPU_CYCLES(); \
+                                            while ((uint32_t)(NRF_CPU_CYCLES() - t0_) < NRF_SPI_HALF_CYCLES) { } } while (0)
+#else
+#define NRF_SPI_DELAY_LOOPS            ((NRF_SPI_HALF_CYCLES + NRF_DELAY_LOOP_CYCLES - 1) / NRF_DELAY_LOOP_CYCLES)
+#define NRF_SPI_HALF_DELAY()           do { volatile uint32_t n_ = NRF_SPI_DELAY_LOOPS; while (n_--) { } } while (0)
+#endif
+
+/* 一位传输（模式0）：SCK低电平期间设置MOSI，上升沿后读取MISO */
+#define NRF_SPI_BIT(mask)              do { NRF_SCK_LOW_MOSI(out & (mask)); NRF_SPI_HALF_DELAY(); \
+                                            NRF_SCK_HIGH(); if (NRF_MISO_READ()) { in |= (mask); } \
+                                            NRF_SPI_HALF_DELAY(); } while (0)
+#endif
+
 /* ========================= 私有变量 ========================= */
 /* 默认地址配置 */
 static const uint8_t default_tx_addr[TX_ADR_WIDTH] = {0x20, 0x97, 0x07, 0x28, 0x00};
 static const uint8_t default_rx_addr[RX_ADR_WIDTH] = {0x20, 0x97, 0x07, 0x28, 0x00};
 
-/* 当前配置 */
-static NrfConfig g_config;
+/* 默认器件，供兼容接口及传入NULL句柄时使用 */
+static NrfDevice g_default_dev = {
+    .transport = &nrf_transport_soft_spi
+};
 
 /* ========================= 私有函数 ========================= */
+#if !NRF_SOFT_SPI_FAST
 /**
   * @brief  软件SPI读写一个字节
   * @param  data : 要发送的字节
@@ -52,39 +118,309 @@ static uint8_t spi_read_write_byte(uint8_t data)
     user_nrf_sck_write(0);
     return data;
 }
+#endif
+
+/* ========================= 内置传输层 ========================= */
+static void pin_cs_write(NrfDevice *dev, uint8_t level)
+{
+    (void)dev;
+    user_nrf_cs_write(level);
+}
+
+static void pin_ce_write(NrfDevice *dev, uint8_t level)
+{
+    (void)dev;
+    user_nrf_ce_write(level);
+}
+
+#if NRF_SOFT_SPI_FAST
+/**
+  * @brief  软件SPI高速模式读写一个字节（展开的8位传输）
+  * @param  out : 要发送的字节
+  * @retval 接收到的字节
+  * @note   结束时SCK保持高电平，由下一个字节的第一位或soft_spi_exchange()结束时拉低
+  */
+static inline uint8_t spi_fast_byte(uint8_t out)
+{
+    uint8_t in = 0;
+    
+    NRF_SPI_BIT(0x80);
+    NRF_SPI_BIT(0x40);
+    NRF_SPI_BIT(0x20);
+    NRF_SPI_BIT(0x10);
+    NRF_SPI_BIT(0x08);
+    NRF_SPI_BIT(0x04);
+    NRF_SPI_BIT(0x02);
+    NRF_SPI_BIT(0x01);
+    return in;
+}
+#endif
+
+/**
+  * @brief  软件SPI交换len字节
+  */
+static void soft_spi_exchange(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    uint16_t i;
+    uint8_t byte;
+    
+    (void)dev;
+#if NRF_SOFT_SPI_FAST
+    for (i = 0; i < len; i++) {
+        byte = spi_fast_byte((tx != NULL) ? tx[i] : 0xFF);
+        if (rx != NULL) {
+            rx[i] = byte;
+        }
+    }
+    if (len > 0) {
+        NRF_SCK_LOW();
+    }
+#else
+    for (i = 0; i < len; i++) {
+        byte = spi_read_write_byte((tx != NULL) ? tx[i] : 0xFF);
+        if (rx != NULL) {
+            rx[i] = byte;
+        }
+    }
+#endif
+}
+
+static void hw_spi_exchange(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    user_nrf_spi_exchange(dev, tx, rx, len);
+}
+
+static uint8_t hw_spi_exchange_dma(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    return user_nrf_spi_exchange_dma(dev, tx, rx, len);
+}
+
+const NrfTransport nrf_transport_soft_spi = {pin_cs_write, pin_ce_write, soft_spi_exchange, NULL};
+const NrfTransport nrf_transport_hw_spi = {pin_cs_write, pin_ce_write, hw_spi_exchange, NULL};
+const NrfTransport nrf_transport_hw_spi_dma = {pin_cs_write, pin_ce_write, hw_spi_exchange, hw_spi_exchange_dma};
+
+/**
+  * @brief  等待异步传输完成
+  * @param  dev : 器件句柄（非NULL）
+  * @retval 无
+  * @note   异步传输进行中时DMA仍在读写dev->tx_buf/rx_buf，写入tx_buf前必须先调用
+  */
+static void spi_wait(NrfDevice *dev)
+{
+    while (dev->xfer_busy) {
+    }
+}
+
+/**
+  * @brief  阻塞执行一次SPI传输（命令 + 数据）
+  * @param  dev : 器件句柄（非NULL）
+  * @param  len : 传输字节数（含命令字节），发送dev->tx_buf，接收到dev->rx_buf
+  * @retval STATUS寄存器值（接收的第一个字节）
+  * @note   调用前须已用spi_wait()等待异步传输完成再填写tx_buf；
+  *         DMA传输层上不短于NRF_DMA_MIN_LEN的传输也用DMA，CS在完成中断中释放；
+  *         nrf24l01_irq_handler()中不使用DMA，避免在中断中等待DMA完成中断
+  */
+static uint8_t spi_transfer(NrfDevice *dev, uint16_t len)
+{
+    const NrfTransport *t = dev->transport;
+    
+    spi_wait(dev);
+    t->cs_write(dev, 0);
+    if (t->exchange_start != NULL && len >= NRF_DMA_MIN_LEN && !dev->in_irq) {
+        dev->xfer_rx = NULL;
+        dev->xfer_done = NULL;
+        dev->xfer_busy = 1;
+        if (t->exchange_start(dev, dev->tx_buf, dev->rx_buf, len)) {
+            while (dev->xfer_busy) {
+            }
+            return dev->rx_buf[0];
+        }
+        dev->xfer_busy = 0;
+    }
+    t->exchange(dev, dev->tx_buf, dev->rx_buf, len);
+    t->cs_write(dev, 1);
+    
+    return dev->rx_buf[0];
+}
+
+/**
+  * @brief  设置CE引脚
+  */
+static void ce_write(NrfDevice *dev, uint8_t level)
+{
+    dev->transport->ce_write(dev, level);
+}
+
+/**
+  * @brief  读取FIFO_STATUS（一次2字节传输，同时得到STATUS）
+  * @param  dev    : 器件句柄（非NULL）
+  * @param  status : STATUS寄存器值（其bit3:1为RX FIFO队首数据包的通道号）
+  * @retval FIFO_STATUS寄存器值
+  */
+static uint8_t fifo_status_read(NrfDevice *dev, uint8_t *status)
+{
+    spi_wait(dev);
+    dev->tx_buf[0] = NRF_READ_REG + NRF_FIFO_STATUS;
+    dev->tx_buf[1] = 0xFF;
+    *status = spi_transfer(dev, 2);
+    return dev->rx_buf[1];
+}
+
+/**
+  * @brief  读出RX FIFO队首的数据包到dev->rx_buf[1]
+  * @param  dev  : 器件句柄（非NULL）
+  * @param  pipe : 数据包的通道号（取自STATUS）
+  * @retval uint8_t : 数据长度（0表示长度无效，已清空RX FIFO）
+  * @note   该通道启用动态数据长度时先用R_RX_PL_WID读取长度，只传输实际长度的数据；否则按该通道的固定宽度。
+  *         长度为0或大于32时数据包已损坏，按数据手册清空RX FIFO
+  */
+static uint8_t rx_payload_read(NrfDevice *dev, uint8_t pipe)
+{
+    uint8_t width = RX_PLOAD_WIDTH;
+    
+    spi_wait(dev);
+    if (pipe < NRF_PIPE_COUNT && (dev->dynpd & (1u << pipe))) {
+        dev->tx_buf[0] = R_RX_PL_WID;
+        dev->tx_buf[1] = 0xFF;
+        spi_transfer(dev, 2);
+        width = dev->rx_buf[1];
+    } else if (pipe < NRF_PIPE_COUNT && dev->hub.pipes != 0) {
+        width = dev->hub.width[pipe];
+    }
+    if (width == 0 || width > NRF_MAX_PAYLOAD) {
+        dev->tx_buf[0] = FLUSH_RX;
+        spi_transfer(dev, 1);
+        return 0;
+    }
+    
+    dev->tx_buf[0] = RD_RX_PLOAD;
+    memset(&dev->tx_buf[1], 0xFF, width);
+    spi_transfer(dev, (uint16_t)width + 1);
+    return width;
+}
+
+/**
+  * @brief  读出RX FIFO中的全部数据包
+  * @param  dev    : 器件句柄（非NULL）
+  * @param  status : 调用前刚读到的STATUS
+  * @param  fifo   : 与status同一次传输读到的FIFO_STATUS
+  * @param  batch  : 数据包存放位置（NULL表示交给通道处理函数或放入接收队列，队列满时丢弃并计入rx_overflow）
+  * @param  max    : batch的容量（batch为NULL时不限）
+  * @retval uint8_t : 读出的数据包数
+  * @note   每包读出后读一次FIFO_STATUS，直到RX_EMPTY再清除RX_DR，清除后再确认期间没有新数据包到达；
+  *         batch已满而RX FIFO仍有数据时不清除RX_DR（IRQ保持有效），剩余数据包下次读出
+  */
+static uint8_t rx_fifo_drain(NrfDevice *dev, uint8_t status, uint8_t fifo, NrfPacket *batch, uint8_t max)
+{
+    NrfPacket packet;
+    NrfPacket *slot;
+    NrfPipeHandler handler;
+    uint8_t width, pipe;
+    uint8_t count = 0;
+    
+    while (!(fifo & NRF_FIFO_RX_EMPTY)) {
+        do {
+            if (batch != NULL && count >= max) {
+                return count;
+            }
+            
+            /* 一次传输读出队首数据包，通道号取自读之前的STATUS */
+            pipe = NRF_STATUS_PIPE(status);
+            width = rx_payload_read(dev, pipe);
+            
+            slot = NULL;
+            handler = NULL;
+            if (width == 0) {
+                /* 损坏的数据包，RX FIFO已清空 */
+            } else if (batch != NULL) {
+                slot = &batch[count];
+            } else if (pipe < NRF_PIPE_COUNT && dev->pipe_handler[pipe] != NULL) {
+                handler = dev->pipe_handler[pipe];
+                slot = &packet;
+            } else if ((uint8_t)(dev->rx_tail - dev->rx_head) < NRF_RX_QUEUE_SIZE) {
+                slot = &dev->rx_queue[dev->rx_tail % NRF_RX_QUEUE_SIZE];
+            } else {
+                dev->rx_overflow++;
+                if (pipe < NRF_PIPE_COUNT) {
+                    dev->pipe_stats[pipe].rx_dropped++;
+                }
+            }
+            if (slot != NULL) {
+                slot->len = width;
+                slot->pipe = pipe;
+                slot->no_ack = 0;
+                memcpy(slot->data, &dev->rx_buf[1], width);
+                if (handler != NULL) {
+                    handler(dev, slot);
+                } else if (batch == NULL) {
+                    dev->rx_tail++;
+                }
+            }
+            if (width > 0) {
+                if (pipe < NRF_PIPE_COUNT) {
+                    dev->pipe_stats[pipe].rx_packets++;
+                }
+                count++;
+            }
+            
+            fifo = fifo_status_read(dev, &status);
+        } while (!(fifo & NRF_FIFO_RX_EMPTY));
+        
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, RX_OK);
+        fifo = fifo_status_read(dev, &status);
+    }
+    
+    return count;
+}
 
 /* ========================= API函数实现 ========================= */
 /**
-  * @brief  初始化NRF24L01模块
-  * @param  config : 配置参数指针（为NULL时使用默认配置）
+  * @brief  初始化NRF24L01器件
+  * @param  dev       : 器件句柄（NULL表示默认器件）
+  * @param  transport : SPI传输层（NULL表示nrf_transport_soft_spi）
+  * @param  config    : 配置参数指针（为NULL时使用默认配置）
   * @retval NrfStatus : 初始化状态
   */
-NrfStatus nrf24l01_init(NrfConfig *config)
+NrfStatus nrf24l01_init_ex(NrfDevice *dev, const NrfTransport *transport, NrfConfig *config)
 {
+    void *user_data;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
+    /* 保留用户私有数据，其余状态清零 */
+    user_data = dev->user_data;
+    memset(dev, 0, sizeof(NrfDevice));
+    dev->user_data = user_data;
+    dev->transport = (transport != NULL) ? transport : &nrf_transport_soft_spi;
+    
     /* GPIO初始化 */
     user_nrf_gpio_init();
     
     /* 设置初始电平 */
-    user_nrf_ce_write(0);
-    user_nrf_cs_write(1);
-    user_nrf_sck_write(0);
+    ce_write(dev, 0);
+    dev->transport->cs_write(dev, 1);
+    if (dev->transport == &nrf_transport_soft_spi) {
+        user_nrf_sck_write(0);
+    }
     
     /* 等待上电稳定 */
     user_delay_ms(10);
     
     /* 配置参数 */
     if (config != NULL) {
-        memcpy(&g_config, config, sizeof(NrfConfig));
+        memcpy(&dev->config, config, sizeof(NrfConfig));
     } else {
         /* 使用默认配置 */
-        g_config.channel = NRF_CHANNEL_TX;
-        g_config.speed = NRF_SPEED;
-        memcpy(g_config.tx_addr, default_tx_addr, TX_ADR_WIDTH);
-        memcpy(g_config.rx_addr, default_rx_addr, RX_ADR_WIDTH);
+        dev->config.channel = NRF_CHANNEL_TX;
+        dev->config.speed = NRF_SPEED;
+        memcpy(dev->config.tx_addr, default_tx_addr, TX_ADR_WIDTH);
+        memcpy(dev->config.rx_addr, default_rx_addr, RX_ADR_WIDTH);
     }
     
     /* 检查设备是否存在 */
-    if (nrf24l01_check() != NRF_OK) {
+    if (nrf24l01_check_ex(dev) != NRF_OK) {
         return NRF_NOT_FOUND;
     }
     
@@ -92,20 +428,20 @@ NrfStatus nrf24l01_init(NrfConfig *config)
 }
 
 /**
-  * @brief  检查NRF24L01是否存在
-  * @param  无
+  * @brief  检查器件是否存在
+  * @param  dev : 器件句柄（NULL表示默认器件）
   * @retval NrfStatus : NRF_OK-存在，NRF_NOT_FOUND-不存在
   */
-NrfStatus nrf24l01_check(void)
+NrfStatus nrf24l01_check_ex(NrfDevice *dev)
 {
     uint8_t buf[5] = {0xA5, 0xA5, 0xA5, 0xA5, 0xA5};
     uint8_t i;
     
     /* 写入测试数据 */
-    nrf24l01_write_buf(NRF_WRITE_REG + TX_ADDR, buf, 5);
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + TX_ADDR, buf, 5);
     
     /* 读回数据 */
-    nrf24l01_read_buf(TX_ADDR, buf, 5);
+    nrf24l01_read_buf_ex(dev, TX_ADDR, buf, 5);
     
     /* 验证数据 */
     for (i = 0; i < 5; i++) {
@@ -119,149 +455,363 @@ NrfStatus nrf24l01_check(void)
 
 /**
   * @brief  读取寄存器
+  * @param  dev : 器件句柄（NULL表示默认器件）
   * @param  reg : 寄存器地址
   * @retval uint8_t : 寄存器值
   */
-uint8_t nrf24l01_read_reg(uint8_t reg)
+uint8_t nrf24l01_read_reg_ex(NrfDevice *dev, uint8_t reg)
 {
-    uint8_t reg_val;
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
     
-    user_nrf_cs_write(0);
-    spi_read_write_byte(reg);
-    reg_val = spi_read_write_byte(0xFF);
-    user_nrf_cs_write(1);
+    spi_wait(dev);
+    dev->tx_buf[0] = reg;
+    dev->tx_buf[1] = 0xFF;
+    spi_transfer(dev, 2);
     
-    return reg_val;
+    return dev->rx_buf[1];
 }
 
 /**
   * @brief  写入寄存器
-  * @param  reg   : 寄存器地址
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  reg   : 命令字节
   * @param  value : 寄存器值
   * @retval uint8_t : 状态寄存器值
   */
-uint8_t nrf24l01_write_reg(uint8_t reg, uint8_t value)
+uint8_t nrf24l01_write_reg_ex(NrfDevice *dev, uint8_t reg, uint8_t value)
 {
-    uint8_t status;
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
     
-    user_nrf_cs_write(0);
-    status = spi_read_write_byte(reg);
-    spi_read_write_byte(value);
-    user_nrf_cs_write(1);
+    spi_wait(dev);
+    dev->tx_buf[0] = reg;
+    dev->tx_buf[1] = value;
     
-    return status;
+    return spi_transfer(dev, 2);
 }
 
 /**
   * @brief  读取缓冲区
-  * @param  reg  : 寄存器地址
-  * @param  buf  : 数据缓冲区
-  * @param  len  : 数据长度
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  reg : 命令字节
+  * @param  buf : 数据缓冲区
+  * @param  len : 数据长度（0~NRF_MAX_PAYLOAD）
   * @retval uint8_t : 状态寄存器值
+  * @note   命令和数据在一次CS有效期内连续传输，硬件SPI时由一次exchange完成
   */
-uint8_t nrf24l01_read_buf(uint8_t reg, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_read_buf_ex(NrfDevice *dev, uint8_t reg, uint8_t *buf, uint8_t len)
 {
-    uint8_t status, i;
-    
-    user_nrf_cs_write(0);
-    status = spi_read_write_byte(reg);
+    uint8_t status;
     
-    for (i = 0; i < len; i++) {
-        buf[i] = spi_read_write_byte(0xFF);
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (len > NRF_MAX_PAYLOAD || (buf == NULL && len > 0)) {
+        return 0xFF;
     }
     
-    user_nrf_cs_write(1);
+    spi_wait(dev);
+    dev->tx_buf[0] = reg;
+    memset(&dev->tx_buf[1], 0xFF, len);
+    status = spi_transfer(dev, (uint16_t)len + 1);
+    memcpy(buf, &dev->rx_buf[1], len);
     
     return status;
 }
 
 /**
   * @brief  写入缓冲区
-  * @param  reg  : 寄存器地址
-  * @param  buf  : 数据缓冲区
-  * @param  len  : 数据长度
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  reg : 命令字节
+  * @param  buf : 数据缓冲区
+  * @param  len : 数据长度（0~NRF_MAX_PAYLOAD）
   * @retval uint8_t : 状态寄存器值
   */
-uint8_t nrf24l01_write_buf(uint8_t reg, uint8_t *buf, uint8_t len)
+uint8_t nrf24l01_write_buf_ex(NrfDevice *dev, uint8_t reg, const uint8_t *buf, uint8_t len)
 {
-    uint8_t status, i;
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (len > NRF_MAX_PAYLOAD || (buf == NULL && len > 0)) {
+        return 0xFF;
+    }
     
-    user_nrf_cs_write(0);
-    status = spi_read_write_byte(reg);
+    spi_wait(dev);
+    dev->tx_buf[0] = reg;
+    memcpy(&dev->tx_buf[1], buf, len);
     
-    for (i = 0; i < len; i++) {
-        spi_read_write_byte(buf[i]);
+    return spi_transfer(dev, (uint16_t)len + 1);
+}
+
+/**
+  * @brief  异步缓冲区读写
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  reg  : 命令字节
+  * @param  tx   : 要写入的数据（NULL表示读取）
+  * @param  rx   : 读出数据的存放位置（NULL表示不需要）
+  * @param  len  : 数据长度（0~NRF_MAX_PAYLOAD）
+  * @param  done : 完成回调（可为NULL）
+  * @retval NrfStatus : NRF_OK-已启动（或已完成），NRF_ERROR-参数错误或上一次传输未完成
+  */
+NrfStatus nrf24l01_transfer_async(NrfDevice *dev, uint8_t reg, const uint8_t *tx, uint8_t *rx, uint8_t len,
+                                  NrfXferDoneFunc done)
+{
+    const NrfTransport *t;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (len > NRF_MAX_PAYLOAD || dev->xfer_busy) {
+        return NRF_ERROR;
     }
+    t = dev->transport;
     
-    user_nrf_cs_write(1);
+    dev->tx_buf[0] = reg;
+    if (tx != NULL) {
+        memcpy(&dev->tx_buf[1], tx, len);
+    } else {
+        memset(&dev->tx_buf[1], 0xFF, len);
+    }
     
-    return status;
+    if (t->exchange_start != NULL && len + 1 >= NRF_DMA_MIN_LEN && !dev->in_irq) {
+        dev->xfer_len = len;
+        dev->xfer_rx = rx;
+        dev->xfer_done = done;
+        dev->xfer_busy = 1;
+        t->cs_write(dev, 0);
+        if (t->exchange_start(dev, dev->tx_buf, dev->rx_buf, (uint16_t)len + 1)) {
+            return NRF_OK;
+        }
+        dev->xfer_busy = 0;
+        t->cs_write(dev, 1);
+    }
+    
+    /* 不使用DMA：阻塞完成后立即回调 */
+    spi_transfer(dev, (uint16_t)len + 1);
+    if (rx != NULL) {
+        memcpy(rx, &dev->rx_buf[1], len);
+    }
+    if (done != NULL) {
+        done(dev, dev->rx_buf[0]);
+    }
+    return NRF_OK;
+}
+
+/**
+  * @brief  DMA传输完成处理
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval 无
+  */
+void nrf24l01_transfer_complete_isr(NrfDevice *dev)
+{
+    NrfXferDoneFunc done;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (!dev->xfer_busy) {
+        return;
+    }
+    
+    dev->transport->cs_write(dev, 1);
+    if (dev->xfer_rx != NULL) {
+        memcpy(dev->xfer_rx, &dev->rx_buf[1], dev->xfer_len);
+    }
+    done = dev->xfer_done;
+    dev->xfer_busy = 0;
+    
+    /* 回调中可以立即启动下一次传输 */
+    if (done != NULL) {
+        done(dev, dev->rx_buf[0]);
+    }
+    
+    /* 传输期间到来的IRQ：SPI空闲后补处理 */
+    if (dev->irq_deferred && !dev->xfer_busy) {
+        dev->irq_deferred = 0;
+        nrf24l01_irq_handler(dev);
+    }
+}
+
+/**
+  * @brief  多通道中使用动态数据长度的通道
+  * @param  hub      : 多通道配置
+  * @param  features : 特性（NrfConfig.features）
+  * @retval uint8_t : 通道位图（bit0~bit5）：宽度为0的通道，启用动态数据长度或应答附带数据时为全部启用的通道
+  */
+static uint8_t hub_dynpd(const NrfHubConfig *hub, uint8_t features)
+{
+    uint8_t pipe;
+    uint8_t dynpd = 0;
+    
+    for (pipe = 0; pipe < NRF_PIPE_COUNT; pipe++) {
+        if (hub->width[pipe] == 0 || (features & (NRF_FEATURE_DYN_PAYLOAD | NRF_FEATURE_ACK_PAYLOAD))) {
+            dynpd |= (uint8_t)(1u << pipe);
+        }
+    }
+    return dynpd & hub->pipes;
+}
+
+/**
+  * @brief  写入FEATURE/DYNPD寄存器
+  * @param  dev : 器件句柄（非NULL）
+  * @retval 无
+  * @note   应答附带数据需要动态数据长度；nRF24L01（非+）的FEATURE写不进时先发送ACTIVATE启用
+  *         只用通道0时按特性设置通道0；多通道时宽度为0的通道（启用动态数据长度特性时为全部通道）使用动态数据长度
+  */
+static void features_write(NrfDevice *dev)
+{
+    uint8_t features = dev->config.features;
+    
+    if (features & NRF_FEATURE_ACK_PAYLOAD) {
+        features |= NRF_FEATURE_DYN_PAYLOAD;
+    }
+    
+    if (dev->hub.pipes == 0) {
+        dev->dynpd = (features & NRF_FEATURE_DYN_PAYLOAD) ? 0x01 : 0x00;
+    } else {
+        dev->dynpd = hub_dynpd(&dev->hub, features);
+        if (dev->dynpd != 0) {
+            features |= NRF_FEATURE_DYN_PAYLOAD;
+        }
+    }
+    
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + FEATURE, features);
+    if (features != 0 && nrf24l01_read_reg_ex(dev, FEATURE) != features) {
+        nrf24l01_write_reg_ex(dev, ACTIVATE, 0x73);
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + FEATURE, features);
+    }
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + DYNPD, dev->dynpd);
+}
+
+/**
+  * @brief  多通道中某个通道的地址
+  * @param  hub  : 多通道配置
+  * @param  pipe : 通道号（0~5）
+  * @param  addr : 地址存放位置（RX_ADR_WIDTH字节）
+  * @retval 无
+  */
+static void hub_pipe_addr(const NrfHubConfig *hub, uint8_t pipe, uint8_t *addr)
+{
+    if (pipe == 0) {
+        memcpy(addr, hub->p0_addr, RX_ADR_WIDTH);
+        return;
+    }
+    memcpy(addr, hub->p1_addr, RX_ADR_WIDTH);
+    if (pipe >= 2) {
+        addr[0] = hub->addr_lsb[pipe];
+    }
+}
+
+/**
+  * @brief  写入多通道的地址、自动应答、接收使能和数据宽度
+  * @param  dev : 器件句柄（非NULL，hub.pipes不为0）
+  * @retval 无
+  */
+static void hub_pipes_write(NrfDevice *dev)
+{
+    const NrfHubConfig *hub = &dev->hub;
+    uint8_t pipe;
+    
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_AA, hub->auto_ack & hub->pipes);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_RXADDR, hub->pipes);
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P0, hub->p0_addr, RX_ADR_WIDTH);
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P1, hub->p1_addr, RX_ADR_WIDTH);
+    for (pipe = 2; pipe < NRF_PIPE_COUNT; pipe++) {
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RX_ADDR_P0 + pipe, hub->addr_lsb[pipe]);
+    }
+    
+    /* 动态数据长度的通道不使用RX_PW，写入最大值 */
+    for (pipe = 0; pipe < NRF_PIPE_COUNT; pipe++) {
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RX_PW_P0 + pipe,
+                              (hub->width[pipe] != 0) ? hub->width[pipe] : NRF_MAX_PAYLOAD);
+    }
 }
 
 /**
   * @brief  设置工作模式
+  * @param  dev  : 器件句柄（NULL表示默认器件）
   * @param  mode : 工作模式（NRF_MODE_TX/NRF_MODE_RX）
   * @retval 无
   */
-void nrf24l01_set_mode(NrfMode mode)
+void nrf24l01_set_mode_ex(NrfDevice *dev, NrfMode mode)
 {
-    user_nrf_ce_write(0);
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
+    ce_write(dev, 0);
     
     if (mode == NRF_MODE_RX) {
         /* 接收模式配置 */
-        nrf24l01_write_reg(NRF_WRITE_REG + EN_AA, 0x01);              // 使能通道0自动应答
-        nrf24l01_write_reg(NRF_WRITE_REG + EN_RXADDR, 0x01);          // 使能通道0接收地址
-        nrf24l01_write_reg(NRF_WRITE_REG + SETUP_RETR, 0x1A);         // 自动重发15次
-        nrf24l01_write_reg(NRF_WRITE_REG + RX_PW_P0, RX_PLOAD_WIDTH); // 设置通道0数据宽度
-        nrf24l01_write_reg(NRF_WRITE_REG + RF_CH, g_config.channel);  // 设置RF通信频率
-        nrf24l01_write_reg(NRF_WRITE_REG + RF_SETUP, g_config.speed + 1); // 接收模式+1打开LNA
-        nrf24l01_write_reg(NRF_WRITE_REG + CONFIG, 0x0F);             // 配置接收模式参数
+        if (dev->hub.pipes != 0) {
+            hub_pipes_write(dev);                                             // 多通道地址、应答和数据宽度
+        } else {
+            nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_AA, 0x01);          // 使能通道0自动应答
+            nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_RXADDR, 0x01);      // 使能通道0接收地址
+            nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RX_PW_P0, RX_PLOAD_WIDTH); // 设置通道0数据宽度
+        }
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + SETUP_RETR, 0x1A);         // 自动重发15次
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RF_CH, dev->config.channel); // 设置RF通信频率
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RF_SETUP, dev->config.speed + 1); // 接收模式+1打开LNA
+        features_write(dev);                                                 // 动态数据长度/应答附带数据
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + CONFIG, 0x0F);             // 配置接收模式参数
         
-        nrf24l01_write_buf(NRF_WRITE_REG + RX_ADDR_P0, g_config.rx_addr, RX_ADR_WIDTH);
-        nrf24l01_write_buf(NRF_WRITE_REG + TX_ADDR, g_config.tx_addr, TX_ADR_WIDTH);
+        if (dev->hub.pipes == 0) {
+            nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P0, dev->config.rx_addr, RX_ADR_WIDTH);
+        }
+        nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + TX_ADDR, dev->config.tx_addr, TX_ADR_WIDTH);
     } else {
         /* 发送模式配置 */
-        nrf24l01_write_buf(NRF_WRITE_REG + TX_ADDR, g_config.tx_addr, TX_ADR_WIDTH);
-        nrf24l01_write_buf(NRF_WRITE_REG + RX_ADDR_P0, g_config.rx_addr, RX_ADR_WIDTH);
+        nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + TX_ADDR, dev->config.tx_addr, TX_ADR_WIDTH);
+        nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P0, dev->config.rx_addr, RX_ADR_WIDTH);
         
-        nrf24l01_write_reg(NRF_WRITE_REG + EN_AA, 0x01);              // 使能通道0自动应答
-        nrf24l01_write_reg(NRF_WRITE_REG + EN_RXADDR, 0x01);          // 使能通道0接收地址
-        nrf24l01_write_reg(NRF_WRITE_REG + SETUP_RETR, 0x1A);         // 自动重发15次
-        nrf24l01_write_reg(NRF_WRITE_REG + RF_CH, g_config.channel);  // 设置RF通信频率
-        nrf24l01_write_reg(NRF_WRITE_REG + RF_SETUP, g_config.speed); // 设置速率和功率
-        nrf24l01_write_reg(NRF_WRITE_REG + CONFIG, 0x0E);             // 配置发送模式参数
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_AA, 0x01);              // 使能通道0自动应答
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_RXADDR, 0x01);          // 使能通道0接收地址
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + SETUP_RETR, 0x1A);         // 自动重发15次
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RF_CH, dev->config.channel); // 设置RF通信频率
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + RF_SETUP, dev->config.speed); // 设置速率和功率
+        features_write(dev);                                                 // 动态数据长度/应答附带数据
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + CONFIG, 0x0E);             // 配置发送模式参数
     }
     
-    user_nrf_ce_write(1);
+    ce_write(dev, 1);
     user_delay_ms(1);
 }
 
 /**
   * @brief  发送数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
   * @param  data : 数据缓冲区
   * @param  len  : 数据长度（1-32字节）
   * @retval NrfStatus : 发送状态
   */
-NrfStatus nrf24l01_send_packet(uint8_t *data, uint8_t len)
+NrfStatus nrf24l01_send_packet_ex(NrfDevice *dev, uint8_t *data, uint8_t len)
 {
     uint8_t sta;
     uint32_t timeout = 0;
     
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
     /* 参数检查 */
     if (data == NULL || len == 0 || len > TX_PLOAD_WIDTH) {
         return NRF_ERROR;
     }
     
     /* 清空发送FIFO */
-    nrf24l01_write_reg(FLUSH_TX, 0xFF);
+    nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
     
     /* 清除所有中断标识 */
-    nrf24l01_write_reg(NRF_WRITE_REG + STATUS, 0x70);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, 0x70);
     
     /* 写入数据 */
-    user_nrf_ce_write(0);
-    nrf24l01_write_buf(WR_TX_PLOAD, data, len);
-    user_nrf_ce_write(1);
+    ce_write(dev, 0);
+    nrf24l01_write_buf_ex(dev, WR_TX_PLOAD, data, len);
+    ce_write(dev, 1);
     
     /* 等待发送完成 */
     while (user_nrf_irq_read() != 0) {
@@ -273,14 +823,14 @@ NrfStatus nrf24l01_send_packet(uint8_t *data, uint8_t len)
     }
     
     /* 读取状态 */
-    sta = nrf24l01_read_reg(STATUS);
+    sta = nrf24l01_read_reg_ex(dev, STATUS);
     
     /* 清除中断标志 */
-    nrf24l01_write_reg(NRF_WRITE_REG + STATUS, sta);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, sta);
     
     if (sta & MAX_TX) {
         /* 达到最大重发次数 */
-        nrf24l01_write_reg(FLUSH_TX, 0xFF);
+        nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
         return NRF_ERROR;
     }
     
@@ -294,101 +844,843 @@ NrfStatus nrf24l01_send_packet(uint8_t *data, uint8_t len)
 
 /**
   * @brief  接收数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
   * @param  data : 数据缓冲区
   * @param  len  : 缓冲区长度
   * @retval uint8_t : 实际接收的数据长度（0表示无数据）
   */
-uint8_t nrf24l01_receive_packet(uint8_t *data, uint8_t len)
+uint8_t nrf24l01_receive_packet_ex(NrfDevice *dev, uint8_t *data, uint8_t len)
 {
     uint8_t sta;
     uint8_t rx_len = 0;
     
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
     /* 参数检查 */
     if (data == NULL || len == 0) {
         return 0;
     }
     
-    /* 读取状态 */
-    sta = nrf24l01_read_reg(STATUS);
+    /* 读取状态：通道号不为7表示RX FIFO中有数据（不依赖RX_DR） */
+    spi_wait(dev);
+    dev->tx_buf[0] = NOP;
+    sta = spi_transfer(dev, 1);
     
-    if (sta & RX_OK) {
+    if (NRF_STATUS_PIPE(sta) <= 5) {
         /* 有数据接收 */
-        user_nrf_ce_write(0);
-        
-        /* 确定接收长度 */
-        rx_len = (len > RX_PLOAD_WIDTH) ? RX_PLOAD_WIDTH : len;
+        ce_write(dev, 0);
         
-        /* 读取数据 */
-        nrf24l01_read_buf(RD_RX_PLOAD, data, rx_len);
-        
-        /* 清除RX FIFO */
-        nrf24l01_write_reg(FLUSH_RX, 0xFF);
+        /* 读取数据（动态数据长度时按实际长度），缓冲区不足时截断 */
+        rx_len = rx_payload_read(dev, NRF_STATUS_PIPE(sta));
+        if (rx_len > 0) {
+            dev->pipe_stats[NRF_STATUS_PIPE(sta)].rx_packets++;
+        }
+        if (rx_len > len) {
+            rx_len = len;
+        }
+        memcpy(data, &dev->rx_buf[1], rx_len);
         
-        /* 清除中断标志 */
-        nrf24l01_write_reg(NRF_WRITE_REG + STATUS, sta);
+        /* RX FIFO中的其余数据包留待下次读取，全部读出后才清除RX_DR */
+        if (fifo_status_read(dev, &sta) & NRF_FIFO_RX_EMPTY) {
+            nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, RX_OK);
+        }
         
-        user_nrf_ce_write(1);
+        ce_write(dev, 1);
         
         return rx_len;
     }
     
+    /* RX_DR置位但RX FIFO为空 */
+    if (sta & RX_OK) {
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, RX_OK);
+    }
+    
     return 0;
 }
 
-/* ========================= 用户需要实现的函数 ========================= */
+/* ========================= 中断驱动收发 ========================= */
 /**
-  * @brief  设置CE引脚电平（用户必须实现）
-  * @param  level : 0-低电平，1-高电平
+  * @brief  设置中断驱动收发的回调
+  * @param  dev       : 器件句柄（NULL表示默认器件）
+  * @param  callbacks : 回调（须保持有效，NULL表示不回调）
   * @retval 无
   */
-void user_nrf_ce_write(uint8_t level)
+void nrf24l01_set_callbacks(NrfDevice *dev, const NrfCallbacks *callbacks)
 {
-    /* 此函数需要用户根据实际硬件实现 */
-    /* 示例：HAL_GPIO_WritePin(NRF_CE_GPIO_Port, NRF_CE_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    dev->callbacks = callbacks;
 }
 
 /**
-  * @brief  设置CS引脚电平（用户必须实现）
-  * @param  level : 0-低电平，1-高电平
-  * @retval 无
+  * @brief  非阻塞发送数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已写入TX FIFO，NRF_ERROR-参数错误或上一包尚未发送结束
   */
-void user_nrf_cs_write(uint8_t level)
+NrfStatus nrf24l01_send_async(NrfDevice *dev, const uint8_t *data, uint8_t len)
 {
-    /* 此函数需要用户根据实际硬件实现 */
-    /* 示例：HAL_GPIO_WritePin(NRF_CS_GPIO_Port, NRF_CS_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (dev->tx_head != dev->tx_tail) {
+        return NRF_ERROR;
+    }
+    
+    return nrf24l01_send_queued(dev, data, len);
 }
 
 /**
-  * @brief  设置SCK引脚电平（用户必须实现）
-  * @param  level : 0-低电平，1-高电平
+  * @brief  把发送队列中的一个数据包写入TX FIFO
+  * @param  dev : 器件句柄（非NULL）
+  * @param  seq : 数据包在发送队列中的计数
   * @retval 无
   */
-void user_nrf_sck_write(uint8_t level)
+static void tx_fifo_write(NrfDevice *dev, uint8_t seq)
 {
-    /* 此函数需要用户根据实际硬件实现 */
-    /* 示例：HAL_GPIO_WritePin(NRF_SCK_GPIO_Port, NRF_SCK_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+    NrfPacket *pkt = &dev->tx_queue[seq % NRF_TX_QUEUE_SIZE];
+    
+    nrf24l01_write_buf_ex(dev, pkt->no_ack ? W_TX_PAYLOAD_NOACK : WR_TX_PLOAD, pkt->data, pkt->len);
 }
 
 /**
-  * @brief  设置MOSI引脚电平（用户必须实现）
-  * @param  level : 0-低电平，1-高电平
+  * @brief  把发送队列中等待的数据包写入TX FIFO，直到TX FIFO装满
+  * @param  dev : 器件句柄（非NULL）
   * @retval 无
+  * @note   CE保持高电平，器件发射完一包后接着发射下一包
   */
-void user_nrf_mosi_write(uint8_t level)
+static void tx_fifo_fill(NrfDevice *dev)
 {
-    /* 此函数需要用户根据实际硬件实现 */
-    /* 示例：HAL_GPIO_WritePin(NRF_MOSI_GPIO_Port, NRF_MOSI_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+    while (dev->tx_loaded != dev->tx_tail && (uint8_t)(dev->tx_loaded - dev->tx_head) < NRF_FIFO_DEPTH) {
+        tx_fifo_write(dev, dev->tx_loaded);
+        dev->tx_loaded++;
+    }
+    if (dev->tx_loaded != dev->tx_head) {
+        ce_write(dev, 1);
+    }
 }
 
 /**
-  * @brief  读取MISO引脚电平（用户必须实现）
-  * @param  无
-  * @retval uint8_t : 0-低电平，1-高电平
+  * @brief  数据包加入发送队列，TX FIFO未满时立即写入
+  * @param  dev    : 器件句柄（非NULL）
+  * @param  data   : 数据缓冲区
+  * @param  len    : 数据长度（1-32字节）
+  * @param  no_ack : 本包不要求应答
+  * @retval NrfStatus : NRF_OK-已加入队列，NRF_ERROR-参数错误或队列已满
   */
-uint8_t user_nrf_miso_read(void)
+static NrfStatus tx_enqueue(NrfDevice *dev, const uint8_t *data, uint8_t len, uint8_t no_ack)
 {
-    /* 此函数需要用户根据实际硬件实现 */
-    /* 示例：return HAL_GPIO_ReadPin(NRF_MISO_GPIO_Port, NRF_MISO_Pin); */
+    NrfPacket *pkt;
+    
+    if (data == NULL || len == 0 || len > TX_PLOAD_WIDTH ||
+        (uint8_t)(dev->tx_tail - dev->tx_head) >= NRF_TX_QUEUE_SIZE) {
+        return NRF_ERROR;
+    }
+    
+    pkt = &dev->tx_queue[dev->tx_tail % NRF_TX_QUEUE_SIZE];
+    pkt->len = len;
+    pkt->pipe = 0;
+    pkt->no_ack = no_ack;
+    memcpy(pkt->data, data, len);
+    dev->tx_tail++;
+    tx_fifo_fill(dev);
+    
+    return NRF_OK;
+}
+
+/**
+  * @brief  数据包加入发送队列（流水线发送）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已加入队列，NRF_ERROR-参数错误或队列已满
+  */
+NrfStatus nrf24l01_send_queued(NrfDevice *dev, const uint8_t *data, uint8_t len)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    return tx_enqueue(dev, data, len, 0);
+}
+
+/**
+  * @brief  数据包加入发送队列，本包不要求应答
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已加入队列，NRF_ERROR-未启用NRF_FEATURE_NO_ACK、参数错误或队列已满
+  */
+NrfStatus nrf24l01_send_noack(NrfDevice *dev, const uint8_t *data, uint8_t len)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (!(dev->config.features & NRF_FEATURE_NO_ACK)) {
+        return NRF_ERROR;
+    }
+    return tx_enqueue(dev, data, len, 1);
+}
+
+/**
+  * @brief  写入应答附带数据（接收端）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 通道号（0~5）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已写入，NRF_ERROR-未启用NRF_FEATURE_ACK_PAYLOAD、通道未启用、参数错误或TX FIFO已满
+  */
+NrfStatus nrf24l01_write_ack_payload(NrfDevice *dev, uint8_t pipe, const uint8_t *data, uint8_t len)
+{
+    uint8_t status;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (!(dev->config.features & NRF_FEATURE_ACK_PAYLOAD) || pipe > 5 ||
+        data == NULL || len == 0 || len > NRF_MAX_PAYLOAD) {
+        return NRF_ERROR;
+    }
+    /* 只能写入已启用的接收通道：只用通道0时为通道0，多通道时为hub.pipes中的通道 */
+    if ((dev->hub.pipes == 0) ? (pipe != 0) : !(dev->hub.pipes & (1u << pipe))) {
+        return NRF_ERROR;
+    }
+    
+    /* 返回的STATUS是写入前的状态：TX_FULL时本次写入被忽略 */
+    status = nrf24l01_write_buf_ex(dev, W_ACK_PAYLOAD | pipe, data, len);
+    return (status & 0x01) ? NRF_ERROR : NRF_OK;
+}
+
+/**
+  * @brief  发送队列中未发送结束的数据包数
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval uint8_t : 数据包数
+  */
+uint8_t nrf24l01_tx_pending(NrfDevice *dev)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    return (uint8_t)(dev->tx_tail - dev->tx_head);
+}
+
+/**
+  * @brief  设置MAX_RT后的软件重发策略
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  limit : 每个数据包再重发的轮数（0表示直接丢弃）
+  * @retval 无
+  */
+void nrf24l01_set_tx_retry(NrfDevice *dev, uint8_t limit)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    dev->tx_retry_limit = limit;
+}
+
+/**
+  * @brief  数出MAX_RT后TX FIFO中的数据包数
+  * @param  dev    : 器件句柄（非NULL，CE已拉低，器件停止发射）
+  * @param  loaded : 按已处理的TX_DS推算仍在TX FIFO中的数据包数（2~3）
+  * @retval uint8_t : TX FIFO中的数据包数（1~loaded），最后写入的这几包仍在TX FIFO中，队首为发送失败的数据包
+  * @note   FIFO_STATUS只能区分空/满：未满时写入占位数据包直到TX_FULL，由写入次数得出包数，
+  *         再清空TX FIFO并重新写入这几包。TX_DS处理延迟时少计的已发送结束的数据包在此校正
+  */
+static uint8_t tx_fifo_count(NrfDevice *dev, uint8_t loaded)
+{
+    static const uint8_t filler = 0;
+    uint8_t count, seq;
+    
+    if (nrf24l01_read_reg_ex(dev, NRF_FIFO_STATUS) & NRF_FIFO_TX_FULL) {
+        count = NRF_FIFO_DEPTH;
+    } else {
+        /* 返回的STATUS是写入前的状态：TX_FULL时本次写入被忽略 */
+        for (count = NRF_FIFO_DEPTH; count > 1; count--) {
+            if (nrf24l01_write_buf_ex(dev, WR_TX_PLOAD, &filler, 1) & 0x01) {
+                break;
+            }
+        }
+        if (count > loaded) {
+            count = loaded;
+        }
+        nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
+        for (seq = (uint8_t)(dev->tx_loaded - count); seq != dev->tx_loaded; seq++) {
+            tx_fifo_write(dev, seq);
+        }
+    }
+    
+    return (count > loaded) ? loaded : count;
+}
+
+/**
+  * @brief  TX_DS/MAX_RT处理：结束已发射的数据包，MAX_RT时重发或丢弃队首数据包，再补充TX FIFO
+  * @param  dev    : 器件句柄（非NULL）
+  * @param  events : 本次处理的中断标志（已清除）
+  * @retval 无
+  * @note   TX_DS只是一个标志，中断响应前可能已有多包发送结束，按FIFO_STATUS推算仍在TX FIFO中的数据包数：
+  *         空为0、满为3；写入了3包而未空未满时按结束1包计（中断响应延迟小于一包的空中时间时准确，
+  *         否则少计的数据包在TX FIFO变空或下一次MAX_RT时补齐回调）。
+  *         MAX_RT时器件停止发射，由tx_fifo_count()数出TX FIFO中的包数，失败的数据包及其之前的回调都准确
+  */
+static void tx_fifo_update(NrfDevice *dev, uint8_t events)
+{
+    uint8_t loaded = (uint8_t)(dev->tx_loaded - dev->tx_head);
+    uint8_t remain, fifo, acked;
+    uint8_t lost = 0;
+    const NrfCallbacks *cb = dev->callbacks;
+    
+    if (events & MAX_TX) {
+        remain = (loaded <= 1) ? loaded : tx_fifo_count(dev, loaded);
+    } else if (loaded <= 1) {
+        remain = 0;
+    } else {
+        fifo = nrf24l01_read_reg_ex(dev, NRF_FIFO_STATUS);
+        if (fifo & NRF_FIFO_TX_EMPTY) {
+            remain = 0;
+        } else if (fifo & NRF_FIFO_TX_FULL) {
+            remain = NRF_FIFO_DEPTH;
+        } else {
+            remain = (uint8_t)(loaded - 1);
+        }
+        if (remain > loaded) {
+            remain = loaded;
+        }
+    }
+    
+    /* MAX_RT：失败的数据包在TX FIFO队首，重发或丢弃（先处理完再回调，回调中可能写入新数据包） */
+    acked = (uint8_t)(loaded - remain);
+    dev->tx_head += acked;
+    if (acked > 0) {
+        dev->tx_retry = 0;
+    }
+    if ((events & MAX_TX) && remain > 0) {
+        if (dev->tx_retry < dev->tx_retry_limit) {
+            dev->tx_retry++;
+        } else {
+            nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
+            dev->tx_head++;
+            dev->tx_loaded = dev->tx_head;
+            dev->tx_retry = 0;
+            dev->tx_lost++;
+            lost = 1;
+        }
+    }
+    
+    if (cb != NULL && cb->tx_done != NULL) {
+        while (acked-- > 0) {
+            cb->tx_done(dev, NRF_OK);
+        }
+        if (lost) {
+            cb->tx_done(dev, NRF_ERROR);
+        }
+    }
+    
+    tx_fifo_fill(dev);
+}
+
+/**
+  * @brief  IRQ处理：读取中断标志，接收数据包，更新发送队列
+  * @param  dev : 器件句柄（非NULL）
+  * @retval 无
+  */
+static void irq_process(NrfDevice *dev)
+{
+    uint8_t status, fifo, events, tail;
+    
+    /* 一次读取STATUS和FIFO_STATUS */
+    fifo = fifo_status_read(dev, &status);
+    events = status & NRF_STATUS_IRQ;
+    if (events == 0) {
+        return;
+    }
+    
+    /* RX_DR：读出RX FIFO中的全部数据包到接收队列，RX FIFO为空后清除RX_DR（RX FIFO本就为空时随下面一起清除） */
+    tail = dev->rx_tail;
+    if ((events & RX_OK) && !(fifo & NRF_FIFO_RX_EMPTY)) {
+        rx_fifo_drain(dev, status, fifo, NULL, 0);
+        events &= (uint8_t)~RX_OK;
+    }
+    
+    /* 只清除本次读到的标志；MAX_RT时先拉低CE，决定重发或丢弃后再恢复发射 */
+    if (events & MAX_TX) {
+        ce_write(dev, 0);
+    }
+    if (events != 0) {
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, events);
+    }
+    if (events & (TX_OK | MAX_TX)) {
+        tx_fifo_update(dev, events);
+    }
+    
+    /* 交给通道处理函数的数据包不回调rx_ready */
+    if (dev->rx_tail != tail && dev->callbacks != NULL && dev->callbacks->rx_ready != NULL) {
+        dev->callbacks->rx_ready(dev);
+    }
+}
+
+/**
+  * @brief  IRQ引脚中断处理
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval 无
+  * @note   处理期间的传输不使用DMA：中断中等待DMA完成中断，在两者优先级相同时会死锁
+  */
+void nrf24l01_irq_handler(NrfDevice *dev)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
+    /* 异步传输进行中：SPI总线和tx_buf正被占用，等传输完成后由nrf24l01_transfer_complete_isr()补处理 */
+    if (dev->xfer_busy) {
+        dev->irq_deferred = 1;
+        return;
+    }
+    
+    dev->in_irq = 1;
+    irq_process(dev);
+    dev->in_irq = 0;
+}
+
+/**
+  * @brief  批量接收：读出RX FIFO中的全部数据包
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  batch : 数据包存放位置
+  * @param  max   : batch的容量（数据包数）
+  * @retval uint8_t : 读出的数据包数（0表示无数据）
+  */
+uint8_t nrf24l01_receive_batch(NrfDevice *dev, NrfPacket *batch, uint8_t max)
+{
+    uint8_t status, fifo, count;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (batch == NULL || max == 0) {
+        return 0;
+    }
+    
+    fifo = fifo_status_read(dev, &status);
+    if (fifo & NRF_FIFO_RX_EMPTY) {
+        /* RX_DR置位但RX FIFO为空时清除，避免IRQ一直有效 */
+        if (status & RX_OK) {
+            nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, RX_OK);
+        }
+        return 0;
+    }
+    
+    ce_write(dev, 0);
+    count = rx_fifo_drain(dev, status, fifo, batch, max);
+    ce_write(dev, 1);
+    
+    return count;
+}
+
+/**
+  * @brief  从接收队列取出一个数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 缓冲区长度（1~NRF_MAX_PAYLOAD，数据包更长时截断）
+  * @param  pipe : 接收通道（为NULL时不需要）
+  * @retval uint8_t : 数据长度（0表示队列为空，或data为NULL/len为0，此时数据包留在队列中）
+  */
+uint8_t nrf24l01_receive_queued(NrfDevice *dev, uint8_t *data, uint8_t len, uint8_t *pipe)
+{
+    NrfPacket *slot;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (data == NULL || len == 0 || dev->rx_head == dev->rx_tail) {
+        return 0;
+    }
+    
+    slot = &dev->rx_queue[dev->rx_head % NRF_RX_QUEUE_SIZE];
+    if (len > slot->len) {
+        len = slot->len;
+    }
+    memcpy(data, slot->data, len);
+    if (pipe != NULL) {
+        *pipe = slot->pipe;
+    }
+    dev->rx_head++;
+    
+    return len;
+}
+
+/* ========================= 多通道接收 ========================= */
+/**
+  * @brief  设置多通道接收并进入接收模式
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  hub : 多通道配置（NULL表示恢复只用通道0）
+  * @retval NrfStatus : 设置状态
+  */
+NrfStatus nrf24l01_hub_config(NrfDevice *dev, const NrfHubConfig *hub)
+{
+    uint8_t pipe;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
+    if (hub == NULL) {
+        memset(&dev->hub, 0, sizeof(NrfHubConfig));
+    } else {
+        /* 参数检查 */
+        if (hub->pipes == 0 || (hub->pipes & ~0x3F) != 0) {
+            return NRF_ERROR;
+        }
+        for (pipe = 0; pipe < NRF_PIPE_COUNT; pipe++) {
+            if (hub->width[pipe] > NRF_MAX_PAYLOAD) {
+                return NRF_ERROR;
+            }
+        }
+        /* 动态数据长度的通道须自动应答（数据手册要求） */
+        if (hub_dynpd(hub, dev->config.features) & ~hub->auto_ack) {
+            return NRF_ERROR;
+        }
+        memcpy(&dev->hub, hub, sizeof(NrfHubConfig));
+    }
+    
+    nrf24l01_set_mode_ex(dev, NRF_MODE_RX);
+    return NRF_OK;
+}
+
+/**
+  * @brief  设置通道的数据包处理函数
+  * @param  dev     : 器件句柄（NULL表示默认器件）
+  * @param  pipe    : 通道号（0~5）
+  * @param  handler : 处理函数（NULL表示放入接收队列）
+  * @retval NrfStatus : 设置状态
+  */
+NrfStatus nrf24l01_set_pipe_handler(NrfDevice *dev, uint8_t pipe, NrfPipeHandler handler)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (pipe >= NRF_PIPE_COUNT) {
+        return NRF_ERROR;
+    }
+    
+    dev->pipe_handler[pipe] = handler;
+    return NRF_OK;
+}
+
+/**
+  * @brief  向某个通道的节点发送数据包（阻塞）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 节点所在的通道（0~5）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : 发送状态
+  */
+NrfStatus nrf24l01_hub_send(NrfDevice *dev, uint8_t pipe, const uint8_t *data, uint8_t len)
+{
+    uint8_t addr[RX_ADR_WIDTH];
+    NrfPipeStats *stats;
+    uint8_t sta = 0;
+    uint32_t timeout = 0;
+    
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    
+    /* 参数检查；发送队列非空时不能清空TX FIFO */
+    if (pipe >= NRF_PIPE_COUNT || !(dev->hub.pipes & (1u << pipe)) ||
+        data == NULL || len == 0 || len > NRF_MAX_PAYLOAD || nrf24l01_tx_pending(dev) != 0) {
+        return NRF_ERROR;
+    }
+    stats = &dev->pipe_stats[pipe];
+    hub_pipe_addr(&dev->hub, pipe, addr);
+    
+    /* 切换到发送模式：发往节点地址，通道0以同一地址接收应答；节点不自动应答时通道0也不等待应答 */
+    ce_write(dev, 0);
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + TX_ADDR, addr, TX_ADR_WIDTH);
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P0, addr, RX_ADR_WIDTH);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_AA,
+                          (dev->hub.auto_ack & dev->hub.pipes & ~0x01) | ((dev->hub.auto_ack >> pipe) & 0x01));
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_RXADDR, dev->hub.pipes | 0x01);
+    if (dev->dynpd & (1u << pipe)) {
+        /* 发送端的动态数据长度按通道0 */
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + DYNPD, dev->dynpd | 0x01);
+    }
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + CONFIG, 0x0E);
+    nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, TX_OK | MAX_TX);
+    nrf24l01_write_buf_ex(dev, WR_TX_PLOAD, data, len);
+    ce_write(dev, 1);
+    
+    /* 等待发送结束：RX_DR也会拉低IRQ，以STATUS的TX_DS/MAX_RT为准 */
+    while (timeout <= 100000) {
+        if (user_nrf_irq_read() == 0) {
+            spi_wait(dev);
+            dev->tx_buf[0] = NOP;
+            sta = spi_transfer(dev, 1);
+            if (sta & (TX_OK | MAX_TX)) {
+                break;
+            }
+        }
+        timeout++;
+        user_delay_us(1);
+    }
+    ce_write(dev, 0);
+    
+    if (sta & (TX_OK | MAX_TX)) {
+        stats->tx_retransmits += nrf24l01_read_reg_ex(dev, OBSERVE_TX) & 0x0F;
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + STATUS, sta & (TX_OK | MAX_TX));
+    }
+    if (!(sta & TX_OK)) {
+        nrf24l01_write_reg_ex(dev, FLUSH_TX, 0xFF);
+    }
+    
+    /* 恢复多通道接收 */
+    nrf24l01_write_buf_ex(dev, NRF_WRITE_REG + RX_ADDR_P0, dev->hub.p0_addr, RX_ADR_WIDTH);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_AA, dev->hub.auto_ack & dev->hub.pipes);
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + EN_RXADDR, dev->hub.pipes);
+    if (dev->dynpd & (1u << pipe)) {
+        nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + DYNPD, dev->dynpd);
+    }
+    nrf24l01_write_reg_ex(dev, NRF_WRITE_REG + CONFIG, 0x0F);
+    ce_write(dev, 1);
+    
+    if (sta & TX_OK) {
+        stats->tx_packets++;
+        return NRF_OK;
+    }
+    stats->tx_lost++;
+    return (sta & MAX_TX) ? NRF_ERROR : NRF_TIMEOUT;
+}
+
+/**
+  * @brief  读取通道统计
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 通道号（0~5）
+  * @retval const NrfPipeStats* : 统计
+  */
+const NrfPipeStats *nrf24l01_pipe_stats(NrfDevice *dev, uint8_t pipe)
+{
+    if (dev == NULL) {
+        dev = &g_default_dev;
+    }
+    if (pipe >= NRF_PIPE_COUNT) {
+        return NULL;
+    }
+    
+    return &dev->pipe_stats[pipe];
+}
+
+/* ========================= 兼容接口实现（默认器件） ========================= */
+/**
+  * @brief  初始化NRF24L01模块
+  * @param  config : 配置参数指针（为NULL时使用默认配置）
+  * @retval NrfStatus : 初始化状态
+  * @note   默认器件使用软件SPI；需要硬件SPI时改用nrf24l01_init_ex(NULL, &nrf_transport_hw_spi, config)，
+  *         其余兼容接口不变
+  */
+NrfStatus nrf24l01_init(NrfConfig *config)
+{
+    return nrf24l01_init_ex(&g_default_dev, NULL, config);
+}
+
+/**
+  * @brief  检查NRF24L01是否存在
+  * @param  无
+  * @retval NrfStatus : NRF_OK-存在，NRF_NOT_FOUND-不存在
+  */
+NrfStatus nrf24l01_check(void)
+{
+    return nrf24l01_check_ex(&g_default_dev);
+}
+
+/**
+  * @brief  读取寄存器
+  * @param  reg : 寄存器地址
+  * @retval uint8_t : 寄存器值
+  */
+uint8_t nrf24l01_read_reg(uint8_t reg)
+{
+    return nrf24l01_read_reg_ex(&g_default_dev, reg);
+}
+
+/**
+  * @brief  写入寄存器
+  * @param  reg   : 寄存器地址
+  * @param  value : 寄存器值
+  * @retval uint8_t : 状态寄存器值
+  */
+uint8_t nrf24l01_write_reg(uint8_t reg, uint8_t value)
+{
+    return nrf24l01_write_reg_ex(&g_default_dev, reg, value);
+}
+
+/**
+  * @brief  读取缓冲区
+  * @param  reg  : 寄存器地址
+  * @param  buf  : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval uint8_t : 状态寄存器值
+  */
+uint8_t nrf24l01_read_buf(uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    return nrf24l01_read_buf_ex(&g_default_dev, reg, buf, len);
+}
+
+/**
+  * @brief  写入缓冲区
+  * @param  reg  : 寄存器地址
+  * @param  buf  : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval uint8_t : 状态寄存器值
+  */
+uint8_t nrf24l01_write_buf(uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    return nrf24l01_write_buf_ex(&g_default_dev, reg, buf, len);
+}
+
+/**
+  * @brief  设置工作模式
+  * @param  mode : 工作模式（NRF_MODE_TX/NRF_MODE_RX）
+  * @retval 无
+  */
+void nrf24l01_set_mode(NrfMode mode)
+{
+    nrf24l01_set_mode_ex(&g_default_dev, mode);
+}
+
+/**
+  * @brief  发送数据包
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : 发送状态
+  */
+NrfStatus nrf24l01_send_packet(uint8_t *data, uint8_t len)
+{
+    return nrf24l01_send_packet_ex(&g_default_dev, data, len);
+}
+
+/**
+  * @brief  接收数据包
+  * @param  data : 数据缓冲区
+  * @param  len  : 缓冲区长度
+  * @retval uint8_t : 实际接收的数据长度（0表示无数据）
+  */
+uint8_t nrf24l01_receive_packet(uint8_t *data, uint8_t len)
+{
+    return nrf24l01_receive_packet_ex(&g_default_dev, data, len);
+}
+
+/* ========================= 用户需要实现的函数 ========================= */
+/*
+ * 以下为弱符号默认实现，用户在自己的源文件中实现同名函数即可覆盖
+ */
+
+/**
+  * @brief  GPIO初始化（用户必须实现）
+  * @param  无
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_gpio_init(void)
+{
+    /* 此函数需要用户根据实际硬件实现：配置CE/CS/SCK/MOSI为输出，MISO/IRQ为输入 */
+}
+
+/**
+  * @brief  设置CE引脚电平（用户必须实现）
+  * @param  level : 0-低电平，1-高电平
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_ce_write(uint8_t level)
+{
+    (void)level;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：HAL_GPIO_WritePin(NRF_CE_GPIO_Port, NRF_CE_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+}
+
+/**
+  * @brief  设置CS引脚电平（用户必须实现）
+  * @param  level : 0-低电平，1-高电平
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_cs_write(uint8_t level)
+{
+    (void)level;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：HAL_GPIO_WritePin(NRF_CS_GPIO_Port, NRF_CS_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+}
+
+/**
+  * @brief  设置SCK引脚电平（用户必须实现）
+  * @param  level : 0-低电平，1-高电平
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_sck_write(uint8_t level)
+{
+    (void)level;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：HAL_GPIO_WritePin(NRF_SCK_GPIO_Port, NRF_SCK_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+}
+
+/**
+  * @brief  设置MOSI引脚电平（用户必须实现）
+  * @param  level : 0-低电平，1-高电平
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_mosi_write(uint8_t level)
+{
+    (void)level;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：HAL_GPIO_WritePin(NRF_MOSI_GPIO_Port, NRF_MOSI_Pin, level ? GPIO_PIN_SET : GPIO_PIN_RESET); */
+}
+
+/**
+  * @brief  读取MISO引脚电平（用户必须实现）
+  * @param  无
+  * @retval uint8_t : 0-低电平，1-高电平
+  */
+NRF_WEAK uint8_t user_nrf_miso_read(void)
+{
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：return HAL_GPIO_ReadPin(NRF_MISO_GPIO_Port, NRF_MISO_Pin); */
+    return 0;
+}
+
+/**
+  * @brief  硬件SPI阻塞交换（使用硬件SPI传输层时实现）
+  * @param  dev : 器件句柄
+  * @param  tx  : 发送数据（NULL时发送0xFF）
+  * @param  rx  : 接收数据存放位置（NULL时丢弃）
+  * @param  len : 字节数
+  * @retval 无
+  */
+NRF_WEAK void user_nrf_spi_exchange(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    (void)dev;
+    (void)tx;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：HAL_SPI_TransmitReceive(&hspi1, (uint8_t *)tx, rx, len, 10); */
+    if (rx != NULL) {
+        memset(rx, 0, len);
+    }
+}
+
+/**
+  * @brief  启动硬件SPI DMA交换（使用nrf_transport_hw_spi_dma时实现）
+  * @param  dev : 器件句柄
+  * @param  tx  : 发送数据
+  * @param  rx  : 接收数据存放位置
+  * @param  len : 字节数
+  * @retval uint8_t : 1-已启动  0-未启动
+  */
+NRF_WEAK uint8_t user_nrf_spi_exchange_dma(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+    (void)dev;
+    (void)tx;
+    (void)rx;
+    (void)len;
+    /* 此函数需要用户根据实际硬件实现 */
+    /* 示例：return HAL_SPI_TransmitReceive_DMA(&hspi1, (uint8_t *)tx, rx, len) == HAL_OK; */
     return 0;
 }
 
@@ -397,7 +1689,7 @@ uint8_t user_nrf_miso_read(void)
   * @param  无
   * @retval uint8_t : 0-低电平，1-高电平
   */
-uint8_t user_nrf_irq_read(void)
+NRF_WEAK uint8_t user_nrf_irq_read(void)
 {
     /* 此函数需要用户根据实际硬件实现 */
     /* 示例：return HAL_GPIO_ReadPin(NRF_IRQ_GPIO_Port, NRF_IRQ_Pin); */
@@ -409,8 +1701,9 @@ uint8_t user_nrf_irq_read(void)
   * @param  us : 延时微秒数
   * @retval 无
   */
-void user_delay_us(uint32_t us)
+NRF_WEAK void user_delay_us(uint32_t us)
 {
+    (void)us;
     /* 此函数需要用户根据实际硬件实现 */
     /* 示例：
     uint32_t delay = (HAL_RCC_GetHCLKFreq() / 1000000 * us);
@@ -425,8 +1718,9 @@ void user_delay_us(uint32_t us)
   * @param  ms : 延时毫秒数
   * @retval 无
   */
-void user_delay_ms(uint32_t ms)
+NRF_WEAK void user_delay_ms(uint32_t ms)
 {
+    (void)ms;
     /* 此函数需要用户根据实际硬件实现 */
     /* 示例：HAL_Delay(ms); */
 }
\ No newline at end of file
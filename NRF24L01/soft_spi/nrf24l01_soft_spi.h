@@ -1,8 +1,8 @@
 /**
   ******************************************************************************
   * @file    nrf24l01_soft_spi.h
-  * @brief   NRF24L01无线模块软件SPI驱动头文件
-  * @version V1.0.0
+  * @brief   NRF24L01无线模块驱动头文件（软件SPI/硬件SPI/硬件SPI+DMA）
+  * @version V1.1.0
   * @date    2025-01-10
   ******************************************************************************
   */
@@ -31,6 +31,36 @@ extern "C" {
 #define NRF_CHANNEL_TX  0x14  // 发送信道（0-127）
 #define NRF_SPEED      0x06   // 无线速率：0x06-1Mbps，0x0E-2Mbps
 
+#ifndef NRF_DMA_MIN_LEN
+#define NRF_DMA_MIN_LEN 8     // 使用DMA传输的最小SPI字节数（含命令字节），更短的传输直接阻塞完成
+#endif
+
+/**
+  * @brief  软件SPI高速模式
+  * @note   启用后软件SPI使用引脚访问宏（默认仍调用user_nrf_xxx()，可在编译选项中定义为直接读写
+  *         GPIO寄存器，见README）、展开的8位传输循环，SCK半周期按CPU周期数延时而不调用user_delay_us()
+  *         NRF24L01的SPI最高10MHz（半周期50ns），72MHz主频下直接访问寄存器时NRF_SPI_HALF_CYCLES=0即可
+  */
+#ifndef NRF_SOFT_SPI_FAST
+#define NRF_SOFT_SPI_FAST     0   // 是否启用软件SPI高速模式
+#endif
+
+#ifndef NRF_SPI_HALF_CYCLES
+#define NRF_SPI_HALF_CYCLES   0   // 高速模式SCK半周期的最少CPU周期数，0-不延时（速度由引脚访问决定）
+#endif
+
+#ifndef NRF_DELAY_LOOP_CYCLES
+#define NRF_DELAY_LOOP_CYCLES 4   // 未定义NRF_CPU_CYCLES()时，延时循环每次迭代的CPU周期数（按实测校准）
+#endif
+
+#ifndef NRF_RX_QUEUE_SIZE
+#define NRF_RX_QUEUE_SIZE     4   // 中断驱动接收队列的数据包数（须为2的幂，不超过128）
+#endif
+
+#ifndef NRF_TX_QUEUE_SIZE
+#define NRF_TX_QUEUE_SIZE     8   // 中断驱动发送队列的数据包数（含已写入TX FIFO的，须为2的幂，不超过128）
+#endif
+
 /* ========================= 寄存器定义 ========================= */
 /* NRF24L01指令 */
 #define NRF_READ_REG    0x00  // 读配置寄存器，低5位为寄存器地址
@@ -40,6 +70,10 @@ extern "C" {
 #define FLUSH_TX        0xE1  // 清除TX FIFO寄存器
 #define FLUSH_RX        0xE2  // 清除RX FIFO寄存器
 #define REUSE_TX_PL     0xE3  // 重新使用上一包数据
+#define R_RX_PL_WID     0x60  // 读RX FIFO队首数据包的长度（动态数据长度）
+#define W_ACK_PAYLOAD   0xA8  // 写应答附带数据，低3位为通道号（接收端）
+#define W_TX_PAYLOAD_NOACK 0xB0 // 写TX有效数据，本包不要求应答
+#define ACTIVATE        0x50  // 后跟0x73：nRF24L01（非+）启用FEATURE/DYNPD等寄存器
 #define NOP             0xFF  // 空操作，可以用来读状态寄存器
 
 /* NRF24L01寄存器地址 */
@@ -67,12 +101,38 @@ extern "C" {
 #define RX_PW_P4        0x15  // 接收数据通道4有效数据宽度
 #define RX_PW_P5        0x16  // 接收数据通道5有效数据宽度
 #define NRF_FIFO_STATUS 0x17  // FIFO状态寄存器
+#define DYNPD           0x1C  // 各通道动态数据长度使能
+#define FEATURE         0x1D  // 特性寄存器
+
+/* FEATURE寄存器位定义 */
+#define NRF_FEATURE_DYN_PAYLOAD 0x04 // EN_DPL：动态数据长度，数据包按实际长度发射
+#define NRF_FEATURE_ACK_PAYLOAD 0x02 // EN_ACK_PAY：应答附带数据（需要动态数据长度，自动启用）
+#define NRF_FEATURE_NO_ACK      0x01 // EN_DYN_ACK：允许单个数据包不要求应答
 
 /* 状态寄存器位定义 */
 #define MAX_TX          0x10  // 达到最大发送次数中断
 #define TX_OK           0x20  // TX发送完成中断
 #define RX_OK           0x40  // 接收到数据中断
 
+#define NRF_MAX_PAYLOAD 32    // 单次缓冲区读写的最大数据长度（字节）
+#define NRF_XFER_SIZE   (1 + NRF_MAX_PAYLOAD) // 单次SPI传输最大字节数：命令(1) + 数据
+
+#define NRF_STATUS_IRQ  (RX_OK | TX_OK | MAX_TX) // 状态寄存器的三个中断标志
+#define NRF_STATUS_PIPE(status) (((status) >> 1) & 0x07) // 状态寄存器中RX FIFO队首数据包的通道号（7表示为空）
+#define NRF_FIFO_RX_EMPTY 0x01 // FIFO_STATUS：RX FIFO为空
+#define NRF_FIFO_TX_EMPTY 0x10 // FIFO_STATUS：TX FIFO为空
+#define NRF_FIFO_TX_FULL  0x20 // FIFO_STATUS：TX FIFO已满
+#define NRF_FIFO_DEPTH    3    // TX/RX FIFO深度（数据包数）
+#define NRF_PIPE_COUNT    6    // 接收通道数（通道0~5）
+
+#if NRF_RX_QUEUE_SIZE == 0 || (NRF_RX_QUEUE_SIZE & (NRF_RX_QUEUE_SIZE - 1)) != 0 || NRF_RX_QUEUE_SIZE > 128
+#error "NRF_RX_QUEUE_SIZE必须为2的幂且不超过128"
+#endif
+
+#if NRF_TX_QUEUE_SIZE < NRF_FIFO_DEPTH || (NRF_TX_QUEUE_SIZE & (NRF_TX_QUEUE_SIZE - 1)) != 0 || NRF_TX_QUEUE_SIZE > 128
+#error "NRF_TX_QUEUE_SIZE必须为2的幂，不小于4且不超过128"
+#endif
+
 /* ========================= 数据类型定义 ========================= */
 /**
   * @brief  NRF24L01通信状态枚举
@@ -100,9 +160,384 @@ typedef struct {
     uint8_t speed;        // 通信速率（0x06:1Mbps, 0x0E:2Mbps）
     uint8_t tx_addr[TX_ADR_WIDTH];  // 发送地址
     uint8_t rx_addr[RX_ADR_WIDTH];  // 接收地址
+    uint8_t features;     // 特性（NRF_FEATURE_xxx组合，0表示固定数据宽度RX_PLOAD_WIDTH）
 } NrfConfig;
 
+typedef struct NrfDevice NrfDevice;
+
+/**
+  * @brief  SPI传输层
+  * @note   每个器件选择一个传输层，内置nrf_transport_soft_spi/nrf_transport_hw_spi/nrf_transport_hw_spi_dma，
+  *         也可按此结构自行实现（如两片NRF24L01接在不同SPI上，通过dev->user_data区分）
+  *         cs_write       : 设置CS引脚电平
+  *         ce_write       : 设置CE引脚电平（不属于SPI，但与CS一样按器件区分）
+  *         exchange       : 阻塞全双工交换len字节，tx为NULL时发送0xFF，rx为NULL时丢弃接收数据
+  *         exchange_start : 可选，启动DMA交换后立即返回1，完成中断中调用nrf24l01_transfer_complete_isr()；
+  *                          返回0或为NULL时改用exchange
+  */
+typedef struct {
+    void (*cs_write)(NrfDevice *dev, uint8_t level);
+    void (*ce_write)(NrfDevice *dev, uint8_t level);
+    void (*exchange)(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len);
+    uint8_t (*exchange_start)(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len);
+} NrfTransport;
+
+/**
+  * @brief  异步传输完成回调
+  * @param  dev    : 器件句柄
+  * @param  status : 传输第一个字节返回的STATUS寄存器值
+  * @note   使用DMA时在DMA完成中断中调用
+  */
+typedef void (*NrfXferDoneFunc)(NrfDevice *dev, uint8_t status);
+
+/**
+  * @brief  接收到的（或等待发送的）数据包
+  */
+typedef struct {
+    uint8_t len;                         // 数据长度
+    uint8_t pipe;                        // 接收通道（0~5，发送队列中未使用）
+    uint8_t no_ack;                      // 发送队列：本包不要求应答（接收时为0）
+    uint8_t data[NRF_MAX_PAYLOAD];       // 数据
+} NrfPacket;
+
+/**
+  * @brief  中断驱动收发的回调，在nrf24l01_irq_handler()中（通常为中断上下文）调用
+  * @note   tx_done  : 发送队列中最早的数据包发送结束（每包一次），result为NRF_OK（TX_DS，已收到应答）
+  *                    或NRF_ERROR（MAX_RT且软件重发次数用尽，数据包已丢弃）；回调中可以发送下一包
+  *         rx_ready : 有新的数据包进入接收队列，用nrf24l01_receive_queued()取出
+  */
+typedef struct {
+    void (*tx_done)(NrfDevice *dev, NrfStatus result);
+    void (*rx_ready)(NrfDevice *dev);
+} NrfCallbacks;
+
+/**
+  * @brief  多通道接收（星形网络中心节点）配置
+  * @note   一片NRF24L01同时接收最多6个节点：通道0、1为完整地址，通道2~5只设置地址最低字节，
+  *         其余字节与通道1相同（地址按SPI写入顺序，第0字节为最低字节）
+  */
+typedef struct {
+    uint8_t pipes;                       // 启用的通道（bit0~bit5对应通道0~5）
+    uint8_t auto_ack;                    // 自动应答的通道（bit0~bit5，一般与pipes相同；动态数据长度的通道须自动应答）
+    uint8_t p0_addr[RX_ADR_WIDTH];       // 通道0地址
+    uint8_t p1_addr[RX_ADR_WIDTH];       // 通道1地址（通道2~5共用其高字节）
+    uint8_t addr_lsb[NRF_PIPE_COUNT];    // 通道2~5的地址最低字节（下标为通道号，0、1不使用）
+    uint8_t width[NRF_PIPE_COUNT];       // 各通道固定数据宽度（1~32），0表示动态数据长度
+} NrfHubConfig;
+
+/**
+  * @brief  每个通道（节点）的统计
+  */
+typedef struct {
+    uint32_t rx_packets;                 // 收到的数据包数
+    uint32_t rx_dropped;                 // 接收队列已满而丢弃的数据包数
+    uint32_t tx_packets;                 // nrf24l01_hub_send()发送成功的数据包数
+    uint32_t tx_retransmits;             // nrf24l01_hub_send()的自动重发次数（OBSERVE_TX的ARC累计）
+    uint32_t tx_lost;                    // nrf24l01_hub_send()达到最大重发次数（或超时）而失败的数据包数
+} NrfPipeStats;
+
+/**
+  * @brief  通道数据包处理函数，在nrf24l01_irq_handler()中（通常为中断上下文）调用
+  * @note   设置了处理函数的通道，数据包不进入接收队列；packet仅在调用期间有效
+  */
+typedef void (*NrfPipeHandler)(NrfDevice *dev, const NrfPacket *packet);
+
+/**
+  * @brief  NRF24L01器件结构体
+  * @note   由用户静态分配，每片NRF24L01一个；成员仅供驱动内部使用，用户只需读取user_data
+  */
+struct NrfDevice {
+    const NrfTransport *transport;       // SPI传输层
+    void *user_data;                     // 用户私有数据（如SPI句柄），在自定义传输层中使用
+    NrfConfig config;                    // 当前配置
+    uint8_t tx_buf[NRF_XFER_SIZE];       // SPI发送缓冲区：命令 + 数据，整包一次传输
+    uint8_t rx_buf[NRF_XFER_SIZE];       // SPI接收缓冲区：STATUS + 数据
+    volatile uint8_t xfer_busy;          // 是否有DMA传输进行中
+    uint8_t xfer_len;                    // 进行中传输的数据长度（不含命令字节）
+    uint8_t *xfer_rx;                    // 进行中传输的数据接收位置（NULL表示不需要）
+    NrfXferDoneFunc xfer_done;           // 进行中传输的完成回调
+    uint8_t in_irq;                      // nrf24l01_irq_handler()执行中（期间的传输不使用DMA）
+    volatile uint8_t irq_deferred;       // 异步传输进行中时到来的IRQ，传输完成后补处理
+
+    /* 中断驱动收发 */
+    const NrfCallbacks *callbacks;       // 回调（为NULL时不回调）
+    NrfPacket tx_queue[NRF_TX_QUEUE_SIZE]; // 发送环形队列：[tx_head, tx_loaded)已写入TX FIFO，[tx_loaded, tx_tail)等待写入
+    volatile uint8_t tx_head;            // 最早未发送结束的数据包计数
+    volatile uint8_t tx_loaded;          // 下一个要写入TX FIFO的数据包计数
+    volatile uint8_t tx_tail;            // 队尾计数
+    uint8_t tx_retry_limit;              // MAX_RT后软件重发的次数（0表示直接丢弃）
+    uint8_t tx_retry;                    // 队首数据包已软件重发的次数
+    volatile uint32_t tx_lost;           // 重发用尽而丢弃的数据包数
+    NrfPacket rx_queue[NRF_RX_QUEUE_SIZE]; // 接收数据包环形队列
+    volatile uint8_t rx_head;            // 队首计数（仅nrf24l01_receive_queued()修改）
+    volatile uint8_t rx_tail;            // 队尾计数（仅nrf24l01_irq_handler()修改）
+    volatile uint32_t rx_overflow;       // 队列已满而丢弃的数据包数
+
+    /* 多通道接收 */
+    NrfHubConfig hub;                    // 多通道配置（hub.pipes为0表示只用通道0）
+    uint8_t dynpd;                       // 已写入DYNPD的动态数据长度通道
+    NrfPipeHandler pipe_handler[NRF_PIPE_COUNT]; // 各通道的数据包处理函数（NULL表示放入接收队列）
+    NrfPipeStats pipe_stats[NRF_PIPE_COUNT]; // 各通道统计
+};
+
+/* 内置传输层 */
+extern const NrfTransport nrf_transport_soft_spi;    // 软件SPI：user_nrf_sck_write()/mosi/miso逐位模拟
+extern const NrfTransport nrf_transport_hw_spi;      // 硬件SPI阻塞传输：user_nrf_spi_exchange()
+extern const NrfTransport nrf_transport_hw_spi_dma;  // 硬件SPI+DMA：user_nrf_spi_exchange_dma()，短传输用user_nrf_spi_exchange()
+
 /* ========================= API函数接口 ========================= */
+/**
+  * @brief  初始化NRF24L01器件
+  * @param  dev       : 器件句柄（NULL表示默认器件）
+  * @param  transport : SPI传输层（NULL表示nrf_transport_soft_spi）
+  * @param  config    : 配置参数指针（为NULL时使用默认配置）
+  * @retval NrfStatus : 初始化状态
+  */
+NrfStatus nrf24l01_init_ex(NrfDevice *dev, const NrfTransport *transport, NrfConfig *config);
+
+/**
+  * @brief  检查器件是否存在
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval NrfStatus : NRF_OK-存在，NRF_NOT_FOUND-不存在
+  */
+NrfStatus nrf24l01_check_ex(NrfDevice *dev);
+
+/**
+  * @brief  设置工作模式
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  mode : 工作模式（NRF_MODE_TX/NRF_MODE_RX）
+  * @retval 无
+  */
+void nrf24l01_set_mode_ex(NrfDevice *dev, NrfMode mode);
+
+/**
+  * @brief  发送数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : 发送状态
+  */
+NrfStatus nrf24l01_send_packet_ex(NrfDevice *dev, uint8_t *data, uint8_t len);
+
+/**
+  * @brief  接收数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 缓冲区长度
+  * @retval uint8_t : 实际接收的数据长度（0表示无数据）
+  * @note   每次读出RX FIFO中的一个数据包，其余数据包留待下次调用；需要一次读出全部时用nrf24l01_receive_batch()
+  */
+uint8_t nrf24l01_receive_packet_ex(NrfDevice *dev, uint8_t *data, uint8_t len);
+
+/**
+  * @brief  读取寄存器
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  reg : 寄存器地址
+  * @retval uint8_t : 寄存器值
+  */
+uint8_t nrf24l01_read_reg_ex(NrfDevice *dev, uint8_t reg);
+
+/**
+  * @brief  写入寄存器（或发送单字节参数的命令）
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  reg   : 命令字节（如NRF_WRITE_REG + 寄存器地址）
+  * @param  value : 寄存器值
+  * @retval uint8_t : 状态寄存器值
+  */
+uint8_t nrf24l01_write_reg_ex(NrfDevice *dev, uint8_t reg, uint8_t value);
+
+/**
+  * @brief  读取缓冲区（一次SPI突发传输）
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  reg : 命令字节（如寄存器地址、RD_RX_PLOAD）
+  * @param  buf : 数据缓冲区
+  * @param  len : 数据长度（0~NRF_MAX_PAYLOAD）
+  * @retval uint8_t : 状态寄存器值（len超出范围时不传输，返回0xFF）
+  */
+uint8_t nrf24l01_read_buf_ex(NrfDevice *dev, uint8_t reg, uint8_t *buf, uint8_t len);
+
+/**
+  * @brief  写入缓冲区（一次SPI突发传输）
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  reg : 命令字节（如NRF_WRITE_REG + 寄存器地址、WR_TX_PLOAD）
+  * @param  buf : 数据缓冲区
+  * @param  len : 数据长度（0~NRF_MAX_PAYLOAD）
+  * @retval uint8_t : 状态寄存器值（len超出范围时不传输，返回0xFF）
+  */
+uint8_t nrf24l01_write_buf_ex(NrfDevice *dev, uint8_t reg, const uint8_t *buf, uint8_t len);
+
+/**
+  * @brief  异步缓冲区读写
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  reg  : 命令字节
+  * @param  tx   : 要写入的数据（NULL表示读取，发送0xFF）
+  * @param  rx   : 读出数据的存放位置（NULL表示不需要，完成前保持有效）
+  * @param  len  : 数据长度（0~NRF_MAX_PAYLOAD）
+  * @param  done : 完成回调（可为NULL）
+  * @retval NrfStatus : NRF_OK-已启动（或已完成），NRF_ERROR-参数错误或上一次传输未完成
+  * @note   传输层支持DMA且传输不短于NRF_DMA_MIN_LEN时立即返回，完成中断中回调done；
+  *         否则阻塞完成并在返回前回调done。tx的内容在调用时即被拷贝
+  */
+NrfStatus nrf24l01_transfer_async(NrfDevice *dev, uint8_t reg, const uint8_t *tx, uint8_t *rx, uint8_t len,
+                                  NrfXferDoneFunc done);
+
+/**
+  * @brief  DMA传输完成处理
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval 无
+  * @note   在SPI DMA接收完成中断中调用：释放CS，取出读到的数据，回调完成函数
+  */
+void nrf24l01_transfer_complete_isr(NrfDevice *dev);
+
+/* ========================= 中断驱动收发 ========================= */
+/**
+  * @brief  设置中断驱动收发的回调
+  * @param  dev       : 器件句柄（NULL表示默认器件）
+  * @param  callbacks : 回调（须保持有效，NULL表示不回调）
+  * @retval 无
+  * @note   在nrf24l01_init_ex()之后调用
+  */
+void nrf24l01_set_callbacks(NrfDevice *dev, const NrfCallbacks *callbacks);
+
+/**
+  * @brief  非阻塞发送数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区（调用时即写入TX FIFO）
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已写入TX FIFO，结果由tx_done回调；NRF_ERROR-参数错误或上一包尚未发送结束
+  * @note   须先以nrf24l01_set_mode_ex(dev, NRF_MODE_TX)进入发送模式
+  */
+NrfStatus nrf24l01_send_async(NrfDevice *dev, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  数据包加入发送队列（流水线发送）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区（调用时即拷贝）
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已加入队列，结果按顺序由tx_done回调；NRF_ERROR-参数错误或队列已满
+  * @note   TX FIFO的3个位置始终保持装满：未满时立即写入，其余在IRQ中断处理中随TX_DS补充，
+  *         器件连续发射而不等待主循环；须先以nrf24l01_set_mode_ex(dev, NRF_MODE_TX)进入发送模式
+  */
+NrfStatus nrf24l01_send_queued(NrfDevice *dev, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  数据包加入发送队列，本包不要求应答
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区（调用时即拷贝）
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已加入队列，NRF_ERROR-未启用NRF_FEATURE_NO_ACK、参数错误或队列已满
+  * @note   用W_TX_PAYLOAD_NOACK写入，发射一次即置位TX_DS（tx_done回调NRF_OK），不等待应答也不重发，
+  *         适合周期性刷新、丢一包无妨的数据；接收端不回应答，省去应答的切换和空中时间
+  */
+NrfStatus nrf24l01_send_noack(NrfDevice *dev, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  写入应答附带数据（接收端）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 通道号（0~5），下次收到该通道的数据包时随应答发出
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节）
+  * @retval NrfStatus : NRF_OK-已写入，NRF_ERROR-未启用NRF_FEATURE_ACK_PAYLOAD、通道未启用、参数错误或TX FIFO已满
+  * @note   接收端的TX FIFO最多存放3个应答附带数据；随应答发出后置位TX_DS。发送端收到的应答附带数据
+  *         与普通数据包一样进入RX FIFO（通道0），由nrf24l01_irq_handler()/nrf24l01_receive_batch()读出
+  */
+NrfStatus nrf24l01_write_ack_payload(NrfDevice *dev, uint8_t pipe, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  发送队列中未发送结束的数据包数
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval uint8_t : 数据包数（0表示全部发送结束）
+  */
+uint8_t nrf24l01_tx_pending(NrfDevice *dev);
+
+/**
+  * @brief  设置MAX_RT后的软件重发策略
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  limit : 每个数据包在硬件自动重发用尽后再重发的轮数（0表示直接丢弃，默认0）
+  * @retval 无
+  * @note   重发时数据包仍在TX FIFO队首，清除MAX_RT即重新发射，后面的数据包不受影响；
+  *         丢弃时清空TX FIFO，再把后面的数据包重新写入
+  */
+void nrf24l01_set_tx_retry(NrfDevice *dev, uint8_t limit);
+
+/**
+  * @brief  IRQ引脚中断处理
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @retval 无
+  * @note   在IRQ引脚下降沿外部中断中调用：一次传输读取STATUS和FIFO_STATUS，读出RX FIFO中的全部数据包到接收队列，
+  *         清除已处理的中断标志，再依次回调tx_done/rx_ready
+  *         主循环中调用本器件的其他接口时须暂时屏蔽该外部中断，避免SPI传输交叠
+  *         处理期间的传输（含回调中的调用）一律阻塞完成，不使用DMA，中断中不会等待DMA完成中断；
+  *         异步传输进行中时只记录IRQ，由nrf24l01_transfer_complete_isr()在传输完成后补处理
+  */
+void nrf24l01_irq_handler(NrfDevice *dev);
+
+/**
+  * @brief  批量接收：读出RX FIFO中的全部数据包（轮询方式）
+  * @param  dev   : 器件句柄（NULL表示默认器件）
+  * @param  batch : 数据包存放位置（含数据长度和接收通道）
+  * @param  max   : batch的容量（数据包数，RX FIFO最多3包）
+  * @retval uint8_t : 读出的数据包数（0表示无数据）
+  * @note   每包读出后检查FIFO_STATUS的RX_EMPTY，通道号取自STATUS的bit3:1；RX FIFO读空后才清除RX_DR，
+  *         batch已满而仍有数据时保留RX_DR，剩余数据包下次读出。不要与nrf24l01_irq_handler()同时使用
+  */
+uint8_t nrf24l01_receive_batch(NrfDevice *dev, NrfPacket *batch, uint8_t max);
+
+/**
+  * @brief  从接收队列取出一个数据包
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  data : 数据缓冲区
+  * @param  len  : 缓冲区长度（1~NRF_MAX_PAYLOAD，数据包更长时截断）
+  * @param  pipe : 接收通道（为NULL时不需要）
+  * @retval uint8_t : 数据长度（0表示队列为空，或data为NULL/len为0，此时数据包留在队列中）
+  */
+uint8_t nrf24l01_receive_queued(NrfDevice *dev, uint8_t *data, uint8_t len, uint8_t *pipe);
+
+/* ========================= 多通道接收 ========================= */
+/**
+  * @brief  设置多通道接收（星形网络中心节点）并进入接收模式
+  * @param  dev : 器件句柄（NULL表示默认器件）
+  * @param  hub : 多通道配置（调用时即拷贝，NULL表示恢复只用通道0）
+  * @retval NrfStatus : NRF_OK-成功，NRF_ERROR-参数错误（无启用的通道、通道号超出0~5、宽度大于32或动态数据长度的通道未自动应答）
+  * @note   写入RX_ADDR_P0~P5、EN_AA、EN_RXADDR、RX_PW_P0~P5和DYNPD；此后nrf24l01_set_mode_ex(dev, NRF_MODE_RX)
+  *         均按此配置。接收的数据包带通道号，按通道交给处理函数或放入接收队列，并计入该通道的统计
+  */
+NrfStatus nrf24l01_hub_config(NrfDevice *dev, const NrfHubConfig *hub);
+
+/**
+  * @brief  设置通道的数据包处理函数
+  * @param  dev     : 器件句柄（NULL表示默认器件）
+  * @param  pipe    : 通道号（0~5）
+  * @param  handler : 处理函数（NULL表示该通道的数据包放入接收队列）
+  * @retval NrfStatus : NRF_OK-成功，NRF_ERROR-通道号错误
+  * @note   只对nrf24l01_irq_handler()读出的数据包有效；nrf24l01_receive_batch()/nrf24l01_receive_packet_ex()
+  *         直接返回数据包
+  */
+NrfStatus nrf24l01_set_pipe_handler(NrfDevice *dev, uint8_t pipe, NrfPipeHandler handler);
+
+/**
+  * @brief  向某个通道的节点发送数据包（阻塞，中心节点下行）
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 节点所在的通道（0~5，须已启用），以该通道的地址发送
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度（1-32字节，节点为固定宽度时须与其一致）
+  * @retval NrfStatus : NRF_OK-已收到应答（节点所在通道不自动应答时为已发出），
+  *                     NRF_ERROR-参数错误、发送队列非空或达到最大重发次数，NRF_TIMEOUT-超时
+  * @note   临时切换到发送模式（通道0地址改为节点地址以接收应答），结束后恢复多通道接收；期间不接收，
+  *         其他节点的数据包由其自动重发补上。TX FIFO中未发出的应答附带数据被清除，RX_DR保持不变。
+  *         节点只作发送端时，用nrf24l01_write_ack_payload()随应答下发更省时
+  */
+NrfStatus nrf24l01_hub_send(NrfDevice *dev, uint8_t pipe, const uint8_t *data, uint8_t len);
+
+/**
+  * @brief  读取通道统计
+  * @param  dev  : 器件句柄（NULL表示默认器件）
+  * @param  pipe : 通道号（0~5）
+  * @retval const NrfPipeStats* : 统计（通道号错误时为NULL）
+  */
+const NrfPipeStats *nrf24l01_pipe_stats(NrfDevice *dev, uint8_t pipe);
+
+/* ========================= 兼容接口（默认器件） ========================= */
 /**
   * @brief  初始化NRF24L01模块
   * @param  config : 配置参数指针（为NULL时使用默认配置）
@@ -174,6 +609,14 @@ uint8_t nrf24l01_read_buf(uint8_t reg, uint8_t *buf, uint8_t len);
 uint8_t nrf24l01_write_buf(uint8_t reg, uint8_t *buf, uint8_t len);
 
 /* ========================= 用户实现接口 ========================= */
+/**
+  * @brief  GPIO初始化（用户必须实现）
+  * @param  无
+  * @retval 无
+  * @note   在nrf24l01_init()/nrf24l01_init_ex()开头调用
+  */
+void user_nrf_gpio_init(void);
+
 /**
   * @brief  设置CE引脚电平（用户必须实现）
   * @param  level : 0-低电平，1-高电平
@@ -209,6 +652,28 @@ void user_nrf_mosi_write(uint8_t level);
   */
 uint8_t user_nrf_miso_read(void);
 
+/**
+  * @brief  硬件SPI阻塞交换（使用nrf_transport_hw_spi/nrf_transport_hw_spi_dma时实现）
+  * @param  dev : 器件句柄
+  * @param  tx  : 发送数据（NULL时发送0xFF）
+  * @param  rx  : 接收数据存放位置（NULL时丢弃）
+  * @param  len : 字节数
+  * @retval 无
+  * @note   示例：HAL_SPI_TransmitReceive(&hspi1, tx, rx, len, 10);
+  */
+void user_nrf_spi_exchange(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len);
+
+/**
+  * @brief  启动硬件SPI DMA交换（使用nrf_transport_hw_spi_dma时实现）
+  * @param  dev : 器件句柄
+  * @param  tx  : 发送数据（非NULL，完成前保持有效）
+  * @param  rx  : 接收数据存放位置（非NULL，完成前保持有效）
+  * @param  len : 字节数
+  * @retval uint8_t : 1-已启动，完成中断中调用nrf24l01_transfer_complete_isr(dev)  0-未启动（改为阻塞交换）
+  * @note   示例：return HAL_SPI_TransmitReceive_DMA(&hspi1, tx, rx, len) == HAL_OK;
+  */
+uint8_t user_nrf_spi_exchange_dma(NrfDevice *dev, const uint8_t *tx, uint8_t *rx, uint16_t len);
+
 /**
   * @brief  读取IRQ引脚电平（用户必须实现）
   * @param  无
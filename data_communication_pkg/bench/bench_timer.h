@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    bench_timer.h
+  * @brief   主机端性能测试计时工具
+  * @note    x86主机使用RDTSC计数（cycles），其他主机使用纳秒计时（ns）
+  ******************************************************************************
+  */
+
+#ifndef __BENCH_TIMER_H
+#define __BENCH_TIMER_H
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cycles"
+static inline uint64_t bench_now(void)
+{
+    return __rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+/**
+  * @brief  单调时钟秒数，用于计算吞吐率
+  */
+static inline double bench_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#endif /* __BENCH_TIMER_H */
@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file    capture_bench.c
+  * @brief   抓包记录正确性和开销测试
+  * @note    需以DATA_COMM_CAPTURE=1、DATA_COMM_CAPTURE_RING_SIZE>0编译
+  *          1. 发送端记录TX、接收端记录RX和FRAME到文件，接收端交替使用逐字节和批量解析；
+  *             文件中FRAME记录必须与实际交付的数据包一致，之后可用data_comm_replay回放
+  *          2. 内置环形缓冲区写满后覆盖最早记录，取出的数据必须是完整的记录链，
+  *             且以最后交付的数据包结尾
+  *          3. 对比关闭抓包、抓包到环形缓冲区时批量解析的耗时
+  *          capture_bench [--quick] [抓包文件]    --quick减少帧数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !DATA_COMM_CAPTURE || DATA_COMM_CAPTURE_RING_SIZE == 0
+#error "capture_bench需要DATA_COMM_CAPTURE=1且DATA_COMM_CAPTURE_RING_SIZE>0"
+#endif
+
+#define BENCH_CHUNK   256     // 开销测试的批量解析块长
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static FILE *g_file;
+static uint32_t g_rx_packets;
+static uint32_t g_rx_hash;
+static uint8_t g_last[1 + MAX_DATA_LENGTH];
+static uint16_t g_last_len;
+static uint32_t g_time;
+
+/* ========================= 测试用回调 ========================= */
+uint32_t user_capture_time(void)
+{
+    return g_time;
+}
+
+static uint32_t fnv(uint32_t hash, const uint8_t *data, uint16_t len)
+{
+    while (len--) {
+        hash = (hash ^ *data++) * 16777619u;
+    }
+    return hash;
+}
+
+static void bench_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    memcpy(g_stream + g_stream_len, data, len);
+    g_stream_len += len;
+}
+
+static void bench_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    g_rx_packets++;
+    g_rx_hash = fnv(fnv(g_rx_hash, &cmd, 1), data, len);
+    g_last[0] = cmd;
+    memcpy(&g_last[1], data, len);
+    g_last_len = (uint16_t)(len + 1);
+}
+
+static void file_sink(DataCommHandle *handle, const uint8_t *head, uint8_t head_len,
+                      const uint8_t *data, uint16_t data_len)
+{
+    (void)handle;
+    fwrite(head, 1, head_len, g_file);
+    fwrite(data, 1, data_len, g_file);
+}
+
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+/**
+  * @brief  生成随机帧流：短帧为主，夹杂随机字节和位翻转
+  */
+static void make_stream(DataCommHandle *tx, uint32_t frames)
+{
+    static uint8_t payload[MAX_DATA_LENGTH];
+    uint32_t f, flips;
+    uint16_t len, i;
+
+    g_stream_len = 0;
+    for (f = 0; f < frames; f++) {
+        len = (uint16_t)(bench_rand() % ((bench_rand() % 4 == 0) ? MAX_DATA_LENGTH + 1 : 32));
+        for (i = 0; i < len; i++) {
+            payload[i] = (uint8_t)bench_rand();
+        }
+        if (bench_rand() % 8 == 0) {
+            g_stream[g_stream_len++] = (uint8_t)bench_rand();
+        }
+        g_time++;
+        data_comm_send_ex(tx, (uint8_t)bench_rand(), payload, len);
+    }
+    for (flips = frames / 20; flips > 0; flips--) {
+        g_stream[bench_rand() % g_stream_len] ^= (uint8_t)(1u << (bench_rand() % 8));
+    }
+}
+
+/**
+  * @brief  按随机分块交替逐字节/批量解析整个数据流
+  */
+static void parse_stream(DataCommHandle *rx)
+{
+    size_t pos = 0, n, i;
+
+    while (pos < g_stream_len) {
+        n = 1 + bench_rand() % 300;
+        if (n > g_stream_len - pos) {
+            n = g_stream_len - pos;
+        }
+        g_time++;
+        if (bench_rand() % 2) {
+            data_comm_parse_buffer_ex(rx, &g_stream[pos], n);
+        } else {
+            for (i = 0; i < n; i++) {
+                data_comm_parse_byte_ex(rx, g_stream[pos + i]);
+            }
+        }
+        pos += n;
+    }
+}
+
+/**
+  * @brief  按固定块长批量解析整个数据流
+  */
+static void parse_chunks(DataCommHandle *rx)
+{
+    size_t pos;
+
+    for (pos = 0; pos < g_stream_len; pos += BENCH_CHUNK) {
+        data_comm_parse_buffer_ex(rx, &g_stream[pos], (g_stream_len - pos < BENCH_CHUNK) ? g_stream_len - pos : BENCH_CHUNK);
+    }
+}
+
+/**
+  * @brief  校验记录链，统计FRAME记录，返回最后一条FRAME记录
+  */
+static int check_records(const uint8_t *p, size_t size, uint32_t *frames, uint32_t *hash,
+                         const uint8_t **last, uint16_t *last_len)
+{
+    size_t off = 0;
+    uint16_t len;
+
+    *frames = 0;
+    *hash = 2166136261u;
+    *last = NULL;
+    while (off < size) {
+        if (size - off < DATA_COMM_CAP_HEAD_SIZE) {
+            return -1;
+        }
+        len = (uint16_t)((p[off + 2] << 8) | p[off + 3]);
+        if (size - off - DATA_COMM_CAP_HEAD_SIZE < len || p[off] > DATA_COMM_CAP_FRAME) {
+            return -1;
+        }
+        if (p[off] == DATA_COMM_CAP_FRAME) {
+            (*frames)++;
+            *hash = fnv(*hash, &p[off + DATA_COMM_CAP_HEAD_SIZE], len);
+            *last = &p[off + DATA_COMM_CAP_HEAD_SIZE];
+            *last_len = len;
+        }
+        off += DATA_COMM_CAP_HEAD_SIZE + len;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t ring_out[DATA_COMM_CAPTURE_RING_SIZE];
+    const char *path = "capture.bin";
+    uint32_t frames = 50000, rec_frames, rec_hash;
+    DataCommHandle tx, rx;
+    DataCommConfig config;
+    const uint8_t *last;
+    uint16_t last_len;
+    uint8_t *file_buf;
+    size_t file_len, ring_len;
+    uint64_t t, t_off, t_on;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            frames = 2000;
+        } else {
+            path = argv[i];
+        }
+    }
+    g_stream = (uint8_t *)malloc((size_t)frames * (DATA_COMM_FRAME_SIZE + 8));
+    file_buf = (uint8_t *)malloc((size_t)frames * (DATA_COMM_FRAME_SIZE + 8) * 3);
+    g_file = fopen(path, "wb");
+    if (g_stream == NULL || file_buf == NULL || g_file == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.transmit = bench_transmit;
+    config.packet_handler = bench_packet_handler;
+    data_comm_init_ex(&tx, &config);
+    data_comm_init_ex(&rx, &config);
+
+    /* 1. 抓包到文件：发送端为链路1，接收端为链路0 */
+    g_rx_hash = 2166136261u;
+    data_comm_capture_start(&tx, 1, DATA_COMM_CAP_MASK_TX, file_sink);
+    data_comm_capture_start(&rx, 0, DATA_COMM_CAP_MASK_RX | DATA_COMM_CAP_MASK_FRAME, file_sink);
+    make_stream(&tx, frames);
+    parse_stream(&rx);
+    data_comm_capture_stop(&tx);
+    data_comm_capture_stop(&rx);
+    fclose(g_file);
+
+    g_file = fopen(path, "rb");
+    file_len = (g_file != NULL) ? fread(file_buf, 1, (size_t)frames * (DATA_COMM_FRAME_SIZE + 8) * 3, g_file) : 0;
+    if (g_file != NULL) {
+        fclose(g_file);
+    }
+    CHECK(check_records(file_buf, file_len, &rec_frames, &rec_hash, &last, &last_len) == 0);
+    printf("capture file %s: %zu bytes for %zu stream bytes, %u frames\n", path, file_len, g_stream_len, rec_frames);
+    CHECK(rec_frames == g_rx_packets && rec_hash == g_rx_hash);
+
+    /* 2. 环形缓冲区：写满后取出的必须是完整记录链，且以最后交付的包结尾 */
+    data_comm_init_ex(&rx, &config);
+    data_comm_capture_start(&rx, 0, DATA_COMM_CAP_MASK_RX | DATA_COMM_CAP_MASK_FRAME, NULL);
+    parse_stream(&rx);
+    data_comm_capture_flush(&rx);
+    ring_len = data_comm_capture_read(ring_out, sizeof(ring_out));
+    CHECK(check_records(ring_out, ring_len, &rec_frames, &rec_hash, &last, &last_len) == 0);
+    printf("ring %u bytes: read %zu bytes, %u frames, %u records dropped\n",
+           DATA_COMM_CAPTURE_RING_SIZE, ring_len, rec_frames, data_comm_capture_dropped());
+    CHECK(last != NULL && last_len == g_last_len && memcmp(last, g_last, last_len) == 0);
+    CHECK(data_comm_capture_dropped() != 0 && data_comm_capture_read(ring_out, sizeof(ring_out)) == 0);
+
+    /* 3. 批量解析开销（按DMA典型块长分块） */
+    data_comm_init_ex(&rx, &config);
+    t = bench_now();
+    parse_chunks(&rx);
+    t_off = bench_now() - t;
+    data_comm_capture_start(&rx, 0, DATA_COMM_CAP_MASK_RX | DATA_COMM_CAP_MASK_FRAME, NULL);
+    t = bench_now();
+    parse_chunks(&rx);
+    t_on = bench_now() - t;
+    printf("  parse_buffer, capture off : %6.2f %s/byte\n", (double)t_off / g_stream_len, BENCH_UNIT);
+    printf("  parse_buffer, RX+FRAME    : %6.2f %s/byte\n", (double)t_on / g_stream_len, BENCH_UNIT);
+
+    free(g_stream);
+    free(file_buf);
+    return 0;
+}
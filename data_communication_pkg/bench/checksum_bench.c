@@ -0,0 +1,339 @@
+/**
+  ******************************************************************************
+  * @file    checksum_bench.c
+  * @brief   可选校验算法（DATA_COMM_CHECKSUM）正确性和性能测试
+  * @note    需以DATA_COMM_CHECKSUM=1编译
+  *          1. 各算法对"123456789"的check值，分段计算与整块计算一致
+  *          2. CRC16算法和外设CRC（本文件用逐位计算模拟外设寄存器）组出的帧
+  *             与内置CRC16逐字节一致
+  *          3. 每种算法自发自收：无误码时逐字节/批量解析全部交付，每帧翻转1位时全部丢弃
+  *          4. 外设异步计算：完成前发送函数返回0，完成后发出的帧与同步计算一致
+  *          5. 对比各算法组帧和批量解析的每字节耗时
+  *          checksum_bench [--quick]    --quick减少帧数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !DATA_COMM_CHECKSUM
+#error "checksum_bench需要DATA_COMM_CHECKSUM=1"
+#endif
+
+#define BENCH_CHUNK   256     // 批量解析块长
+
+typedef struct {
+    const char *name;
+    const DataCommChecksum *checksum;   // NULL为内置CRC16
+    uint32_t check;                     // "123456789"的校验值
+} Backend;
+
+static const Backend g_backends[] = {
+    {"builtin",    NULL,                          0x29B1},
+    {"crc16",      &data_comm_checksum_crc16,     0x29B1},
+    {"crc32",      &data_comm_checksum_crc32,     0xCBF43926},
+    {"fletcher16", &data_comm_checksum_fletcher16, 0x1EDE},
+    {"hw",         &data_comm_checksum_hw,        0x29B1},
+};
+#define BACKEND_NUM  (sizeof(g_backends) / sizeof(g_backends[0]))
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static uint32_t g_packets, g_hash;
+
+/* 模拟外设 */
+static uint32_t g_hw_calls;
+static uint8_t g_hw_async;
+static const uint8_t *g_hw_data;
+static uint16_t g_hw_len;
+static DataCommHandle *g_hw_handle;
+
+/* ========================= 测试用回调 ========================= */
+/**
+  * @brief  外设CRC寄存器模型：每次写入初值后逐位计算
+  */
+uint32_t user_checksum_hw(uint32_t crc, const uint8_t *data, uint16_t len)
+{
+    uint8_t i;
+
+    g_hw_calls++;
+    while (len--) {
+        crc ^= (uint32_t)*data++ << 8;
+        for (i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+        crc &= 0xFFFF;
+    }
+    return crc;
+}
+
+uint8_t user_checksum_hw_start(DataCommHandle *handle, const uint8_t *data, uint16_t len)
+{
+    if (!g_hw_async) {
+        return 0;
+    }
+    g_hw_handle = handle;
+    g_hw_data = data;
+    g_hw_len = len;
+    return 1;
+}
+
+static uint32_t fnv(uint32_t hash, const uint8_t *data, uint16_t len)
+{
+    while (len--) {
+        hash = (hash ^ *data++) * 16777619u;
+    }
+    return hash;
+}
+
+static void bench_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    memcpy(g_stream + g_stream_len, data, len);
+    g_stream_len += len;
+}
+
+static void bench_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    g_packets++;
+    g_hash = fnv(fnv(g_hash, &cmd, 1), data, len);
+}
+
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+/**
+  * @brief  1. check值，分段计算与整块计算一致
+  */
+static void check_values(void)
+{
+    static const uint8_t check[] = "123456789";
+    uint8_t buf[1000];
+    const DataCommChecksum *cs;
+    uint32_t whole, part;
+    uint16_t i, cut;
+    size_t b;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)bench_rand();
+    }
+    for (b = 1; b < BACKEND_NUM; b++) {
+        cs = g_backends[b].checksum;
+        whole = cs->update(cs->init, check, 9);
+        if (cs->final != NULL) {
+            whole = cs->final(whole);
+        }
+        CHECK(whole == g_backends[b].check);
+        whole = cs->update(cs->init, buf, sizeof(buf));
+        for (cut = 0; cut <= sizeof(buf); cut += 37) {
+            part = cs->update(cs->update(cs->init, buf, cut), &buf[cut], (uint16_t)(sizeof(buf) - cut));
+            CHECK(part == whole);
+        }
+    }
+    CHECK(data_comm_crc16(CRC16_INIT, check, 9) == 0x29B1);
+}
+
+/**
+  * @brief  生成随机帧流
+  * @param  flip : 是否在每帧载荷（或命令字节）中翻转1位
+  */
+static uint32_t make_stream(DataCommHandle *tx, uint32_t frames, int flip)
+{
+    static uint8_t payload[MAX_DATA_LENGTH];
+    uint32_t f, hash = 2166136261u;
+    uint16_t len, i;
+    size_t start;
+    uint8_t cmd;
+
+    g_stream_len = 0;
+    for (f = 0; f < frames; f++) {
+        len = (uint16_t)(bench_rand() % (MAX_DATA_LENGTH + 1));
+        for (i = 0; i < len; i++) {
+            payload[i] = (uint8_t)bench_rand();
+        }
+        cmd = (uint8_t)bench_rand();
+        start = g_stream_len;
+        data_comm_send_ex(tx, cmd, payload, len);
+        hash = fnv(fnv(hash, &cmd, 1), payload, len);
+        if (flip) {
+            /* 帧头(2) + 长度(2)之后的命令和载荷 */
+            g_stream[start + 4 + bench_rand() % (len + 1)] ^= (uint8_t)(1u << (bench_rand() % 8));
+        }
+    }
+    return hash;
+}
+
+static void parse_all(DataCommHandle *rx, int bulk)
+{
+    size_t pos, i, n;
+
+    g_packets = 0;
+    g_hash = 2166136261u;
+    for (pos = 0; pos < g_stream_len; pos += n) {
+        n = (g_stream_len - pos < BENCH_CHUNK) ? g_stream_len - pos : BENCH_CHUNK;
+        if (bulk) {
+            data_comm_parse_buffer_ex(rx, &g_stream[pos], n);
+        } else {
+            for (i = 0; i < n; i++) {
+                data_comm_parse_byte_ex(rx, g_stream[pos + i]);
+            }
+        }
+    }
+}
+
+/**
+  * @brief  2. CRC16算法、外设CRC与内置CRC16组帧逐字节一致
+  */
+static void check_agree(DataCommHandle *tx, uint32_t frames)
+{
+    uint8_t *ref;
+    size_t ref_len;
+    uint32_t seed = g_rand;
+    size_t b;
+
+    ref = (uint8_t *)malloc((size_t)frames * DATA_COMM_FRAME_SIZE);
+    CHECK(ref != NULL);
+    data_comm_set_checksum(tx, NULL);
+    make_stream(tx, frames, 0);
+    memcpy(ref, g_stream, g_stream_len);
+    ref_len = g_stream_len;
+    for (b = 1; b < BACKEND_NUM; b++) {
+        if (g_backends[b].check != 0x29B1) {
+            continue;
+        }
+        g_rand = seed;
+        g_hw_calls = 0;
+        data_comm_set_checksum(tx, g_backends[b].checksum);
+        make_stream(tx, frames, 0);
+        CHECK(g_stream_len == ref_len && memcmp(g_stream, ref, ref_len) == 0);
+        CHECK(g_backends[b].checksum != &data_comm_checksum_hw || g_hw_calls == frames);
+    }
+    printf("crc16 / hw frames identical to built-in CRC16 over %u frames: OK\n", frames);
+    free(ref);
+}
+
+/**
+  * @brief  3. 每种算法自发自收
+  */
+static void check_link(DataCommHandle *tx, DataCommHandle *rx, uint32_t frames)
+{
+    uint32_t expect;
+    size_t b;
+    int bulk, flip;
+
+    for (b = 0; b < BACKEND_NUM; b++) {
+        data_comm_set_checksum(tx, g_backends[b].checksum);
+        data_comm_set_checksum(rx, g_backends[b].checksum);
+        for (flip = 0; flip < 2; flip++) {
+            expect = make_stream(tx, frames, flip);
+            for (bulk = 0; bulk < 2; bulk++) {
+                parse_all(rx, bulk);
+                CHECK(flip ? g_packets == 0 : (g_packets == frames && g_hash == expect));
+            }
+        }
+    }
+    printf("round trip, clean and single-bit errors, all backends: OK\n");
+}
+
+/**
+  * @brief  4. 外设异步计算
+  */
+static void check_async(DataCommHandle *tx)
+{
+    uint8_t payload[100], sync[DATA_COMM_FRAME_SIZE];
+    uint16_t sync_len, i;
+
+    for (i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)bench_rand();
+    }
+    data_comm_set_checksum(tx, &data_comm_checksum_hw);
+    g_stream_len = 0;
+    data_comm_send_ex(tx, 0x42, payload, sizeof(payload));
+    memcpy(sync, g_stream, g_stream_len);
+    sync_len = (uint16_t)g_stream_len;
+
+    /* 外设计算期间帧保持未发送，其他发送被拒绝 */
+    g_hw_async = 1;
+    g_stream_len = 0;
+    CHECK(data_comm_send_ex(tx, 0x42, payload, sizeof(payload)) == sync_len && g_stream_len == 0);
+    CHECK(data_comm_send_ex(tx, 0x43, payload, 1) == 0 && data_comm_reserve(tx, 1) == NULL);
+
+    /* 计算完成后发出的帧与同步计算一致，发送恢复 */
+    g_hw_async = 0;
+    data_comm_checksum_done(g_hw_handle, user_checksum_hw(CRC16_INIT, g_hw_data, g_hw_len));
+    CHECK(g_stream_len == sync_len && memcmp(g_stream, sync, sync_len) == 0);
+    CHECK(data_comm_send_ex(tx, 0x43, payload, 1) != 0);
+    printf("async peripheral checksum: OK\n");
+}
+
+/**
+  * @brief  5. 各算法耗时（MAX_DATA_LENGTH字节载荷）
+  */
+static void bench(DataCommHandle *tx, DataCommHandle *rx, uint32_t frames)
+{
+    static uint8_t payload[MAX_DATA_LENGTH];
+    uint64_t t_tx, t_rx, t;
+    uint32_t f;
+    size_t b;
+
+    for (f = 0; f < MAX_DATA_LENGTH; f++) {
+        payload[f] = (uint8_t)bench_rand();
+    }
+    for (b = 0; b < BACKEND_NUM; b++) {
+        data_comm_set_checksum(tx, g_backends[b].checksum);
+        data_comm_set_checksum(rx, g_backends[b].checksum);
+        g_stream_len = 0;
+        t = bench_now();
+        for (f = 0; f < frames; f++) {
+            data_comm_send_ex(tx, (uint8_t)f, payload, MAX_DATA_LENGTH);
+        }
+        t_tx = bench_now() - t;
+        t = bench_now();
+        parse_all(rx, 1);
+        t_rx = bench_now() - t;
+        printf("  %-10s send_ex %6.2f  parse_buffer %6.2f %s/byte\n", g_backends[b].name,
+               (double)t_tx / g_stream_len, (double)t_rx / g_stream_len, BENCH_UNIT);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    DataCommHandle tx, rx;
+    DataCommConfig config;
+    uint32_t frames = 20000;
+
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        frames = 1000;
+    }
+    g_stream = (uint8_t *)malloc((size_t)frames * DATA_COMM_FRAME_SIZE);
+    if (g_stream == NULL) {
+        return 1;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.transmit = bench_transmit;
+    config.packet_handler = bench_packet_handler;
+    data_comm_init_ex(&tx, &config);
+    data_comm_init_ex(&rx, &config);
+
+    check_values();
+    check_agree(&tx, frames);
+    check_link(&tx, &rx, frames);
+    check_async(&tx);
+    bench(&tx, &rx, frames);
+
+    free(g_stream);
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+  ******************************************************************************
+  * @file    codec_bench.cpp
+  * @brief   FrameCodec模板与C实现的一致性和性能对比
+  * @note    1. 用data_comm_send_ex()生成随机帧流并注入误码，分别由C实现
+  *             （data_comm_parse_byte_ex/data_comm_parse_buffer_ex）和
+  *             FrameCodec（parse_byte/parse）解析，交付的数据包必须完全一致
+  *          2. 同一程序中再实例化一种无CRC、单字节长度的方言，验证自发自收
+  *          codec_bench [--quick]    --quick减少帧数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_codec.hpp"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef data_comm::FrameCodec<FRAME_HEADER, FRAME_END, 2, MAX_DATA_LENGTH, data_comm::Crc16Ccitt> LinkCodec;
+typedef data_comm::FrameCodec<0xA5A5, 0x5A5A, 1, 64, data_comm::NoChecksum> RadioCodec;
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+
+struct Result {
+    uint32_t packets;
+    uint32_t hash;
+};
+
+static void c_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    memcpy(g_stream + g_stream_len, data, len);
+    g_stream_len += len;
+}
+
+static void c_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    Result *r = (Result *)handle->config.user_data;
+
+    r->packets++;
+    r->hash = stub_hash_packet(r->hash, cmd, data, len);
+}
+
+static void codec_handler(void *user, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    Result *r = (Result *)user;
+
+    r->packets++;
+    r->hash = stub_hash_packet(r->hash, cmd, data, len);
+}
+
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+static void print_result(const char *name, const Result &r, uint64_t ticks, size_t bytes)
+{
+    printf("  %-28s %8u packets  %6.2f %s/byte\n", name, r.packets, (double)ticks / bytes, BENCH_UNIT);
+}
+
+/**
+  * @brief  自发自收检查另一种协议方言
+  */
+static void radio_roundtrip(void)
+{
+    static uint8_t frame[RadioCodec::kMaxFrame];
+    uint8_t payload[64];
+    Result r = {0, 0};
+    Result expect = {0, 0};
+    RadioCodec radio(codec_handler, &r);
+    uint16_t len, i, n;
+
+    for (len = 0; len <= 64; len++) {
+        for (i = 0; i < len; i++) {
+            payload[i] = (uint8_t)bench_rand();
+        }
+        n = RadioCodec::encode(frame, (uint8_t)len, payload, len);
+        CHECK(n == len + RadioCodec::kOverhead);
+        radio.parse(frame, n);
+        expect.packets++;
+        expect.hash = stub_hash_packet(expect.hash, (uint8_t)len, payload, len);
+    }
+    printf("  radio dialect (1-byte length, no CRC, overhead %u): %u/%u packets\n",
+           (unsigned)RadioCodec::kOverhead, r.packets, expect.packets);
+    CHECK(r.packets == expect.packets && r.hash == expect.hash);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t payload[MAX_DATA_LENGTH];
+    uint32_t frames = 50000, f, flips;
+    uint64_t t;
+    size_t i;
+    DataCommHandle gen, c_rx;
+    DataCommConfig config;
+    Result c_byte = {0, 0}, c_buf = {0, 0}, t_byte = {0, 0}, t_buf = {0, 0};
+    LinkCodec codec_byte(codec_handler, &t_byte);
+    LinkCodec codec_buf(codec_handler, &t_buf);
+
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        frames = 2000;
+    }
+    g_stream = (uint8_t *)malloc((size_t)frames * (DATA_COMM_FRAME_SIZE + 8));
+    if (g_stream == NULL) {
+        return 1;
+    }
+
+    /* 生成随机帧流：短帧为主，夹杂随机字节和位翻转 */
+    memset(&config, 0, sizeof(config));
+    config.transmit = c_transmit;
+    data_comm_init_ex(&gen, &config);
+    for (f = 0; f < frames; f++) {
+        uint16_t len = (uint16_t)(bench_rand() % ((bench_rand() % 4 == 0) ? MAX_DATA_LENGTH + 1 : 32));
+        for (i = 0; i < len; i++) {
+            payload[i] = (uint8_t)bench_rand();
+        }
+        if (bench_rand() % 8 == 0) {
+            g_stream[g_stream_len++] = (uint8_t)bench_rand();
+        }
+        data_comm_send_ex(&gen, (uint8_t)bench_rand(), payload, len);
+    }
+    for (flips = frames / 20; flips > 0; flips--) {
+        g_stream[bench_rand() % g_stream_len] ^= (uint8_t)(1u << (bench_rand() % 8));
+    }
+
+    printf("FrameCodec vs C parser, %u frames, %u bytes\n", frames, (unsigned)g_stream_len);
+
+    config.packet_handler = c_handler;
+    config.user_data = &c_byte;
+    data_comm_init_ex(&c_rx, &config);
+    t = bench_now();
+    for (i = 0; i < g_stream_len; i++) {
+        data_comm_parse_byte_ex(&c_rx, g_stream[i]);
+    }
+    print_result("C   data_comm_parse_byte_ex", c_byte, bench_now() - t, g_stream_len);
+
+    config.user_data = &c_buf;
+    data_comm_init_ex(&c_rx, &config);
+    t = bench_now();
+    data_comm_parse_buffer_ex(&c_rx, g_stream, g_stream_len);
+    print_result("C   data_comm_parse_buffer_ex", c_buf, bench_now() - t, g_stream_len);
+
+    t = bench_now();
+    for (i = 0; i < g_stream_len; i++) {
+        codec_byte.parse_byte(g_stream[i]);
+    }
+    print_result("C++ FrameCodec::parse_byte", t_byte, bench_now() - t, g_stream_len);
+
+    t = bench_now();
+    codec_buf.parse(g_stream, g_stream_len);
+    print_result("C++ FrameCodec::parse", t_buf, bench_now() - t, g_stream_len);
+
+    /* FrameCodec与C实现交付的数据包一致 */
+    CHECK(c_byte.packets == t_byte.packets && c_byte.hash == t_byte.hash);
+    CHECK(c_buf.packets == t_buf.packets && c_buf.hash == t_buf.hash);
+    CHECK(c_byte.hash == c_buf.hash);
+    radio_roundtrip();
+
+    free(g_stream);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+  ******************************************************************************
+  * @file    crc16_bench.c
+  * @brief   CRC16-CCITT计算方式主机端性能测试
+  * @note    每次编译只包含一种CRC16_METHOD，分别编译运行后对比输出：
+  *          for m in 0 1 2 3; do
+  *              gcc -O2 -I.. -DCRC16_METHOD=$m crc16_bench.c ../data_communication_pkg.c -o crc16_bench_$m
+  *              ./crc16_bench_$m
+  *          done
+  *          也可通过主机端CMake构建（见README），每种计算方式生成一个程序
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================= 测试参数 ========================= */
+#define BENCH_BUF_LEN     (MAX_DATA_LENGTH + 3)   // 长度+命令+数据，与发送时一次计算的长度一致
+#define BENCH_ROUNDS      20000                   // 整块计算轮数
+#define BENCH_FRAMES      20000                   // 逐字节解析帧数
+
+static const char *method_name[] = {"BITWISE", "TABLE", "SLICE4", "SLICE8"};
+
+static volatile uint16_t g_sink;
+
+/**
+  * @brief  参考实现：原始逐位CRC16-CCITT
+  */
+static uint16_t crc16_reference(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = CRC16_INIT;
+    uint16_t i;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (i = 0; i < 8; i++) {
+            if (crc & 0x8000) {
+                crc = (crc << 1) ^ 0x1021;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+/**
+  * @brief  整块计算性能：返回每字节耗时
+  */
+static double bench_bulk(int use_reference, const uint8_t *buf, uint16_t len)
+{
+    uint64_t start, end;
+    uint32_t round;
+
+    start = bench_now();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        if (use_reference) {
+            g_sink = crc16_reference(buf, len);
+        } else {
+            g_sink = data_comm_crc16(CRC16_INIT, buf, len);
+        }
+    }
+    end = bench_now();
+
+    return (double)(end - start) / ((double)BENCH_ROUNDS * len);
+}
+
+/**
+  * @brief  逐字节解析性能：统计每字节平均耗时和帧内最慢字节位置的平均耗时
+  * @note   按字节位置分别累计，避免偶发中断/调度干扰最大值
+  */
+static void bench_parse(double *avg, double *worst)
+{
+    static uint8_t frame[MAX_DATA_LENGTH + 10];
+    static uint64_t pos_total[MAX_DATA_LENGTH + 10];
+    uint16_t frame_len, i;
+    uint16_t crc;
+    uint32_t n;
+    uint64_t total = 0, t0, t1;
+
+    /* 构造一帧最大长度的合法数据包 */
+    frame_len = 0;
+    frame[frame_len++] = (FRAME_HEADER >> 8) & 0xFF;
+    frame[frame_len++] = FRAME_HEADER & 0xFF;
+    frame[frame_len++] = ((MAX_DATA_LENGTH + 1) >> 8) & 0xFF;
+    frame[frame_len++] = (MAX_DATA_LENGTH + 1) & 0xFF;
+    frame[frame_len++] = 0x01;
+    for (i = 0; i < MAX_DATA_LENGTH; i++) {
+        frame[frame_len++] = (uint8_t)(i * 7 + 3);
+    }
+    crc = crc16_reference(&frame[2], frame_len - 2);
+    frame[frame_len++] = (crc >> 8) & 0xFF;
+    frame[frame_len++] = crc & 0xFF;
+    frame[frame_len++] = (FRAME_END >> 8) & 0xFF;
+    frame[frame_len++] = FRAME_END & 0xFF;
+
+    for (n = 0; n < BENCH_FRAMES; n++) {
+        for (i = 0; i < frame_len; i++) {
+            t0 = bench_now();
+            data_comm_parse_byte(frame[i]);
+            t1 = bench_now();
+            total += t1 - t0;
+            pos_total[i] += t1 - t0;
+        }
+    }
+    *avg = (double)total / ((double)BENCH_FRAMES * frame_len);
+    *worst = 0;
+    for (i = 0; i < frame_len; i++) {
+        if ((double)pos_total[i] / BENCH_FRAMES > *worst) {
+            *worst = (double)pos_total[i] / BENCH_FRAMES;
+        }
+    }
+}
+
+int main(void)
+{
+    static const uint8_t check[] = "123456789";
+    static uint8_t buf[BENCH_BUF_LEN];
+    uint16_t i;
+    double ref, eng, parse_avg, parse_worst;
+
+    /* 正确性校验：CRC-16/CCITT-FALSE标准校验值 */
+    CHECK(data_comm_crc16(CRC16_INIT, check, 9) == 0x29B1);
+
+    srand(1);
+    for (i = 0; i < BENCH_BUF_LEN; i++) {
+        buf[i] = (uint8_t)rand();
+    }
+
+    /* 分段计算结果必须与整块计算一致 */
+    for (i = 0; i <= BENCH_BUF_LEN; i++) {
+        uint16_t crc = data_comm_crc16(CRC16_INIT, buf, i);
+        crc = data_comm_crc16(crc, buf + i, BENCH_BUF_LEN - i);
+        CHECK(crc == crc16_reference(buf, BENCH_BUF_LEN));
+    }
+
+    data_comm_init();
+    ref = bench_bulk(1, buf, BENCH_BUF_LEN);
+    eng = bench_bulk(0, buf, BENCH_BUF_LEN);
+    bench_parse(&parse_avg, &parse_worst);
+
+    printf("CRC16_METHOD = %s\n", method_name[CRC16_METHOD]);
+    printf("  bulk  bitwise reference   : %6.2f %s/byte\n", ref, BENCH_UNIT);
+    printf("  bulk  data_comm_crc16     : %6.2f %s/byte (x%.1f)\n", eng, BENCH_UNIT, ref / eng);
+    printf("  parse data_comm_parse_byte: %6.2f %s/byte, slowest byte position %.2f %s\n",
+           parse_avg, BENCH_UNIT, parse_worst, BENCH_UNIT);
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+  ******************************************************************************
+  * @file    dispatch_bench.c
+  * @brief   命令分发表（常量表 + 运行时注册）正确性和性能测试
+  * @note    需以DATA_COMM_CMD_REGISTER_MAX>0编译
+  *          1. 常量表按命令分发，载荷长度超出范围时不调用处理函数并累加cmd_len_err
+  *          2. 运行时注册优先于常量表（含长度范围），重复注册覆盖，注销后回落到常量表
+  *          3. 注册表已满时返回-1，注销后空出的项可再次注册
+  *          4. 不在分发表中的命令交给packet_handler，没有packet_handler时累加cmd_unknown
+  *          5. 对比常量表、运行时注册与packet_handler中switch分发的耗时
+  *          dispatch_bench [--quick]    --quick减少循环次数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#if DATA_COMM_CMD_REGISTER_MAX < 2
+#error "dispatch_bench requires DATA_COMM_CMD_REGISTER_MAX >= 2"
+#endif
+
+#define CMD_CONST     0x10    // 常量表中的命令
+#define CMD_OTHER     0x11    // 常量表中的另一命令
+#define CMD_UNKNOWN   0x7E    // 不在任何分发表中的命令
+
+static uint8_t g_frame[DATA_COMM_FRAME_SIZE];
+static uint16_t g_frame_len;
+static int g_last;            // 最后一次调用的处理函数编号（0表示未调用）
+static uint16_t g_last_len;
+static volatile uint32_t g_sink;
+
+/* ========================= 测试用回调 ========================= */
+static void bench_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    memcpy(g_frame, data, len);
+    g_frame_len = len;
+}
+
+static void on_const(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)cmd;
+    (void)data;
+    g_last = 1;
+    g_last_len = len;
+}
+
+static void on_runtime(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)cmd;
+    (void)data;
+    g_last = 2;
+    g_last_len = len;
+}
+
+static void on_overwrite(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)cmd;
+    (void)data;
+    g_last = 3;
+    g_last_len = len;
+}
+
+static void on_packet(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)data;
+    g_last = 4;
+    g_last_len = len;
+    g_sink += cmd;
+}
+
+static void on_fast(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)cmd;
+    g_sink += data[0] + len;
+}
+
+/* 对照：所有命令交给packet_handler，在其中用switch分发 */
+static void on_switch(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    switch (cmd) {
+    case CMD_CONST:
+        if (len >= 2 && len <= 4) {
+            on_fast(handle, cmd, data, len);
+        }
+        break;
+    case CMD_OTHER:
+        on_fast(handle, cmd, data, len);
+        break;
+    default:
+        break;
+    }
+}
+
+static const DataCommCmdEntry g_table[256] = {
+    DATA_COMM_CMD(CMD_CONST, on_const, 2, 4),
+    DATA_COMM_CMD(CMD_OTHER, on_const, 0, 8),
+};
+
+static const DataCommCmdEntry g_fast_table[256] = {
+    DATA_COMM_CMD(CMD_CONST, on_fast, 2, 4),
+    DATA_COMM_CMD(CMD_OTHER, on_fast, 0, 8),
+};
+
+/**
+  * @brief  发送一帧给rx，返回被调用的处理函数编号
+  */
+static int deliver(DataCommHandle *tx, DataCommHandle *rx, uint8_t cmd, uint16_t len)
+{
+    static uint8_t payload[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    g_last = 0;
+    g_last_len = 0;
+    data_comm_send_ex(tx, cmd, payload, len);
+    data_comm_parse_buffer_ex(rx, g_frame, g_frame_len);
+    return g_last;
+}
+
+static void check_const_table(DataCommHandle *tx, DataCommHandle *rx)
+{
+    CHECK(deliver(tx, rx, CMD_CONST, 3) == 1 && g_last_len == 3);
+    CHECK(deliver(tx, rx, CMD_CONST, 1) == 0);
+    CHECK(deliver(tx, rx, CMD_CONST, 5) == 0);
+    CHECK(data_comm_cmd_len_err(rx) == 2);
+}
+
+static void check_register(DataCommHandle *tx, DataCommHandle *rx)
+{
+    uint32_t len_err = data_comm_cmd_len_err(rx);
+
+    /* 运行时注册优先于常量表，长度范围也以注册项为准 */
+    CHECK(data_comm_register(rx, CMD_CONST, on_runtime, 1, 1) == 0);
+    CHECK(deliver(tx, rx, CMD_CONST, 1) == 2);
+    CHECK(deliver(tx, rx, CMD_CONST, 3) == 0);
+    CHECK(data_comm_cmd_len_err(rx) == len_err + 1);
+
+    /* 覆盖：同一命令不占用新的注册项 */
+    CHECK(data_comm_register(rx, CMD_CONST, on_overwrite, 0, 8) == 0);
+    CHECK(deliver(tx, rx, CMD_CONST, 6) == 3 && g_last_len == 6);
+
+    /* 注销后回落到常量表；注销未注册的命令无影响 */
+    CHECK(data_comm_register(rx, CMD_CONST, NULL, 0, 0) == 0);
+    CHECK(data_comm_register(rx, CMD_UNKNOWN, NULL, 0, 0) == 0);
+    CHECK(deliver(tx, rx, CMD_CONST, 3) == 1);
+}
+
+static void check_table_full(DataCommHandle *tx, DataCommHandle *rx)
+{
+    uint16_t i;
+
+    for (i = 0; i < DATA_COMM_CMD_REGISTER_MAX; i++) {
+        CHECK(data_comm_register(rx, (uint8_t)(0x40 + i), on_runtime, 0, 8) == 0);
+    }
+    CHECK(data_comm_register(rx, 0x40 + DATA_COMM_CMD_REGISTER_MAX, on_runtime, 0, 8) == -1);
+    CHECK(data_comm_register(rx, 0x40, on_overwrite, 0, 8) == 0);
+    CHECK(deliver(tx, rx, 0x40 + DATA_COMM_CMD_REGISTER_MAX, 1) == 0);
+
+    /* 注销一项后空出的位置可再次注册 */
+    CHECK(data_comm_register(rx, 0x41, NULL, 0, 0) == 0);
+    CHECK(data_comm_register(rx, 0x40 + DATA_COMM_CMD_REGISTER_MAX, on_runtime, 0, 8) == 0);
+    CHECK(deliver(tx, rx, 0x40 + DATA_COMM_CMD_REGISTER_MAX, 1) == 2);
+    CHECK(deliver(tx, rx, 0x40, 1) == 3);
+    CHECK(deliver(tx, rx, 0x41, 1) == 0);
+
+    for (i = 0; i <= DATA_COMM_CMD_REGISTER_MAX; i++) {
+        data_comm_register(rx, (uint8_t)(0x40 + i), NULL, 0, 0);
+    }
+}
+
+static void check_unknown(DataCommHandle *tx, DataCommHandle *rx)
+{
+    uint32_t unknown = data_comm_cmd_unknown(rx);
+
+    /* 没有packet_handler：丢弃并计数 */
+    CHECK(deliver(tx, rx, CMD_UNKNOWN, 2) == 0);
+    CHECK(data_comm_cmd_unknown(rx) == unknown + 1);
+
+    /* 有packet_handler：交给它，不计数；长度错误不交给packet_handler */
+    rx->config.packet_handler = on_packet;
+    CHECK(deliver(tx, rx, CMD_UNKNOWN, 2) == 4);
+    CHECK(deliver(tx, rx, CMD_CONST, 7) == 0);
+    CHECK(data_comm_cmd_unknown(rx) == unknown + 1);
+    rx->config.packet_handler = NULL;
+}
+
+/**
+  * @brief  对同一组帧循环解析，返回每帧平均耗时
+  */
+static double time_dispatch(DataCommHandle *rx, const uint8_t *frames, uint16_t frame_len, uint32_t rounds)
+{
+    uint64_t t;
+    uint32_t n;
+
+    t = bench_now();
+    for (n = 0; n < rounds; n++) {
+        data_comm_parse_buffer_ex(rx, &frames[(n & 1) * frame_len], frame_len);
+    }
+    return (double)(bench_now() - t) / rounds;
+}
+
+static void bench(uint32_t rounds, DataCommHandle *tx)
+{
+    static uint8_t payload[4] = {1, 2, 3, 4};
+    DataCommHandle rx;
+    DataCommConfig config;
+    uint8_t frames[2 * DATA_COMM_FRAME_SIZE];
+    uint16_t frame_len;
+
+    /* 两条命令各一帧，帧长相同 */
+    data_comm_send_ex(tx, CMD_CONST, payload, 4);
+    frame_len = g_frame_len;
+    memcpy(frames, g_frame, frame_len);
+    data_comm_send_ex(tx, CMD_OTHER, payload, 4);
+    memcpy(&frames[frame_len], g_frame, frame_len);
+
+    memset(&config, 0, sizeof(config));
+    config.cmd_table = g_fast_table;
+    data_comm_init_ex(&rx, &config);
+    printf("  const table          : %6.2f %s/frame\n", time_dispatch(&rx, frames, frame_len, rounds), BENCH_UNIT);
+
+    memset(&config, 0, sizeof(config));
+    data_comm_init_ex(&rx, &config);
+    data_comm_register(&rx, CMD_CONST, on_fast, 2, 4);
+    data_comm_register(&rx, CMD_OTHER, on_fast, 0, 8);
+    printf("  runtime registered   : %6.2f %s/frame\n", time_dispatch(&rx, frames, frame_len, rounds), BENCH_UNIT);
+
+    memset(&config, 0, sizeof(config));
+    config.packet_handler = on_switch;
+    data_comm_init_ex(&rx, &config);
+    printf("  packet_handler switch: %6.2f %s/frame\n", time_dispatch(&rx, frames, frame_len, rounds), BENCH_UNIT);
+}
+
+int main(int argc, char **argv)
+{
+    DataCommHandle tx, rx;
+    DataCommConfig config;
+    uint32_t rounds = 2000000;
+
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        rounds = 20000;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.transmit = bench_transmit;
+    data_comm_init_ex(&tx, &config);
+    memset(&config, 0, sizeof(config));
+    config.cmd_table = g_table;
+    data_comm_init_ex(&rx, &config);
+
+    check_const_table(&tx, &rx);
+    check_register(&tx, &rx);
+    check_table_full(&tx, &rx);
+    check_unknown(&tx, &rx);
+    printf("command dispatch (%d runtime entries): OK\n", DATA_COMM_CMD_REGISTER_MAX);
+    bench(rounds, &tx);
+
+    return 0;
+}
@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    prio_bench.c
+  * @brief   发送优先级主机端仿真测试
+  * @note    模拟DMA串口逐字节发出队列中的帧（每个时间单位1字节），另一实例逐字节解析。
+  *          低优先级持续写满长遥测帧，随机时刻发送短控制命令，统计控制命令从请求发送
+  *          到开始上线的排队时延：
+  *            fifo  - 控制命令与遥测帧同一队列（data_comm_send_ex）
+  *            prio  - 控制命令使用最高优先级（data_comm_send_prio）
+  *            rate  - 同prio，遥测帧限速为线路速率的一半
+  *          检查时延上限、各级统计计数、限速效果以及接收端按序收到每一帧
+  *          prio_bench [--quick]    --quick减少控制命令数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================= 测试参数 ========================= */
+#define BENCH_TICK        92          // 每个data_comm_tick()时间单位（1ms）的字节时间数（921600bps，8N1）
+#define BENCH_BULK_CMD    0x20        // 遥测帧命令
+#define BENCH_BULK_LEN    240         // 遥测帧载荷长度
+#define BENCH_CTRL_CMD    0x01        // 控制命令
+#define BENCH_CTRL_LEN    8           // 控制命令载荷长度
+#define BENCH_BULK_FRAME  (BENCH_BULK_LEN + DATA_COMM_FRAME_OVERHEAD)
+#define BENCH_PRIO_CTRL   0
+#define BENCH_PRIO_BULK   (DATA_COMM_TX_PRIO - 1)
+
+typedef enum {
+    MODE_FIFO,
+    MODE_PRIO,
+    MODE_RATE
+} BenchMode;
+
+static const char *const mode_names[] = {"fifo", "prio", "rate"};
+
+static DataCommHandle g_tx, g_rx;
+static uint32_t g_now;                        // 当前时间（字节时间）
+static uint8_t *g_wire;                       // 正在发送的帧
+static uint16_t g_wire_len, g_wire_pos;
+static uint32_t g_ctrl_start;                 // 最近一条控制命令开始上线的时间
+static uint8_t g_ctrl_started;                // 控制命令已开始上线
+static uint32_t g_tx_seq[2], g_rx_seq[2];     // [0]控制命令，[1]遥测帧：已入队/已收到的序号
+static uint32_t g_bulk_wire_bytes;            // 已上线的遥测帧字节数
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+/* 覆盖库中的弱定义：排队时延以字节时间为单位 */
+uint32_t user_tx_time(void)
+{
+    return g_now;
+}
+
+static void sim_transmit_async(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    CHECK(g_wire == NULL);
+    g_wire = data;
+    g_wire_len = len;
+    g_wire_pos = 0;
+    if (data[4] == BENCH_CTRL_CMD) {
+        g_ctrl_start = g_now;
+        g_ctrl_started = 1;
+    } else {
+        g_bulk_wire_bytes += len;
+    }
+}
+
+static void sim_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)data;
+    (void)len;
+}
+
+/**
+  * @brief  接收端：每种命令的序号必须连续
+  */
+static void rx_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint32_t seq;
+    int k = (cmd == BENCH_CTRL_CMD) ? 0 : 1;
+    
+    (void)handle;
+    CHECK(len == (k == 0 ? BENCH_CTRL_LEN : BENCH_BULK_LEN));
+    seq = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    CHECK(seq == g_rx_seq[k]);
+    g_rx_seq[k]++;
+}
+
+/**
+  * @brief  推进一个字节时间：线路发出一个字节，帧发完时调用发送完成中断
+  */
+static void sim_step(void)
+{
+    g_now++;
+    if (g_wire != NULL) {
+        data_comm_parse_byte_ex(&g_rx, g_wire[g_wire_pos++]);
+        if (g_wire_pos == g_wire_len) {
+            g_wire = NULL;
+            data_comm_tx_complete_isr(&g_tx);
+        }
+    }
+    if (g_now % BENCH_TICK == 0) {
+        data_comm_tick(&g_tx, g_now / BENCH_TICK);
+    }
+}
+
+static uint16_t send_msg(BenchMode mode, int k)
+{
+    uint8_t payload[BENCH_BULK_LEN];
+    uint16_t len = (k == 0) ? BENCH_CTRL_LEN : BENCH_BULK_LEN;
+    uint8_t cmd = (k == 0) ? BENCH_CTRL_CMD : BENCH_BULK_CMD;
+    uint16_t ret;
+    
+    memset(payload, 0x5A, len);
+    payload[0] = (uint8_t)(g_tx_seq[k] >> 24);
+    payload[1] = (uint8_t)(g_tx_seq[k] >> 16);
+    payload[2] = (uint8_t)(g_tx_seq[k] >> 8);
+    payload[3] = (uint8_t)g_tx_seq[k];
+    if (k == 0 && mode != MODE_FIFO) {
+        ret = data_comm_send_prio(&g_tx, BENCH_PRIO_CTRL, cmd, payload, len);
+    } else {
+        ret = data_comm_send_ex(&g_tx, cmd, payload, len);
+    }
+    if (ret != 0) {
+        g_tx_seq[k]++;
+    }
+    return ret;
+}
+
+/**
+  * @brief  运行一种模式
+  * @param  ctrl_count : 控制命令数
+  * @retval 控制命令最大排队时延（字节时间）
+  */
+static uint32_t run_mode(BenchMode mode, uint32_t ctrl_count)
+{
+    DataCommConfig tx_config = {sim_transmit, NULL, NULL, sim_transmit_async, NULL, NULL};
+    DataCommConfig rx_config = {NULL, rx_handler, NULL, NULL, NULL, NULL};
+    DataCommTxClassStats ctrl_stats, bulk_stats;
+    uint32_t sent = 0, request = 0, next_ctrl, latency, lat_max = 0, start_time;
+    uint64_t lat_total = 0;
+    uint8_t pending = 0, waiting = 0;
+    double bulk_rate;
+    
+    data_comm_init_ex(&g_tx, &tx_config);
+    data_comm_init_ex(&g_rx, &rx_config);
+    g_now = 0;
+    g_wire = NULL;
+    g_bulk_wire_bytes = 0;
+    memset(g_tx_seq, 0, sizeof(g_tx_seq));
+    memset(g_rx_seq, 0, sizeof(g_rx_seq));
+    if (mode == MODE_RATE) {
+        data_comm_set_tx_rate(&g_tx, BENCH_PRIO_BULK, BENCH_TICK / 2, 2 * BENCH_BULK_FRAME);
+    }
+    data_comm_tick(&g_tx, 0);
+    
+    next_ctrl = 1000;
+    start_time = g_now;
+    while (sent < ctrl_count) {
+        /* 控制命令：随机时刻请求，队列满时每个字节时间重试（先于遥测帧争用空闲帧槽） */
+        if (!pending && !waiting && g_now >= next_ctrl) {
+            pending = 1;
+            request = g_now;
+            g_ctrl_started = 0;
+        }
+        if (pending && send_msg(mode, 0) != 0) {
+            pending = 0;
+            waiting = 1;
+        }
+        
+        /* 遥测帧写满队列（或用尽令牌），data_comm_tx_free()须与发送结果一致 */
+        while (data_comm_tx_free(&g_tx) > 0) {
+            CHECK(send_msg(mode, 1) != 0);
+        }
+        CHECK(send_msg(mode, 1) == 0);
+        
+        /* 开始上线后记录时延 */
+        if (waiting && g_ctrl_started) {
+            waiting = 0;
+            latency = g_ctrl_start - request;
+            lat_total += latency;
+            if (latency > lat_max) {
+                lat_max = latency;
+            }
+            sent++;
+            next_ctrl = g_now + 500 + bench_rand() % 2500;
+        }
+        sim_step();
+    }
+    
+    /* 排空队列，接收端须按序收到全部帧 */
+    while (g_wire != NULL) {
+        sim_step();
+    }
+    CHECK(g_rx_seq[0] == g_tx_seq[0] && g_rx_seq[1] == g_tx_seq[1]);
+    
+    bulk_rate = (double)g_bulk_wire_bytes / (double)(g_now - start_time);
+    printf("%-5s  ctrl %6u  latency max %5u avg %7.1f bytes (max %.2f ms)  bulk %5.1f%% of line\n",
+           mode_names[mode], sent, lat_max, (double)lat_total / sent, (double)lat_max / BENCH_TICK,
+           bulk_rate * 100.0);
+    
+    data_comm_get_tx_class_stats(&g_tx, BENCH_PRIO_CTRL, &ctrl_stats);
+    data_comm_get_tx_class_stats(&g_tx, BENCH_PRIO_BULK, &bulk_stats);
+    if (mode == MODE_FIFO) {
+        CHECK(ctrl_stats.frames == 0);
+        CHECK(bulk_stats.frames == g_tx_seq[0] + g_tx_seq[1]);
+    } else {
+        /* 控制命令总能立即入队，库统计的排队时延与仿真测得的一致 */
+        CHECK(ctrl_stats.frames == sent);
+        CHECK(ctrl_stats.queue_full == 0 && ctrl_stats.rate_limited == 0);
+        CHECK(ctrl_stats.latency_max == lat_max && ctrl_stats.latency_total == lat_total);
+        CHECK(bulk_stats.frames == g_tx_seq[1]);
+        /* 最坏情况：正好有一帧遥测帧开始上线 */
+        CHECK(lat_max <= BENCH_BULK_FRAME);
+        printf("       stats  ctrl frames %u latency max %u | bulk frames %u hwm %u queue_full %u "
+               "rate_limited %u latency max %u\n",
+               ctrl_stats.frames, ctrl_stats.latency_max, bulk_stats.frames, bulk_stats.queue_hwm,
+               bulk_stats.queue_full, bulk_stats.rate_limited, bulk_stats.latency_max);
+    }
+    if (mode == MODE_RATE) {
+        /* 长期速率不超过限速，突发不超过令牌桶加一帧 */
+        CHECK(g_bulk_wire_bytes <= (g_now - start_time) / 2 + 3 * BENCH_BULK_FRAME);
+        CHECK(bulk_rate > 0.45);
+        CHECK(bulk_stats.rate_limited > 0);
+    } else {
+        CHECK(bulk_rate > 0.9);
+    }
+    return lat_max;
+}
+
+/**
+  * @brief  入队+调度耗时：控制命令入队后立即完成发送
+  */
+static void bench_overhead(uint32_t count)
+{
+    DataCommConfig config = {sim_transmit, NULL, NULL, sim_transmit_async, NULL, NULL};
+    uint8_t payload[BENCH_CTRL_LEN] = {0};
+    uint64_t t0, t1;
+    uint32_t i;
+    
+    data_comm_init_ex(&g_tx, &config);
+    t0 = bench_now();
+    for (i = 0; i < count; i++) {
+        data_comm_send_prio(&g_tx, (uint8_t)(i % DATA_COMM_TX_PRIO), BENCH_CTRL_CMD, payload, sizeof(payload));
+        g_wire = NULL;
+        data_comm_tx_complete_isr(&g_tx);
+    }
+    t1 = bench_now();
+    printf("send_prio + tx_complete_isr: %.1f %s/frame\n", (double)(t1 - t0) / count, BENCH_UNIT);
+}
+
+int main(int argc, char **argv)
+{
+    int quick = (argc > 1 && strcmp(argv[1], "--quick") == 0);
+    uint32_t ctrl_count = quick ? 200 : 5000;
+    uint32_t fifo_max, prio_max;
+    
+    printf("prio_bench: %d classes, %d slots each, bulk frame %d bytes, ctrl frame %d bytes\n",
+           DATA_COMM_TX_PRIO, DATA_COMM_TX_QUEUE_SIZE, BENCH_BULK_FRAME,
+           BENCH_CTRL_LEN + DATA_COMM_FRAME_OVERHEAD);
+    fifo_max = run_mode(MODE_FIFO, ctrl_count);
+    prio_max = run_mode(MODE_PRIO, ctrl_count);
+    (void)run_mode(MODE_RATE, ctrl_count);
+    CHECK(prio_max < fifo_max);
+    bench_overhead(quick ? 100000 : 10000000);
+    printf("OK\n");
+    return 0;
+}
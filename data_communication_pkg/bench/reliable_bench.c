@@ -0,0 +1,264 @@
+/**
+  ******************************************************************************
+  * @file    reliable_bench.c
+  * @brief   可靠传输主机端仿真测试
+  * @note    两个协议实例通过模拟全双工串口连接，每个时间单位（1ms）每个方向传输
+  *          BENCH_LINE_RATE字节，并按误码率随机翻转比特。实例A可靠发送一批消息，
+  *          检查实例B是否每条消息恰好收到一次，并输出有效吞吐率占线路速率的比例；
+  *          随后在发送中途复位实例A（会话号与复位前相同/不同），检查复位后发送的
+  *          消息全部送达且没有重复交付；复位点还在序号回绕后的256k+1..256k+窗口大小之间
+  *          逐一扫描，此时复位后的新序号正好落在接收端旧的接收窗口内
+  *          reliable_bench [--quick]    --quick减少消息数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================= 测试参数 ========================= */
+#define BENCH_LINE_RATE   92          // 每ms每方向传输的字节数（921600bps，8N1）
+#define BENCH_MSG_LEN     64          // 每条消息载荷长度（前4字节为消息编号）
+#define BENCH_FIFO_SIZE   (1u << 20)  // 模拟线路缓冲区
+
+static const double bit_error_rates[] = {0, 1e-5, 1e-4, 1e-3};
+
+#define ARRAY_SIZE(a)  (sizeof(a) / sizeof((a)[0]))
+
+/**
+  * @brief  模拟单向线路：发送端写入，按线路速率送达接收端
+  */
+typedef struct {
+    uint8_t *buf;
+    size_t head;
+    size_t tail;
+} SimLink;
+
+static SimLink g_a_to_b, g_b_to_a;
+static DataCommHandle g_a, g_b;
+static uint8_t *g_received;
+static uint32_t g_delivered, g_duplicates, g_lost;
+static double g_ber;
+static uint8_t g_session;           // user_rel_session()的返回值，模拟每次上电的会话号
+static uint64_t g_rand = 88172645463325252ull;
+
+static uint64_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 7;
+    g_rand ^= g_rand << 17;
+    return g_rand;
+}
+
+static void link_write(SimLink *link, const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+    
+    for (i = 0; i < len; i++) {
+        link->buf[link->tail++ % BENCH_FIFO_SIZE] = data[i];
+    }
+}
+
+/**
+  * @brief  送达一个时间单位内的字节，按误码率翻转比特
+  */
+static void link_deliver(SimLink *link, DataCommHandle *rx)
+{
+    uint8_t chunk[BENCH_LINE_RATE];
+    uint16_t n = 0, bit;
+    
+    while (n < BENCH_LINE_RATE && link->head != link->tail) {
+        chunk[n++] = link->buf[link->head++ % BENCH_FIFO_SIZE];
+    }
+    if (g_ber > 0) {
+        for (bit = 0; bit < n * 8; bit++) {
+            if ((double)(bench_rand() >> 11) / 9007199254740992.0 < g_ber) {
+                chunk[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            }
+        }
+    }
+    data_comm_parse_buffer_ex(rx, chunk, n);
+}
+
+/**
+  * @brief  可靠传输会话号（库中没有默认定义）
+  */
+uint8_t user_rel_session(void)
+{
+    return g_session;
+}
+
+static void a_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    link_write(&g_a_to_b, data, len);
+}
+
+static void b_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    link_write(&g_b_to_a, data, len);
+}
+
+static void b_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint32_t id;
+    
+    (void)handle;
+    if (cmd != 0x10 || len != BENCH_MSG_LEN) {
+        return;
+    }
+    id = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    if (g_received[id]) {
+        g_duplicates++;
+    } else {
+        g_received[id] = 1;
+        g_delivered++;
+    }
+}
+
+/**
+  * @brief  运行一次传输
+  * @param  messages   : 消息数
+  * @param  restart    : 0-不复位，1-复位实例A且会话号不变，2-复位后会话号改变
+  * @param  restart_at : 已发送多少条消息时复位（restart为0时忽略）
+  * @retval 0-成功（不复位时全部恰好送达一次；复位时复位后发送的消息全部送达、无重复，
+  *         且接收端恰好在首次通信和复位后各重新开始一次接收窗口），1-失败
+  * @note   复位时复位前窗口中丢失的消息数保存在g_lost
+  */
+static int run(uint32_t messages, int restart, uint32_t restart_at)
+{
+    DataCommConfig config_a, config_b;
+    uint8_t msg[BENCH_MSG_LEN];
+    uint32_t next = 0, now, limit = messages * 50 + 1000;
+    uint32_t first_new = restart_at, i;
+    
+    memset(&config_a, 0, sizeof(config_a));
+    memset(&config_b, 0, sizeof(config_b));
+    config_a.transmit = a_transmit;
+    config_b.transmit = b_transmit;
+    config_b.packet_handler = b_packet_handler;
+    data_comm_init_ex(&g_a, &config_a);
+    data_comm_init_ex(&g_b, &config_b);
+    g_a_to_b.head = g_a_to_b.tail = 0;
+    g_b_to_a.head = g_b_to_a.tail = 0;
+    memset(g_received, 0, messages);
+    g_delivered = 0;
+    g_duplicates = 0;
+    g_lost = 0;
+    memset(msg, 0x5A, sizeof(msg));
+    g_session = 0x37;
+    if (!restart) {
+        restart_at = messages + 1;
+    }
+    
+    for (now = 1; now < limit; now++) {
+        /* 复位：窗口中未确认的消息随之丢失，线路上已发出的字节照常送达 */
+        if (next == restart_at) {
+            restart_at = messages + 1;
+            if (restart == 2) {
+                g_session++;
+            }
+            data_comm_init_ex(&g_a, &config_a);
+        }
+        data_comm_tick(&g_a, now);
+        data_comm_tick(&g_b, now);
+        
+        /* 线路空闲时才填充窗口，模拟阻塞式串口发送 */
+        while (next < messages && next != restart_at && g_a_to_b.tail - g_a_to_b.head < BENCH_LINE_RATE) {
+            msg[0] = (uint8_t)(next >> 24);
+            msg[1] = (uint8_t)(next >> 16);
+            msg[2] = (uint8_t)(next >> 8);
+            msg[3] = (uint8_t)next;
+            if (data_comm_rel_send(&g_a, 0x10, msg, BENCH_MSG_LEN) != 0) {
+                break;
+            }
+            next++;
+        }
+        
+        link_deliver(&g_a_to_b, &g_b);
+        link_deliver(&g_b_to_a, &g_a);
+        
+        if (next == messages && data_comm_rel_pending(&g_a) == 0) {
+            break;
+        }
+    }
+    
+    if (restart) {
+        /* 复位时窗口中的消息可能丢失，复位后发送的消息必须全部送达 */
+        for (i = 0; i < first_new; i++) {
+            g_lost += !g_received[i];
+        }
+        for (i = first_new; i < messages && g_received[i]; i++) {
+        }
+        return (i == messages && g_duplicates == 0 && data_comm_rel_resyncs(&g_b) == 2) ? 0 : 1;
+    }
+    printf("%7.0e  %8u  %10u  %11u  %10u  %7.1f%%\n",
+           g_ber, messages, g_delivered, g_duplicates, data_comm_rel_retransmits(&g_a),
+           100.0 * g_delivered * BENCH_MSG_LEN / ((double)now * BENCH_LINE_RATE));
+    return (g_delivered == messages && g_duplicates == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t messages = 20000, lost;
+    unsigned bi, k, r;
+    int restart, err;
+    
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        messages = 2000;
+    }
+    g_a_to_b.buf = malloc(BENCH_FIFO_SIZE);
+    g_b_to_a.buf = malloc(BENCH_FIFO_SIZE);
+    g_received = malloc(messages > 1024 ? messages : 1024);
+    if (g_a_to_b.buf == NULL || g_b_to_a.buf == NULL || g_received == NULL) {
+        return 1;
+    }
+    
+    printf("DATA_COMM_REL_WINDOW=%u RTO=%u, %u-byte messages, line %u bytes/ms\n",
+           (unsigned)DATA_COMM_REL_WINDOW, (unsigned)DATA_COMM_REL_RTO,
+           (unsigned)BENCH_MSG_LEN, (unsigned)BENCH_LINE_RATE);
+    printf("    BER  messages   delivered   duplicates  retransmit  goodput/line\n");
+    for (bi = 0; bi < ARRAY_SIZE(bit_error_rates); bi++) {
+        g_ber = bit_error_rates[bi];
+        CHECK(run(messages, 0, 0) == 0);
+    }
+    
+    printf("sender restarted after %u messages\n", messages / 2);
+    printf("    BER  session    delivered   duplicates  lost/restart\n");
+    for (bi = 0; bi < ARRAY_SIZE(bit_error_rates); bi++) {
+        g_ber = bit_error_rates[bi];
+        for (restart = 1; restart <= 2; restart++) {
+            err = run(messages, restart, messages / 2);
+            printf("%7.0e  %-8s  %10u  %11u  %12u\n",
+                   g_ber, restart == 1 ? "same" : "changed", g_delivered, g_duplicates, g_lost);
+            CHECK(err == 0);
+        }
+    }
+    
+    /* 复位点扫描：复位后从序号0重新开始，正好落在接收端旧窗口内 */
+    printf("sender restarted after 256k+1..256k+%u messages\n", (unsigned)DATA_COMM_REL_WINDOW);
+    printf("    BER  session      k  runs  lost/restart\n");
+    for (bi = 0; bi < ARRAY_SIZE(bit_error_rates); bi++) {
+        g_ber = bit_error_rates[bi];
+        for (restart = 1; restart <= 2; restart++) {
+            for (k = 1; k <= 2; k++) {
+                lost = 0;
+                for (r = 1; r <= DATA_COMM_REL_WINDOW; r++) {
+                    CHECK(run(256 * k + DATA_COMM_REL_WINDOW + 64, restart, 256 * k + r) == 0);
+                    lost += g_lost;
+                }
+                printf("%7.0e  %-8s  %3u  %4u  %12u\n", g_ber, restart == 1 ? "same" : "changed",
+                       k, (unsigned)DATA_COMM_REL_WINDOW, lost);
+            }
+        }
+    }
+    
+    free(g_a_to_b.buf);
+    free(g_b_to_a.buf);
+    free(g_received);
+    return 0;
+}
@@ -0,0 +1,348 @@
+/**
+  ******************************************************************************
+  * @file    stream_bench.c
+  * @brief   流式接收和分片发送正确性及性能测试
+  * @note    需以DATA_COMM_STREAM=1、DATA_COMM_FRAG=1编译
+  *          1. 普通帧与超过MAX_DATA_LENGTH的流式帧混合（含损坏帧），分别逐字节和随机分块批量解析：
+  *             普通帧照常交付，流式帧内容一致，损坏的流式帧以end(0)结束
+  *          2. 10KB数据块经data_comm_blob_send()分片发送后在接收端按序重组，内容一致；
+  *             丢失一个分片时该数据块被中止并计入data_comm_blob_errors()，下一个数据块不受影响
+  *          3. 对比流式接收大帧与缓存接收同样数据量的普通帧的批量解析耗时
+  *          stream_bench [--quick]    --quick减少帧数，用于ctest
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !DATA_COMM_STREAM || !DATA_COMM_FRAG || !USE_CRC16
+#error "stream_bench需要DATA_COMM_STREAM=1、DATA_COMM_FRAG=1且USE_CRC16=1"
+#endif
+
+#define BIG_CMD       0x80    // 命令>=BIG_CMD的帧流式接收
+#define BLOB_CMD      0x40    // 分片数据块的命令
+#define BIG_LEN       4000    // 流式帧载荷长度
+#define BLOB_LEN      10240   // 分片数据块长度
+#define BENCH_CHUNK   256     // 性能测试的批量解析块长
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static uint32_t g_drop_frame;             // 发送端丢弃第几个帧（0表示不丢）
+static uint32_t g_tx_frames;
+
+/* 接收端记录 */
+static uint32_t g_packets, g_packet_hash;
+static uint32_t g_stream_ok, g_stream_fail, g_stream_hash;
+static uint8_t g_blob[BLOB_LEN];
+static uint32_t g_blob_len, g_blob_total;
+static uint8_t g_open;
+
+/* ========================= 测试用回调 ========================= */
+static uint32_t fnv(uint32_t hash, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        hash = (hash ^ *data++) * 16777619u;
+    }
+    return hash;
+}
+
+static void bench_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    if (++g_tx_frames == g_drop_frame) {
+        return;
+    }
+    memcpy(g_stream + g_stream_len, data, len);
+    g_stream_len += len;
+}
+
+static void bench_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    g_packets++;
+    g_packet_hash = fnv(fnv(g_packet_hash, &cmd, 1), data, len);
+}
+
+static uint8_t on_begin(DataCommHandle *handle, uint8_t cmd, uint32_t total)
+{
+    (void)handle;
+    if (cmd != BLOB_CMD && cmd < BIG_CMD) {
+        return 0;
+    }
+    CHECK(!g_open);     /* begin之后必须先end */
+    g_open = 1;
+    g_blob_len = 0;
+    g_blob_total = total;
+    g_stream_hash = fnv(g_stream_hash, &cmd, 1);
+    return 1;
+}
+
+static void on_chunk(DataCommHandle *handle, const uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    if (g_blob_len + len <= sizeof(g_blob)) {
+        memcpy(&g_blob[g_blob_len], data, len);
+    }
+    g_blob_len += len;
+    g_stream_hash = fnv(g_stream_hash, data, len);
+}
+
+static void on_end(DataCommHandle *handle, uint8_t ok)
+{
+    (void)handle;
+    g_open = 0;
+    if (ok && g_blob_len == g_blob_total) {
+        g_stream_ok++;
+    } else {
+        g_stream_fail++;
+    }
+}
+
+static const DataCommStreamOps g_ops = {on_begin, on_chunk, on_end};
+
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+/**
+  * @brief  按帧格式直接生成一个流式大帧（发送API只发送MAX_DATA_LENGTH以内的帧）
+  */
+static void put_big_frame(uint8_t cmd, const uint8_t *data, uint16_t len, uint8_t corrupt)
+{
+    uint8_t *p = g_stream + g_stream_len;
+    uint16_t crc;
+
+    p[0] = (uint8_t)(FRAME_HEADER >> 8);
+    p[1] = (uint8_t)FRAME_HEADER;
+    p[2] = (uint8_t)((len + 1) >> 8);
+    p[3] = (uint8_t)(len + 1);
+    p[4] = cmd;
+    memcpy(&p[5], data, len);
+    crc = data_comm_crc16(CRC16_INIT, &p[2], (uint16_t)(len + 3));
+    if (corrupt) {
+        p[5 + bench_rand() % len] ^= 0x10;     /* 只改载荷，帧结构不变，由CRC检出 */
+    }
+    p += 5 + len;
+    *p++ = (uint8_t)(crc >> 8);
+    *p++ = (uint8_t)crc;
+    *p++ = (uint8_t)(FRAME_END >> 8);
+    *p++ = (uint8_t)FRAME_END;
+    g_stream_len = (size_t)(p - g_stream);
+}
+
+/**
+  * @brief  生成普通帧与流式大帧的混合数据流，返回期望的普通帧/流式帧结果
+  */
+static void make_mixed(DataCommHandle *tx, uint32_t frames, uint32_t *packets, uint32_t *packet_hash,
+                       uint32_t *big_ok, uint32_t *big_fail, uint32_t *big_hash)
+{
+    static uint8_t payload[BIG_LEN];
+    uint32_t f;
+    uint16_t len, i;
+    uint8_t cmd, corrupt;
+
+    g_stream_len = 0;
+    *packets = 0;
+    *packet_hash = 2166136261u;
+    *big_ok = 0;
+    *big_fail = 0;
+    *big_hash = 2166136261u;
+    for (f = 0; f < frames; f++) {
+        if (bench_rand() % 4 == 0) {
+            len = (uint16_t)(MAX_DATA_LENGTH + 1 + bench_rand() % (BIG_LEN - MAX_DATA_LENGTH));
+            for (i = 0; i < len; i++) {
+                payload[i] = (uint8_t)bench_rand();
+            }
+            cmd = (uint8_t)(BIG_CMD | bench_rand());
+            if (cmd == DATA_COMM_FRAG_CMD) {
+                cmd++;      /* 分片命令总是缓存接收 */
+            }
+            corrupt = (bench_rand() % 8 == 0);
+            put_big_frame(cmd, payload, len, corrupt);
+            *big_hash = fnv(*big_hash, &cmd, 1);
+            if (corrupt) {
+                (*big_fail)++;     /* 损坏帧的已交付部分内容不确定，只核对结果计数 */
+            } else {
+                (*big_ok)++;
+                *big_hash = fnv(*big_hash, payload, len);
+            }
+        } else {
+            len = (uint16_t)(bench_rand() % (MAX_DATA_LENGTH + 1));
+            for (i = 0; i < len; i++) {
+                payload[i] = (uint8_t)bench_rand();
+            }
+            cmd = (uint8_t)(bench_rand() % BIG_CMD);
+            if (cmd == BLOB_CMD) {
+                cmd++;
+            }
+            data_comm_send_ex(tx, cmd, payload, len);
+            (*packets)++;
+            *packet_hash = fnv(fnv(*packet_hash, &cmd, 1), payload, len);
+        }
+    }
+}
+
+static void rx_reset(void)
+{
+    g_packets = 0;
+    g_packet_hash = 2166136261u;
+    g_stream_ok = 0;
+    g_stream_fail = 0;
+    g_stream_hash = 2166136261u;
+    g_open = 0;
+}
+
+/**
+  * @brief  1. 混合数据流逐字节/随机分块批量解析
+  */
+static void check_mixed(DataCommHandle *tx, DataCommHandle *rx, uint32_t frames)
+{
+    uint32_t packets, packet_hash, big_ok, big_fail, big_hash;
+    size_t pos, n, i;
+    int mode;
+
+    make_mixed(tx, frames, &packets, &packet_hash, &big_ok, &big_fail, &big_hash);
+    for (mode = 0; mode < 2; mode++) {
+        rx_reset();
+        for (pos = 0; pos < g_stream_len; pos += n) {
+            n = 1 + bench_rand() % 700;
+            if (n > g_stream_len - pos) {
+                n = g_stream_len - pos;
+            }
+            if (mode == 0) {
+                for (i = 0; i < n; i++) {
+                    data_comm_parse_byte_ex(rx, g_stream[pos + i]);
+                }
+            } else {
+                data_comm_parse_buffer_ex(rx, &g_stream[pos], n);
+            }
+        }
+        CHECK(g_packets == packets && g_packet_hash == packet_hash);
+        CHECK(g_stream_ok == big_ok && g_stream_fail == big_fail && !g_open);
+        /* 损坏帧在出错前已交付的内容不计入期望哈希，只有无损坏帧时才能比较内容 */
+        CHECK(big_fail != 0 || g_stream_hash == big_hash);
+    }
+    printf("mixed stream: %u packets, %u streamed frames, %u corrupted -> OK\n", packets, big_ok, big_fail);
+}
+
+/**
+  * @brief  2. 分片数据块发送与重组
+  */
+static void check_blob(DataCommHandle *tx, DataCommHandle *rx)
+{
+    static uint8_t blob[BLOB_LEN];
+    uint32_t i, frags;
+
+    for (i = 0; i < BLOB_LEN; i++) {
+        blob[i] = (uint8_t)bench_rand();
+    }
+
+    /* 完整发送 */
+    rx_reset();
+    g_stream_len = 0;
+    g_tx_frames = 0;
+    CHECK(data_comm_blob_send(tx, BLOB_CMD, blob, BLOB_LEN, 0) == BLOB_LEN);
+    frags = g_tx_frames;
+    data_comm_parse_buffer_ex(rx, g_stream, g_stream_len);
+    CHECK(g_stream_ok == 1 && g_blob_len == BLOB_LEN && memcmp(g_blob, blob, BLOB_LEN) == 0);
+
+    /* 丢失中间一个分片，随后的数据块完整 */
+    rx_reset();
+    g_stream_len = 0;
+    g_tx_frames = 0;
+    g_drop_frame = frags / 2;
+    data_comm_blob_send(tx, BLOB_CMD, blob, BLOB_LEN, 0);
+    g_drop_frame = 0;
+    data_comm_blob_send(tx, BLOB_CMD, blob, BLOB_LEN, 0);
+    data_comm_parse_buffer_ex(rx, g_stream, g_stream_len);
+    CHECK(g_stream_ok == 1 && g_stream_fail == 1 && data_comm_blob_errors(rx) == 1);
+    CHECK(memcmp(g_blob, blob, BLOB_LEN) == 0);
+    printf("blob %u bytes in %u fragments, lost fragment aborts the blob -> OK\n", BLOB_LEN, frags);
+}
+
+/**
+  * @brief  按固定块长批量解析整个数据流
+  */
+static void parse_chunks(DataCommHandle *rx)
+{
+    size_t pos;
+
+    for (pos = 0; pos < g_stream_len; pos += BENCH_CHUNK) {
+        data_comm_parse_buffer_ex(rx, &g_stream[pos], (g_stream_len - pos < BENCH_CHUNK) ? g_stream_len - pos : BENCH_CHUNK);
+    }
+}
+
+/**
+  * @brief  3. 流式接收大帧与缓存接收普通帧的耗时对比（载荷总量相同）
+  */
+static void bench(DataCommHandle *tx, DataCommHandle *rx, uint32_t frames)
+{
+    static uint8_t payload[BIG_LEN];
+    uint32_t f, i;
+    uint64_t t;
+
+    for (i = 0; i < BIG_LEN; i++) {
+        payload[i] = (uint8_t)bench_rand();
+    }
+
+    g_stream_len = 0;
+    for (f = 0; f < frames; f++) {
+        put_big_frame(BIG_CMD, payload, BIG_LEN, 0);
+    }
+    rx_reset();
+    t = bench_now();
+    parse_chunks(rx);
+    t = bench_now() - t;
+    printf("  streamed %u-byte frames   : %6.2f %s/byte (%u frames)\n",
+           BIG_LEN, (double)t / g_stream_len, BENCH_UNIT, g_stream_ok);
+
+    g_stream_len = 0;
+    for (f = 0; f < frames * (BIG_LEN / MAX_DATA_LENGTH); f++) {
+        data_comm_send_ex(tx, 0x01, payload, MAX_DATA_LENGTH);
+    }
+    rx_reset();
+    t = bench_now();
+    parse_chunks(rx);
+    t = bench_now() - t;
+    printf("  buffered %u-byte frames    : %6.2f %s/byte (%u frames)\n",
+           MAX_DATA_LENGTH, (double)t / g_stream_len, BENCH_UNIT, g_packets);
+}
+
+int main(int argc, char **argv)
+{
+    DataCommHandle tx, rx;
+    DataCommConfig config;
+    uint32_t frames = 20000;
+
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        frames = 1000;
+    }
+    g_stream = (uint8_t *)malloc((size_t)frames * (BIG_LEN + DATA_COMM_FRAME_OVERHEAD) + 4 * BLOB_LEN);
+    if (g_stream == NULL) {
+        return 1;
+    }
+
+    memset(&config, 0, sizeof(config));
+    config.transmit = bench_transmit;
+    data_comm_init_ex(&tx, &config);
+    config.packet_handler = bench_packet_handler;
+    config.stream = &g_ops;
+    data_comm_init_ex(&rx, &config);
+
+    check_mixed(&tx, &rx, frames);
+    check_blob(&tx, &rx);
+    bench(&tx, &rx, frames / 10);
+
+    free(g_stream);
+    return 0;
+}
@@ -0,0 +1,235 @@
+/**
+  ******************************************************************************
+  * @file    throughput_bench.c
+  * @brief   协议收发吞吐率主机端性能测试
+  * @note    对不同载荷长度（0 ~ MAX_DATA_LENGTH）和误码率分别测量：
+  *            send  - data_comm_send_ex()组帧，发送函数只做拷贝
+  *            byte  - data_comm_parse_byte_ex()逐字节解析
+  *            buf   - data_comm_parse_buffer_ex()批量解析
+  *          输出线路字节吞吐率（MB/s）、每帧耗时（cycles或ns）和成功交付的帧比例
+  *          启用DATA_COMM_BATCH时另外比较短消息合并发送与逐条发送的线路效率
+  *          throughput_bench [--quick]    --quick减少帧数，用于ctest冒烟测试
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "bench_timer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================= 测试参数 ========================= */
+#define BENCH_STREAM_BYTES  (4u << 20)   // 每组测试的线路字节数上限
+#define BENCH_MAX_FRAMES    200000u      // 每组测试的帧数上限
+
+static const uint16_t payload_sizes[] = {0, 1, 2, 4, 8, 16, 32, 64, 128, MAX_DATA_LENGTH};
+static const double bit_error_rates[] = {0, 1e-6, 1e-5, 1e-4, 1e-3};
+
+#define ARRAY_SIZE(a)  (sizeof(a) / sizeof((a)[0]))
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static uint32_t g_rx_packets;
+static DataCommHandle g_handle;
+
+/* ========================= 测试用回调 ========================= */
+static void bench_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    memcpy(g_stream + g_stream_len, data, len);
+    g_stream_len += len;
+}
+
+static void bench_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)cmd;
+    (void)data;
+    (void)len;
+    g_rx_packets++;
+}
+
+static uint64_t g_rand = 88172645463325252ull;
+
+static uint64_t bench_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 7;
+    g_rand ^= g_rand << 17;
+    return g_rand;
+}
+
+/**
+  * @brief  按误码率随机翻转比特，位错误间隔服从几何分布
+  * @retval 翻转的比特数
+  */
+static uint32_t inject_bit_errors(uint8_t *buf, size_t len, double ber)
+{
+    double pos, u;
+    uint32_t flips = 0;
+    
+    if (ber <= 0) {
+        return 0;
+    }
+    pos = 0;
+    for (;;) {
+        u = ((double)(bench_rand() >> 11) + 1.0) / 9007199254740993.0;
+        pos += floor(log(u) / log(1.0 - ber));
+        if (pos >= (double)len * 8) {
+            break;
+        }
+        buf[(size_t)pos / 8] ^= (uint8_t)(1u << ((size_t)pos % 8));
+        flips++;
+        pos += 1;
+    }
+    return flips;
+}
+
+/**
+  * @brief  重新初始化测试实例，清空解析状态
+  */
+static void bench_reset(void)
+{
+    DataCommConfig config;
+    
+    memset(&config, 0, sizeof(config));
+    config.transmit = bench_transmit;
+    config.packet_handler = bench_packet_handler;
+    data_comm_init_ex(&g_handle, &config);
+    g_rx_packets = 0;
+}
+
+static void print_result(const char *name, uint16_t size, double ber, size_t bytes,
+                         uint32_t frames, double seconds, uint64_t ticks, uint32_t delivered)
+{
+    printf("%-4s %5u  %7.0e  %9.1f  %10.1f  %7.2f%%\n",
+           name, size, ber, (double)bytes / seconds / 1e6, (double)ticks / frames,
+           100.0 * delivered / frames);
+}
+
+#if DATA_COMM_BATCH
+/**
+  * @brief  短消息合并发送：线路效率（载荷字节/线路字节）和收发耗时
+  */
+static void bench_batch(uint32_t messages)
+{
+    static const uint16_t sizes[] = {0, 2, 4, 6, 16};
+    static uint8_t payload[16];
+    size_t plain_bytes;
+    uint64_t t_send, t_parse;
+    uint32_t m;
+    unsigned si;
+    
+    printf("\nbatch (DATA_COMM_BATCH_SIZE=%u)\n", (unsigned)DATA_COMM_BATCH_SIZE);
+    printf(" size  plain B/msg  batch B/msg  efficiency  send %s/msg  parse %s/msg  delivered\n",
+           BENCH_UNIT, BENCH_UNIT);
+    for (si = 0; si < ARRAY_SIZE(sizes); si++) {
+        uint16_t size = sizes[si];
+        
+        plain_bytes = (size_t)messages * (size + DATA_COMM_FRAME_OVERHEAD);
+        
+        bench_reset();
+        g_stream_len = 0;
+        t_send = bench_now();
+        for (m = 0; m < messages; m++) {
+            data_comm_batch_send(&g_handle, (uint8_t)(m % 0xF0), payload, size);
+        }
+        data_comm_batch_flush(&g_handle);
+        t_send = bench_now() - t_send;
+        
+        bench_reset();
+        t_parse = bench_now();
+        data_comm_parse_buffer_ex(&g_handle, g_stream, g_stream_len);
+        t_parse = bench_now() - t_parse;
+        
+        printf("%5u  %11.2f  %11.2f  %5.1f%% -> %5.1f%%  %10.1f  %11.1f  %8.2f%%\n",
+               size, (double)plain_bytes / messages, (double)g_stream_len / messages,
+               100.0 * size * messages / plain_bytes, 100.0 * size * messages / g_stream_len,
+               (double)t_send / messages, (double)t_parse / messages, 100.0 * g_rx_packets / messages);
+    }
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    static uint8_t payload[MAX_DATA_LENGTH];
+    static uint8_t *clean;
+    uint32_t frames, f, max_frames = BENCH_MAX_FRAMES;
+    size_t stream_bytes = BENCH_STREAM_BYTES, i, clean_len;
+    uint64_t t0;
+    double s0;
+    unsigned si, bi;
+    
+    if (argc >= 2 && strcmp(argv[1], "--quick") == 0) {
+        max_frames = 2000;
+        stream_bytes = 64u << 10;
+    }
+    
+    g_stream = malloc(stream_bytes + DATA_COMM_FRAME_SIZE);
+    clean = malloc(stream_bytes + DATA_COMM_FRAME_SIZE);
+    if (g_stream == NULL || clean == NULL) {
+        return 1;
+    }
+    for (i = 0; i < MAX_DATA_LENGTH; i++) {
+        payload[i] = (uint8_t)bench_rand();
+    }
+    
+    printf("MAX_DATA_LENGTH=%u CRC16_METHOD=%u FRAMING=%u RESYNC=%u, per-frame unit: %s\n",
+           MAX_DATA_LENGTH, (unsigned)CRC16_METHOD, (unsigned)DATA_COMM_FRAMING,
+           (unsigned)DATA_COMM_RESYNC, BENCH_UNIT);
+    printf("path  size      BER       MB/s   %s/frame  delivered\n", BENCH_UNIT);
+    
+    for (si = 0; si < ARRAY_SIZE(payload_sizes); si++) {
+        uint16_t size = payload_sizes[si];
+        
+        /* 组帧 */
+        bench_reset();
+        g_stream_len = 0;
+        s0 = bench_seconds();
+        t0 = bench_now();
+        for (f = 0; f < max_frames && g_stream_len + DATA_COMM_FRAME_SIZE <= stream_bytes; f++) {
+            data_comm_send_ex(&g_handle, (uint8_t)f, payload, size);
+        }
+        t0 = bench_now() - t0;
+        frames = f;
+        s0 = bench_seconds() - s0;
+        print_result("send", size, 0, g_stream_len, frames, s0, t0, frames);
+        memcpy(clean, g_stream, g_stream_len);
+        clean_len = g_stream_len;
+        
+        for (bi = 0; bi < ARRAY_SIZE(bit_error_rates); bi++) {
+            double ber = bit_error_rates[bi];
+            
+            /* 逐字节解析 */
+            memcpy(g_stream, clean, clean_len);
+            inject_bit_errors(g_stream, clean_len, ber);
+            bench_reset();
+            s0 = bench_seconds();
+            t0 = bench_now();
+            for (i = 0; i < clean_len; i++) {
+                data_comm_parse_byte_ex(&g_handle, g_stream[i]);
+            }
+            t0 = bench_now() - t0;
+            s0 = bench_seconds() - s0;
+            print_result("byte", size, ber, clean_len, frames, s0, t0, g_rx_packets);
+            
+            /* 批量解析（同一误码数据） */
+            bench_reset();
+            s0 = bench_seconds();
+            t0 = bench_now();
+            data_comm_parse_buffer_ex(&g_handle, g_stream, clean_len);
+            t0 = bench_now() - t0;
+            s0 = bench_seconds() - s0;
+            print_result("buf", size, ber, clean_len, frames, s0, t0, g_rx_packets);
+        }
+    }
+    
+#if DATA_COMM_BATCH
+    bench_batch(max_frames);
+#endif
+    
+    free(g_stream);
+    free(clean);
+    return 0;
+}
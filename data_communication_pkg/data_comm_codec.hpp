@@ -0,0 +1,308 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_codec.hpp
+  * @brief   编译期特化的协议编解码器（C++模板，仅头文件）
+  * @note    帧格式与data_communication_pkg.c的帧头帧尾格式相同：
+  *            帧头(2) + 长度(LenWidth) + 命令(1) + 数据(n) + 校验(0/2) + 帧尾(2)
+  *          帧头、帧尾、长度字段宽度、最大载荷和校验方式均为模板参数，
+  *          同一固件中可同时存在多种协议方言（如一路带CRC、一路无CRC单字节长度），
+  *          每种实例化得到独立的状态机，缓冲区大小固定，常量比较在编译期折叠。
+  *          需要C++14
+  ******************************************************************************
+  */
+
+#ifndef __DATA_COMM_CODEC_HPP
+#define __DATA_COMM_CODEC_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace data_comm {
+
+/* ========================= 校验策略 ========================= */
+/**
+  * @brief  无校验
+  */
+struct NoChecksum {
+    static constexpr uint8_t kSize = 0;     // 校验字段字节数
+
+    static constexpr uint16_t init() { return 0; }
+    static uint16_t update(uint16_t crc, uint8_t) { return crc; }
+    static uint16_t update(uint16_t crc, const uint8_t *, size_t) { return crc; }
+};
+
+/**
+  * @brief  CRC16-CCITT（多项式0x1021，初始值0xFFFF），与data_comm_crc16()结果一致
+  * @note   查找表在编译期生成，放在Flash中
+  */
+struct Crc16Ccitt {
+    static constexpr uint8_t kSize = 2;     // 校验字段字节数
+
+    static constexpr uint16_t init() { return 0xFFFF; }
+
+    static uint16_t update(uint16_t crc, uint8_t byte)
+    {
+        return (uint16_t)((crc << 8) ^ table()[(uint8_t)((crc >> 8) ^ byte)]);
+    }
+
+    static uint16_t update(uint16_t crc, const uint8_t *data, size_t len)
+    {
+        while (len--) {
+            crc = update(crc, *data++);
+        }
+        return crc;
+    }
+
+private:
+    struct Table {
+        uint16_t v[256];
+
+        constexpr Table() : v()
+        {
+            for (unsigned i = 0; i < 256; i++) {
+                uint16_t crc = (uint16_t)(i << 8);
+                for (unsigned bit = 0; bit < 8; bit++) {
+                    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+                }
+                v[i] = crc;
+            }
+        }
+    };
+
+    static const uint16_t *table()
+    {
+        static constexpr Table t{};
+        return t.v;
+    }
+};
+
+/* ========================= 编解码器 ========================= */
+/**
+  * @brief  协议编解码器
+  * @tparam Header   : 帧头（2字节）
+  * @tparam Tail     : 帧尾（2字节）
+  * @tparam LenWidth : 长度字段字节数（1或2）
+  * @tparam MaxLen   : 最大数据载荷长度
+  * @tparam Checksum : 校验策略（Crc16Ccitt或NoChecksum）
+  * @note   状态机只有4个状态（搜索帧头、帧头第2字节~命令、数据、校验~帧尾），
+  *         长度字段宽度和校验方式只改变编译期常量，不同方言不存在用不到的状态；
+  *         出错时的行为与data_communication_pkg.c逐字节一致
+  */
+template <uint16_t Header, uint16_t Tail, unsigned LenWidth, uint16_t MaxLen, class Checksum = Crc16Ccitt>
+class FrameCodec {
+    static_assert(LenWidth == 1 || LenWidth == 2, "LenWidth必须为1或2");
+    static_assert(MaxLen >= 1 && (uint32_t)MaxLen + 1 < (1UL << (8 * LenWidth)), "MaxLen + 1必须能用长度字段表示");
+
+public:
+    /**
+      * @brief  数据包回调类型
+      * @param  user : 构造时传入的用户数据
+      * @param  cmd  : 命令字节
+      * @param  data : 数据载荷（回调返回前有效）
+      * @param  len  : 数据载荷长度
+      */
+    typedef void (*Handler)(void *user, uint8_t cmd, uint8_t *data, uint16_t len);
+
+    static constexpr uint16_t kPrefixSize  = 2 + LenWidth + 1;              // 帧头 + 长度 + 命令
+    static constexpr uint16_t kTrailerSize = Checksum::kSize + 2;           // 校验 + 帧尾
+    static constexpr uint16_t kOverhead    = kPrefixSize + kTrailerSize;    // 帧开销
+    static constexpr uint16_t kMaxFrame    = MaxLen + kOverhead;            // 最大帧长度
+
+    explicit FrameCodec(Handler handler = nullptr, void *user = nullptr)
+        : handler_(handler), user_(user)
+    {
+        reset();
+    }
+
+    /**
+      * @brief  复位解析状态机，等待下一帧
+      */
+    void reset()
+    {
+        state_ = kStateHunt;
+    }
+
+    /**
+      * @brief  解析一个字节
+      */
+    void parse_byte(uint8_t byte)
+    {
+        switch (state_) {
+            case kStateHunt:
+                if (byte == kHeader1) {
+                    state_ = kStatePrefix;
+                    pos_ = 1;
+                }
+                break;
+
+            case kStatePrefix:
+                if (pos_ == 1) {
+                    /* 帧头第2字节；本字节若为帧头第1字节则保持等待第2字节 */
+                    if (byte == kHeader2) {
+                        crc_ = Checksum::init();
+                        length_ = 0;
+                        pos_ = 2;
+                    } else if (byte != kHeader1) {
+                        state_ = kStateHunt;
+                    }
+                    break;
+                }
+                crc_ = Checksum::update(crc_, byte);
+                if (pos_ < 2 + LenWidth) {
+                    /* 长度字段（大端序） */
+                    length_ = (uint16_t)((length_ << 8) | byte);
+                    if (++pos_ == 2 + LenWidth && (length_ == 0 || length_ > MaxLen + 1)) {
+                        state_ = kStateHunt;
+                    }
+                    break;
+                }
+                cmd_ = byte;
+                pos_ = 0;
+                state_ = (length_ > 1) ? kStateData : kStateTrailer;
+                break;
+
+            case kStateData:
+                data_[pos_++] = byte;
+                crc_ = Checksum::update(crc_, byte);
+                if (pos_ >= length_ - 1) {
+                    pos_ = 0;
+                    state_ = kStateTrailer;
+                }
+                break;
+
+            case kStateTrailer:
+                trailer_byte(byte);
+                break;
+
+            default:
+                state_ = kStateHunt;
+                break;
+        }
+    }
+
+    /**
+      * @brief  批量解析数据块，结果与逐字节调用parse_byte()一致
+      * @note   搜索帧头时使用memchr，数据整段拷贝并整段计算校验
+      */
+    void parse(const uint8_t *buf, size_t len)
+    {
+        const uint8_t *p = buf;
+        const uint8_t *end = buf + len;
+        const uint8_t *hit;
+        size_t chunk;
+
+        while (p < end) {
+            if (state_ == kStateHunt) {
+                hit = (const uint8_t *)memchr(p, kHeader1, (size_t)(end - p));
+                if (hit == nullptr) {
+                    return;
+                }
+                p = hit + 1;
+                state_ = kStatePrefix;
+                pos_ = 1;
+            } else if (state_ == kStateData) {
+                chunk = (size_t)(length_ - 1 - pos_);
+                if ((size_t)(end - p) < chunk) {
+                    chunk = (size_t)(end - p);
+                }
+                memcpy(&data_[pos_], p, chunk);
+                crc_ = Checksum::update(crc_, p, chunk);
+                pos_ = (uint16_t)(pos_ + chunk);
+                p += chunk;
+                if (pos_ >= length_ - 1) {
+                    pos_ = 0;
+                    state_ = kStateTrailer;
+                }
+            } else {
+                parse_byte(*p++);
+            }
+        }
+    }
+
+    /**
+      * @brief  打包一帧
+      * @param  out  : 输出缓冲区（至少kMaxFrame字节，data可位于其中，会先移动到载荷位置）
+      * @param  cmd  : 命令字节
+      * @param  data : 数据载荷
+      * @param  len  : 数据载荷长度（0~MaxLen）
+      * @retval 帧长度（参数错误返回0）
+      */
+    static uint16_t encode(uint8_t *out, uint8_t cmd, const uint8_t *data, uint16_t len)
+    {
+        uint16_t n = 0;
+        uint16_t crc;
+
+        if (len > MaxLen || (data == nullptr && len > 0)) {
+            return 0;
+        }
+        if (len > 0) {
+            memmove(&out[kPrefixSize], data, len);
+        }
+        out[n++] = kHeader1;
+        out[n++] = kHeader2;
+        if (LenWidth == 2) {
+            out[n++] = (uint8_t)((len + 1) >> 8);
+        }
+        out[n++] = (uint8_t)(len + 1);
+        out[n++] = cmd;
+        n = (uint16_t)(n + len);
+        if (Checksum::kSize > 0) {
+            crc = Checksum::update(Checksum::init(), &out[2], (size_t)(n - 2));
+            out[n++] = (uint8_t)(crc >> 8);
+            out[n++] = (uint8_t)crc;
+        }
+        out[n++] = (uint8_t)(Tail >> 8);
+        out[n++] = (uint8_t)Tail;
+        return n;
+    }
+
+private:
+    enum : uint8_t {
+        kStateHunt,     // 搜索帧头第1字节
+        kStatePrefix,   // 帧头第2字节、长度、命令
+        kStateData,     // 数据载荷
+        kStateTrailer   // 校验、帧尾
+    };
+
+    static constexpr uint8_t kHeader1 = (uint8_t)(Header >> 8);
+    static constexpr uint8_t kHeader2 = (uint8_t)Header;
+
+    /**
+      * @brief  处理校验和帧尾字节，逐字节检查，出错立即回到搜索帧头
+      */
+    void trailer_byte(uint8_t byte)
+    {
+        if (Checksum::kSize > 0 && pos_ < Checksum::kSize) {
+            recv_crc_ = (uint16_t)((recv_crc_ << 8) | byte);
+            if (++pos_ == Checksum::kSize && recv_crc_ != crc_) {
+                state_ = kStateHunt;
+            }
+            return;
+        }
+        if (byte != (uint8_t)(Tail >> (pos_ == Checksum::kSize ? 8 : 0))) {
+            state_ = kStateHunt;
+            return;
+        }
+        if (++pos_ == kTrailerSize) {
+            state_ = kStateHunt;
+            if (handler_ != nullptr) {
+                handler_(user_, cmd_, data_, (uint16_t)(length_ - 1));
+            }
+        }
+    }
+
+    uint8_t state_;
+    uint8_t cmd_;
+    uint16_t pos_;
+    uint16_t length_;
+    uint16_t crc_;
+    uint16_t recv_crc_;
+    uint8_t data_[MaxLen];
+    Handler handler_;
+    void *user_;
+};
+
+}  // namespace data_comm
+
+#endif /* __DATA_COMM_CODEC_HPP */
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_codec_shim.cpp
+  * @brief   基于FrameCodec模板的兼容接口实现
+  * @note    用本文件代替data_communication_pkg.c链接，即可在C代码中继续使用
+  *          data_comm_init()/data_comm_send()/data_comm_parse_byte()/data_comm_parse_buffer()
+  *          （及data_comm_crc16()），协议参数取自data_communication_pkg.h的用户配置；
+  *          多实例、队列、合并、可靠传输等扩展功能仍需使用data_communication_pkg.c
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_codec.hpp"
+
+#if DATA_COMM_FRAMING != DATA_COMM_FRAMING_HEADER
+#error "FrameCodec仅支持帧头帧尾格式"
+#endif
+
+namespace {
+
+#if USE_CRC16
+typedef data_comm::Crc16Ccitt DefaultChecksum;
+#else
+typedef data_comm::NoChecksum DefaultChecksum;
+#endif
+
+typedef data_comm::FrameCodec<FRAME_HEADER, FRAME_END, 2, MAX_DATA_LENGTH, DefaultChecksum> DefaultCodec;
+
+void default_packet_handler(void *user, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)user;
+    user_packet_handler(cmd, data, len);
+}
+
+DefaultCodec g_codec(default_packet_handler);
+uint8_t g_tx_buffer[DefaultCodec::kMaxFrame];
+
+}  // namespace
+
+extern "C" {
+
+void data_comm_init(void)
+{
+    g_codec.reset();
+}
+
+uint16_t data_comm_send(uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint16_t frame_len = DefaultCodec::encode(g_tx_buffer, cmd, data, len);
+
+    if (frame_len > 0) {
+        user_transmit(g_tx_buffer, frame_len);
+    }
+    return frame_len;
+}
+
+void data_comm_parse_byte(uint8_t byte)
+{
+    g_codec.parse_byte(byte);
+}
+
+void data_comm_parse_buffer(const uint8_t *buf, size_t len)
+{
+    if (buf != NULL) {
+        g_codec.parse(buf, len);
+    }
+}
+
+#if USE_CRC16
+uint16_t data_comm_crc16(uint16_t crc, const uint8_t *data, uint16_t len)
+{
+    return data_comm::Crc16Ccitt::update(crc, data, len);
+}
+#endif
+
+}  // extern "C"
@@ -0,0 +1,221 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_msg.h
+  * @brief   类型化消息定义（X-macro），生成零拷贝访问函数和就地序列化函数
+  * @note    每条消息在一处声明命令字节和字段列表，然后包含data_comm_msg_def.h：
+  *
+  *            #define DATA_COMM_MSG_NAME    sensor_report
+  *            #define DATA_COMM_MSG_CMD     0x21
+  *            #define DATA_COMM_MSG_FIELDS(F, A) \
+  *                F(u32, timestamp)               \
+  *                F(i16, temperature)             \
+  *                A(i16, accel, 3)
+  *            #include "data_comm_msg_def.h"
+  *
+  *          F(类型, 字段名)为标量字段，A(类型, 字段名, 个数)为定长数组字段，
+  *          类型为u8/i8/u16/i16/u32/i32/f32，多字节字段均为大端序，字段间无填充。
+  *          以消息名为前缀生成（以sensor_report为例）：
+  *            sensor_report_CMD / sensor_report_SIZE     命令字节 / 载荷长度（编译期常量）
+  *            sensor_report_wire_t                       线上布局（各字段为uint8_t数组，1字节对齐）
+  *            sensor_report_t                            本机结构体（主机端解码用）
+  *            sensor_report_view(data, len)              接收缓冲区 -> 只读视图，长度不足返回NULL
+  *            sensor_report_get_xxx(m[, i])              读字段（数组下标越界返回0）
+  *            sensor_report_set_xxx(m, [i, ]v)           写字段（数组下标越界忽略）
+  *            sensor_report_reserve(handle)              在发送帧内预留载荷，返回可写视图
+  *            sensor_report_commit(handle)               提交预留的载荷并发送
+  *            sensor_report_decode(data, len, out)       解码为本机结构体
+  *            sensor_report_encode(in, out)              从本机结构体编码
+  *            sensor_report_send(handle, in)             从本机结构体直接编码到发送帧并发送
+  *          载荷长度超过MAX_DATA_LENGTH时编译报错
+  ******************************************************************************
+  */
+
+#ifndef __DATA_COMM_MSG_H
+#define __DATA_COMM_MSG_H
+
+#include "data_communication_pkg.h"
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================= 用户配置参数区 ========================= */
+// 生成函数的修饰符（编译器不支持C99 inline时可定义为static __inline或static）
+#ifndef DATA_COMM_MSG_INLINE
+#define DATA_COMM_MSG_INLINE    static inline
+#endif
+
+/* ========================= 字段类型 ========================= */
+#define DATA_COMM_MSG_SIZE_u8     1
+#define DATA_COMM_MSG_SIZE_i8     1
+#define DATA_COMM_MSG_SIZE_u16    2
+#define DATA_COMM_MSG_SIZE_i16    2
+#define DATA_COMM_MSG_SIZE_u32    4
+#define DATA_COMM_MSG_SIZE_i32    4
+#define DATA_COMM_MSG_SIZE_f32    4
+
+#define DATA_COMM_MSG_TYPE_u8     uint8_t
+#define DATA_COMM_MSG_TYPE_i8     int8_t
+#define DATA_COMM_MSG_TYPE_u16    uint16_t
+#define DATA_COMM_MSG_TYPE_i16    int16_t
+#define DATA_COMM_MSG_TYPE_u32    uint32_t
+#define DATA_COMM_MSG_TYPE_i32    int32_t
+#define DATA_COMM_MSG_TYPE_f32    float
+
+DATA_COMM_MSG_INLINE uint8_t data_comm_msg_get_u8(const uint8_t *p)
+{
+    return p[0];
+}
+
+DATA_COMM_MSG_INLINE int8_t data_comm_msg_get_i8(const uint8_t *p)
+{
+    return (int8_t)p[0];
+}
+
+DATA_COMM_MSG_INLINE uint16_t data_comm_msg_get_u16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+DATA_COMM_MSG_INLINE int16_t data_comm_msg_get_i16(const uint8_t *p)
+{
+    return (int16_t)data_comm_msg_get_u16(p);
+}
+
+DATA_COMM_MSG_INLINE uint32_t data_comm_msg_get_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+DATA_COMM_MSG_INLINE int32_t data_comm_msg_get_i32(const uint8_t *p)
+{
+    return (int32_t)data_comm_msg_get_u32(p);
+}
+
+DATA_COMM_MSG_INLINE float data_comm_msg_get_f32(const uint8_t *p)
+{
+    uint32_t bits = data_comm_msg_get_u32(p);
+    float v;
+
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_u8(uint8_t *p, uint8_t v)
+{
+    p[0] = v;
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_i8(uint8_t *p, int8_t v)
+{
+    p[0] = (uint8_t)v;
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_i16(uint8_t *p, int16_t v)
+{
+    data_comm_msg_put_u16(p, (uint16_t)v);
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_i32(uint8_t *p, int32_t v)
+{
+    data_comm_msg_put_u32(p, (uint32_t)v);
+}
+
+DATA_COMM_MSG_INLINE void data_comm_msg_put_f32(uint8_t *p, float v)
+{
+    uint32_t bits;
+
+    memcpy(&bits, &v, sizeof(bits));
+    data_comm_msg_put_u32(p, bits);
+}
+
+/* ========================= 分发表 ========================= */
+/**
+  * @brief  消息的分发表项：载荷短于消息长度的帧不会交给处理函数
+  * @note   允许载荷比消息长（忽略多出的字节），以便在消息末尾追加字段时兼容旧版本
+  *         static const DataCommCmdEntry table[256] = {
+  *             DATA_COMM_MSG_ENTRY(sensor_report, on_sensor_report),
+  *         };
+  */
+#define DATA_COMM_MSG_ENTRY(name, handler) \
+    DATA_COMM_CMD(name##_CMD, (handler), name##_SIZE, MAX_DATA_LENGTH)
+
+/* ========================= 代码生成（供data_comm_msg_def.h使用） ========================= */
+#define DATA_COMM_MSG_CAT_(a, b)          a##b
+#define DATA_COMM_MSG_CAT(a, b)           DATA_COMM_MSG_CAT_(a, b)
+#define DATA_COMM_MSG_CAT3_(a, b, c)      a##b##c
+#define DATA_COMM_MSG_CAT3(a, b, c)       DATA_COMM_MSG_CAT3_(a, b, c)
+#define DATA_COMM_MSG_ID(suffix)          DATA_COMM_MSG_CAT(DATA_COMM_MSG_NAME, suffix)
+#define DATA_COMM_MSG_WIRE                DATA_COMM_MSG_ID(_wire_t)
+#define DATA_COMM_MSG_NATIVE              DATA_COMM_MSG_ID(_t)
+
+/* 载荷长度 */
+#define DATA_COMM_MSG_GEN_SIZE_F(t, f)        + DATA_COMM_MSG_SIZE_##t
+#define DATA_COMM_MSG_GEN_SIZE_A(t, f, n)     + (n) * DATA_COMM_MSG_SIZE_##t
+
+/* 线上布局 */
+#define DATA_COMM_MSG_GEN_WIRE_F(t, f)        uint8_t f[DATA_COMM_MSG_SIZE_##t];
+#define DATA_COMM_MSG_GEN_WIRE_A(t, f, n)     uint8_t f[(n) * DATA_COMM_MSG_SIZE_##t];
+
+/* 本机结构体 */
+#define DATA_COMM_MSG_GEN_NATIVE_F(t, f)      DATA_COMM_MSG_TYPE_##t f;
+#define DATA_COMM_MSG_GEN_NATIVE_A(t, f, n)   DATA_COMM_MSG_TYPE_##t f[n];
+
+/* 字段访问函数 */
+#define DATA_COMM_MSG_GEN_ACCESS_F(t, f)                                                        \
+    DATA_COMM_MSG_INLINE DATA_COMM_MSG_TYPE_##t                                                 \
+    DATA_COMM_MSG_CAT3(DATA_COMM_MSG_NAME, _get_, f)(const DATA_COMM_MSG_WIRE *m)               \
+    {                                                                                           \
+        return data_comm_msg_get_##t(m->f);                                                     \
+    }                                                                                           \
+    DATA_COMM_MSG_INLINE void                                                                   \
+    DATA_COMM_MSG_CAT3(DATA_COMM_MSG_NAME, _set_, f)(DATA_COMM_MSG_WIRE *m, DATA_COMM_MSG_TYPE_##t v) \
+    {                                                                                           \
+        data_comm_msg_put_##t(m->f, v);                                                         \
+    }
+#define DATA_COMM_MSG_GEN_ACCESS_A(t, f, n)                                                     \
+    DATA_COMM_MSG_INLINE DATA_COMM_MSG_TYPE_##t                                                 \
+    DATA_COMM_MSG_CAT3(DATA_COMM_MSG_NAME, _get_, f)(const DATA_COMM_MSG_WIRE *m, uint16_t i)   \
+    {                                                                                           \
+        return (i < (n)) ? data_comm_msg_get_##t(&m->f[i * DATA_COMM_MSG_SIZE_##t]) : 0;       \
+    }                                                                                           \
+    DATA_COMM_MSG_INLINE void                                                                   \
+    DATA_COMM_MSG_CAT3(DATA_COMM_MSG_NAME, _set_, f)(DATA_COMM_MSG_WIRE *m, uint16_t i, DATA_COMM_MSG_TYPE_##t v) \
+    {                                                                                           \
+        if (i < (n)) {                                                                          \
+            data_comm_msg_put_##t(&m->f[i * DATA_COMM_MSG_SIZE_##t], v);                        \
+        }                                                                                       \
+    }
+
+/* 解码/编码（本机结构体 <-> 载荷） */
+#define DATA_COMM_MSG_GEN_DECODE_F(t, f)      out->f = data_comm_msg_get_##t(m->f);
+#define DATA_COMM_MSG_GEN_DECODE_A(t, f, n)                                                     \
+    for (i = 0; i < (n); i++) {                                                                 \
+        out->f[i] = data_comm_msg_get_##t(&m->f[i * DATA_COMM_MSG_SIZE_##t]);                   \
+    }
+#define DATA_COMM_MSG_GEN_ENCODE_F(t, f)      data_comm_msg_put_##t(m->f, in->f);
+#define DATA_COMM_MSG_GEN_ENCODE_A(t, f, n)                                                     \
+    for (i = 0; i < (n); i++) {                                                                 \
+        data_comm_msg_put_##t(&m->f[i * DATA_COMM_MSG_SIZE_##t], in->f[i]);                     \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DATA_COMM_MSG_H */
@@ -0,0 +1,120 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_msg_def.h
+  * @brief   类型化消息代码生成模板
+  * @note    包含前定义DATA_COMM_MSG_NAME、DATA_COMM_MSG_CMD、DATA_COMM_MSG_FIELDS(F, A)，
+  *          用法和生成内容见data_comm_msg.h；本文件无包含保护，每条消息包含一次，
+  *          结束时取消上述三个宏的定义
+  ******************************************************************************
+  */
+
+#include "data_comm_msg.h"
+
+#if !defined(DATA_COMM_MSG_NAME) || !defined(DATA_COMM_MSG_CMD) || !defined(DATA_COMM_MSG_FIELDS)
+#error "包含data_comm_msg_def.h前需定义DATA_COMM_MSG_NAME、DATA_COMM_MSG_CMD和DATA_COMM_MSG_FIELDS"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    DATA_COMM_MSG_ID(_CMD)  = DATA_COMM_MSG_CMD,
+    DATA_COMM_MSG_ID(_SIZE) = 0 DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_SIZE_F, DATA_COMM_MSG_GEN_SIZE_A)
+};
+
+typedef struct {
+    DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_WIRE_F, DATA_COMM_MSG_GEN_WIRE_A)
+} DATA_COMM_MSG_WIRE;
+
+typedef struct {
+    DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_NATIVE_F, DATA_COMM_MSG_GEN_NATIVE_A)
+} DATA_COMM_MSG_NATIVE;
+
+/* 编译期检查：载荷不超过MAX_DATA_LENGTH；线上布局无填充，可直接覆盖在接收缓冲区上 */
+typedef char DATA_COMM_MSG_ID(_size_check)[(DATA_COMM_MSG_ID(_SIZE) <= MAX_DATA_LENGTH) ? 1 : -1];
+typedef char DATA_COMM_MSG_ID(_pack_check)[(sizeof(DATA_COMM_MSG_WIRE) == DATA_COMM_MSG_ID(_SIZE)) ? 1 : -1];
+
+DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_ACCESS_F, DATA_COMM_MSG_GEN_ACCESS_A)
+
+/**
+  * @brief  接收缓冲区的只读视图（零拷贝）
+  * @retval 视图指针（data为NULL或len不足消息长度时返回NULL）
+  */
+DATA_COMM_MSG_INLINE const DATA_COMM_MSG_WIRE *DATA_COMM_MSG_ID(_view)(const uint8_t *data, uint16_t len)
+{
+    return (data != NULL && len >= DATA_COMM_MSG_ID(_SIZE)) ? (const DATA_COMM_MSG_WIRE *)data : NULL;
+}
+
+/**
+  * @brief  在发送帧内预留本消息的载荷，用set函数逐字段写入后调用commit发送
+  * @retval 可写视图（失败返回NULL）
+  */
+DATA_COMM_MSG_INLINE DATA_COMM_MSG_WIRE *DATA_COMM_MSG_ID(_reserve)(DataCommHandle *handle)
+{
+    return (DATA_COMM_MSG_WIRE *)data_comm_reserve(handle, DATA_COMM_MSG_ID(_SIZE));
+}
+
+/**
+  * @brief  提交预留的载荷并发送
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  */
+DATA_COMM_MSG_INLINE uint16_t DATA_COMM_MSG_ID(_commit)(DataCommHandle *handle)
+{
+    return data_comm_commit(handle, DATA_COMM_MSG_ID(_CMD), DATA_COMM_MSG_ID(_SIZE));
+}
+
+/**
+  * @brief  解码为本机结构体
+  * @retval 0: 成功  -1: 长度不足
+  */
+DATA_COMM_MSG_INLINE int8_t DATA_COMM_MSG_ID(_decode)(const uint8_t *data, uint16_t len, DATA_COMM_MSG_NATIVE *out)
+{
+    const DATA_COMM_MSG_WIRE *m = DATA_COMM_MSG_ID(_view)(data, len);
+    uint16_t i;
+
+    if (m == NULL) {
+        return -1;
+    }
+    (void)i;
+    DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_DECODE_F, DATA_COMM_MSG_GEN_DECODE_A)
+    return 0;
+}
+
+/**
+  * @brief  从本机结构体编码
+  * @param  out : 输出缓冲区（至少_SIZE字节）
+  * @retval 载荷长度
+  */
+DATA_COMM_MSG_INLINE uint16_t DATA_COMM_MSG_ID(_encode)(const DATA_COMM_MSG_NATIVE *in, uint8_t *out)
+{
+    DATA_COMM_MSG_WIRE *m = (DATA_COMM_MSG_WIRE *)out;
+    uint16_t i;
+
+    (void)i;
+    DATA_COMM_MSG_FIELDS(DATA_COMM_MSG_GEN_ENCODE_F, DATA_COMM_MSG_GEN_ENCODE_A)
+    return DATA_COMM_MSG_ID(_SIZE);
+}
+
+/**
+  * @brief  从本机结构体直接编码到发送帧内并发送
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  */
+DATA_COMM_MSG_INLINE uint16_t DATA_COMM_MSG_ID(_send)(DataCommHandle *handle, const DATA_COMM_MSG_NATIVE *in)
+{
+    uint8_t *payload = data_comm_reserve(handle, DATA_COMM_MSG_ID(_SIZE));
+
+    if (payload == NULL) {
+        return 0;
+    }
+    DATA_COMM_MSG_ID(_encode)(in, payload);
+    return DATA_COMM_MSG_ID(_commit)(handle);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#undef DATA_COMM_MSG_NAME
+#undef DATA_COMM_MSG_CMD
+#undef DATA_COMM_MSG_FIELDS
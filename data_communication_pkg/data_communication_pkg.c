@@ -10,259 +10,3088 @@
 #include "data_communication_pkg.h"
 #include <string.h>
 
-/* ========================= 私有类型定义 ========================= */
-/**
-  * @brief  解析状态机状态定义
-  */
-typedef enum {
-    STATE_WAIT_HEADER1,       // 等待帧头第1字节
-    STATE_WAIT_HEADER2,       // 等待帧头第2字节
-    STATE_WAIT_LENGTH_HIGH,   // 等待长度高字节
-    STATE_WAIT_LENGTH_LOW,    // 等待长度低字节
-    STATE_WAIT_CMD,           // 等待命令字节
-    STATE_READ_DATA,          // 读取数据载荷
-    STATE_WAIT_CRC1,          // 等待CRC高字节
-    STATE_WAIT_CRC2,          // 等待CRC低字节
-    STATE_WAIT_END1,          // 等待帧尾第1字节
-    STATE_WAIT_END2           // 等待帧尾第2字节
-} ParseState;
-
-/**
-  * @brief  解析上下文结构体
-  */
-typedef struct {
-    ParseState state;                    // 当前解析状态
-    uint16_t data_index;                 // 数据索引
-    uint16_t pkg_length;                 // 数据包长度（CMD+DATA）
-    uint8_t cmd;                         // 命令字节
-    uint8_t data[MAX_DATA_LENGTH];       // 数据缓冲区
-    uint16_t recv_crc;                   // 接收到的CRC
-    uint8_t crc_buffer[MAX_DATA_LENGTH + 3]; // CRC计算缓冲区
-    uint16_t crc_index;                  // CRC缓冲区索引
-} ParseContext;
+/* ========================= 私有宏定义 ========================= */
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+#define FRAME_BODY_OFFSET     DATA_COMM_COBS_PREFIX  // 帧内容（长度起）在缓冲区内的偏移，留出COBS编码膨胀空间
+#else
+#define FRAME_BODY_OFFSET     2                      // 帧内容（长度起）在缓冲区内的偏移：帧头(2)
+#endif
+#define FRAME_PAYLOAD_OFFSET  (FRAME_BODY_OFFSET + 3) // 载荷在缓冲区内的偏移：长度(2) + 命令(1)
+
+/**
+  * @brief  统计计数
+  * @note   未启用DATA_COMM_STATS时展开为空，热路径无额外开销
+  */
+#if DATA_COMM_STATS
+/* DataCommStats仅由uint32_t计数组成，发送时按数组逐个序列化，长度须与DATA_COMM_STATS_SIZE一致 */
+typedef char stats_size_check[(sizeof(DataCommStats) == DATA_COMM_STATS_SIZE) ? 1 : -1];
+
+#define STATS_INC(handle, field)       ((handle)->stats.field++)
+#define STATS_ADD(handle, field, n)    ((handle)->stats.field += (uint32_t)(n))
+#else
+#define STATS_INC(handle, field)
+#define STATS_ADD(handle, field, n)
+#endif
+
+/**
+  * @brief  解析耗时计时
+  * @note   每次解析调用前后各读取一次周期计数器，数据包交付（用户回调）的耗时不计入
+  */
+#if DATA_COMM_STATS && DATA_COMM_STATS_CYCLES
+#ifndef DATA_COMM_CYCLE_COUNT
+#define DATA_COMM_CYCLE_COUNT()        user_cycle_count()
+#endif
+#define PARSE_CYCLES_BEGIN(handle)     ((handle)->cycles_start = DATA_COMM_CYCLE_COUNT())
+#define PARSE_CYCLES_END(handle)       ((handle)->cycles_acc += DATA_COMM_CYCLE_COUNT() - (handle)->cycles_start)
+#else
+#define PARSE_CYCLES_BEGIN(handle)
+#define PARSE_CYCLES_END(handle)
+#endif
+
+/**
+  * @brief  可靠传输会话号
+  * @note   首次可靠发送时取一次，确认帧据此区分本次与复位前的会话，每次上电须不同；
+  *         默认调用user_rel_session()（用户必须实现），也可在编译选项中定义为读取硬件随机数
+  */
+#if DATA_COMM_RELIABLE && !defined(DATA_COMM_REL_SESSION)
+#define DATA_COMM_REL_SESSION()        user_rel_session()
+#endif
+
+/**
+  * @brief  抓包时间戳和内置环形缓冲区的临界区
+  * @note   接收在中断、发送在主循环中进行且共用内置环形缓冲区时，
+  *         须在编译选项中将LOCK/UNLOCK定义为关/开中断（如__disable_irq()/__enable_irq()）
+  */
+#if DATA_COMM_CAPTURE
+#ifndef DATA_COMM_CAPTURE_TIME
+#define DATA_COMM_CAPTURE_TIME()       user_capture_time()
+#endif
+#ifndef DATA_COMM_CAPTURE_LOCK
+#define DATA_COMM_CAPTURE_LOCK()
+#define DATA_COMM_CAPTURE_UNLOCK()
+#endif
+#define CAPTURE_ON(handle, type)       ((handle)->cap_mask & (1u << (type)))
+#else
+#define CAPTURE_ON(handle, type)       0
+#endif
+
+/**
+  * @brief  发送优先级队列
+  * @note   第c级占用tx_buffer[c * DATA_COMM_TX_QUEUE_SIZE]起的DATA_COMM_TX_QUEUE_SIZE个帧槽；
+  *         未启用DATA_COMM_TX_PRIO时只有第0级，展开后与单队列相同
+  */
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+#define TX_SLOT(c, count)              ((c) * DATA_COMM_TX_QUEUE_SIZE + (count) % DATA_COMM_TX_QUEUE_SIZE)
+#if DATA_COMM_TX_PRIO > 0
+#define TX_CLASS(handle)               ((handle)->tx_class)
+#define TX_CUR(handle)                 ((handle)->tx_cur)
+/* 帧所在优先级由帧槽位置得出，异步校验完成时无需另外记录 */
+#define TX_FRAME_CLASS(handle, frame)  ((uint8_t)(((frame) - (handle)->tx_buffer[0]) / \
+                                                  (DATA_COMM_TX_QUEUE_SIZE * DATA_COMM_FRAME_SIZE)))
+#else
+#define TX_CLASS(handle)               0
+#define TX_CUR(handle)                 0
+#define TX_FRAME_CLASS(handle, frame)  0
+#endif
+#endif
+#if DATA_COMM_TX_PRIO > 0 && DATA_COMM_STATS
+#ifndef DATA_COMM_TX_TIME
+#define DATA_COMM_TX_TIME()            user_tx_time()
+#endif
+#define TX_CLASS_STATS_INC(handle, c, field)  ((handle)->tx_class_stats[c].field++)
+#else
+#define TX_CLASS_STATS_INC(handle, c, field)
+#endif
+
+/**
+  * @brief  流式帧出错中止
+  * @note   未启用DATA_COMM_STREAM时展开为空
+  */
+#if DATA_COMM_STREAM
+#define STREAM_ABORT(handle)           do { if ((handle)->rx.streaming) { stream_end((handle), 0); } } while (0)
+#else
+#define STREAM_ABORT(handle)
+#endif
+
+/**
+  * @brief  用户函数默认实现的弱符号属性
+  * @note   与HAL库的__weak回调相同，用户可在自己的源文件中实现user_xxx()函数覆盖默认实现，
+  *         无需修改本文件（主机端构建也通过这种方式提供桩函数）
+  */
+#ifndef DATA_COMM_WEAK
+#if defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define DATA_COMM_WEAK        __attribute__((weak))
+#elif defined(__ICCARM__)
+#define DATA_COMM_WEAK        __weak
+#else
+#define DATA_COMM_WEAK
+#endif
+#endif
+
+/**
+  * @brief  编译器内存屏障
+  * @note   保证队列帧槽内容写完后再发布索引（中断与主循环之间的单生产者/单消费者队列）
+  *         单核MCU只需阻止编译器重排，无需硬件屏障指令
+  */
+#ifndef DATA_COMM_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define DATA_COMM_BARRIER()   __asm volatile ("" ::: "memory")
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define DATA_COMM_BARRIER()   atomic_signal_fence(memory_order_seq_cst)
+#else
+#define DATA_COMM_BARRIER()
+#endif
+#endif
+
+/* ========================= 私有变量 ========================= */
+static void default_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len);
+static void default_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len);
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+static void default_transmit_async(DataCommHandle *handle, uint8_t *data, uint16_t len);
+#define DEFAULT_TRANSMIT_ASYNC  default_transmit_async
+#else
+#define DEFAULT_TRANSMIT_ASYNC  NULL
+#endif
+
+/* 默认实例，供兼容接口及传入NULL句柄时使用 */
+static DataCommHandle g_default_handle = {
+    .config = { default_transmit, default_packet_handler, NULL, DEFAULT_TRANSMIT_ASYNC, NULL, NULL }
+};
+
+#if DATA_COMM_CAPTURE && DATA_COMM_CAPTURE_RING_SIZE > 0
+/* 内置抓包环形缓冲区，各实例共用 */
+static struct {
+    uint8_t buf[DATA_COMM_CAPTURE_RING_SIZE];
+    uint32_t head;                       // 写入计数（自由运行）
+    uint32_t tail;                       // 最早一条完整记录的起点计数
+    uint32_t dropped;                    // 被覆盖或过长而丢弃的记录数
+} g_cap_ring;
+#endif
+
+/* ========================= 私有函数 ========================= */
+#if USE_CRC16
+#if CRC16_METHOD == CRC16_METHOD_SLICE8
+#define CRC16_TABLE_NUM   8
+#elif CRC16_METHOD == CRC16_METHOD_SLICE4
+#define CRC16_TABLE_NUM   4
+#elif CRC16_METHOD == CRC16_METHOD_TABLE
+#define CRC16_TABLE_NUM   1
+#elif CRC16_METHOD != CRC16_METHOD_BITWISE
+#error "CRC16_METHOD配置错误"
+#endif
+
+#ifdef CRC16_TABLE_NUM
+/**
+  * @brief  CRC16-CCITT查找表（多项式0x1021）
+  * @note   crc16_table[0][b]  : 单字节b的CRC
+  *         crc16_table[k][b]  : 单字节b后接k个0x00字节的CRC，用于slice-by-N
+  */
+static const uint16_t crc16_table[CRC16_TABLE_NUM][256] = {
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+    },
+#if CRC16_TABLE_NUM > 1
+    {
+        0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+        0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+        0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+        0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+        0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+        0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+        0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+        0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+        0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+        0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+        0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+        0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+        0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+        0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+        0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+        0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+        0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+        0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+        0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+        0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+        0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+        0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+        0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+        0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+        0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+        0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+        0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+        0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+        0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+        0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+        0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+        0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF
+    },
+    {
+        0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+        0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+        0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+        0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+        0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+        0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+        0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+        0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+        0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+        0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+        0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+        0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+        0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+        0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+        0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+        0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+        0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+        0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+        0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+        0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+        0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+        0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+        0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+        0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+        0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+        0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+        0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+        0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+        0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+        0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+        0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+        0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63
+    },
+    {
+        0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+        0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+        0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+        0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+        0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+        0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+        0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+        0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+        0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+        0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+        0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+        0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+        0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+        0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+        0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+        0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+        0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+        0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+        0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+        0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+        0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+        0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+        0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+        0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+        0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+        0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+        0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+        0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+        0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+        0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+        0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+        0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3
+    },
+#endif
+#if CRC16_TABLE_NUM > 4
+    {
+        0x0000, 0xAA51, 0x4483, 0xEED2, 0x8906, 0x2357, 0xCD85, 0x67D4,
+        0x022D, 0xA87C, 0x46AE, 0xECFF, 0x8B2B, 0x217A, 0xCFA8, 0x65F9,
+        0x045A, 0xAE0B, 0x40D9, 0xEA88, 0x8D5C, 0x270D, 0xC9DF, 0x638E,
+        0x0677, 0xAC26, 0x42F4, 0xE8A5, 0x8F71, 0x2520, 0xCBF2, 0x61A3,
+        0x08B4, 0xA2E5, 0x4C37, 0xE666, 0x81B2, 0x2BE3, 0xC531, 0x6F60,
+        0x0A99, 0xA0C8, 0x4E1A, 0xE44B, 0x839F, 0x29CE, 0xC71C, 0x6D4D,
+        0x0CEE, 0xA6BF, 0x486D, 0xE23C, 0x85E8, 0x2FB9, 0xC16B, 0x6B3A,
+        0x0EC3, 0xA492, 0x4A40, 0xE011, 0x87C5, 0x2D94, 0xC346, 0x6917,
+        0x1168, 0xBB39, 0x55EB, 0xFFBA, 0x986E, 0x323F, 0xDCED, 0x76BC,
+        0x1345, 0xB914, 0x57C6, 0xFD97, 0x9A43, 0x3012, 0xDEC0, 0x7491,
+        0x1532, 0xBF63, 0x51B1, 0xFBE0, 0x9C34, 0x3665, 0xD8B7, 0x72E6,
+        0x171F, 0xBD4E, 0x539C, 0xF9CD, 0x9E19, 0x3448, 0xDA9A, 0x70CB,
+        0x19DC, 0xB38D, 0x5D5F, 0xF70E, 0x90DA, 0x3A8B, 0xD459, 0x7E08,
+        0x1BF1, 0xB1A0, 0x5F72, 0xF523, 0x92F7, 0x38A6, 0xD674, 0x7C25,
+        0x1D86, 0xB7D7, 0x5905, 0xF354, 0x9480, 0x3ED1, 0xD003, 0x7A52,
+        0x1FAB, 0xB5FA, 0x5B28, 0xF179, 0x96AD, 0x3CFC, 0xD22E, 0x787F,
+        0x22D0, 0x8881, 0x6653, 0xCC02, 0xABD6, 0x0187, 0xEF55, 0x4504,
+        0x20FD, 0x8AAC, 0x647E, 0xCE2F, 0xA9FB, 0x03AA, 0xED78, 0x4729,
+        0x268A, 0x8CDB, 0x6209, 0xC858, 0xAF8C, 0x05DD, 0xEB0F, 0x415E,
+        0x24A7, 0x8EF6, 0x6024, 0xCA75, 0xADA1, 0x07F0, 0xE922, 0x4373,
+        0x2A64, 0x8035, 0x6EE7, 0xC4B6, 0xA362, 0x0933, 0xE7E1, 0x4DB0,
+        0x2849, 0x8218, 0x6CCA, 0xC69B, 0xA14F, 0x0B1E, 0xE5CC, 0x4F9D,
+        0x2E3E, 0x846F, 0x6ABD, 0xC0EC, 0xA738, 0x0D69, 0xE3BB, 0x49EA,
+        0x2C13, 0x8642, 0x6890, 0xC2C1, 0xA515, 0x0F44, 0xE196, 0x4BC7,
+        0x33B8, 0x99E9, 0x773B, 0xDD6A, 0xBABE, 0x10EF, 0xFE3D, 0x546C,
+        0x3195, 0x9BC4, 0x7516, 0xDF47, 0xB893, 0x12C2, 0xFC10, 0x5641,
+        0x37E2, 0x9DB3, 0x7361, 0xD930, 0xBEE4, 0x14B5, 0xFA67, 0x5036,
+        0x35CF, 0x9F9E, 0x714C, 0xDB1D, 0xBCC9, 0x1698, 0xF84A, 0x521B,
+        0x3B0C, 0x915D, 0x7F8F, 0xD5DE, 0xB20A, 0x185B, 0xF689, 0x5CD8,
+        0x3921, 0x9370, 0x7DA2, 0xD7F3, 0xB027, 0x1A76, 0xF4A4, 0x5EF5,
+        0x3F56, 0x9507, 0x7BD5, 0xD184, 0xB650, 0x1C01, 0xF2D3, 0x5882,
+        0x3D7B, 0x972A, 0x79F8, 0xD3A9, 0xB47D, 0x1E2C, 0xF0FE, 0x5AAF
+    },
+    {
+        0x0000, 0x45A0, 0x8B40, 0xCEE0, 0x06A1, 0x4301, 0x8DE1, 0xC841,
+        0x0D42, 0x48E2, 0x8602, 0xC3A2, 0x0BE3, 0x4E43, 0x80A3, 0xC503,
+        0x1A84, 0x5F24, 0x91C4, 0xD464, 0x1C25, 0x5985, 0x9765, 0xD2C5,
+        0x17C6, 0x5266, 0x9C86, 0xD926, 0x1167, 0x54C7, 0x9A27, 0xDF87,
+        0x3508, 0x70A8, 0xBE48, 0xFBE8, 0x33A9, 0x7609, 0xB8E9, 0xFD49,
+        0x384A, 0x7DEA, 0xB30A, 0xF6AA, 0x3EEB, 0x7B4B, 0xB5AB, 0xF00B,
+        0x2F8C, 0x6A2C, 0xA4CC, 0xE16C, 0x292D, 0x6C8D, 0xA26D, 0xE7CD,
+        0x22CE, 0x676E, 0xA98E, 0xEC2E, 0x246F, 0x61CF, 0xAF2F, 0xEA8F,
+        0x6A10, 0x2FB0, 0xE150, 0xA4F0, 0x6CB1, 0x2911, 0xE7F1, 0xA251,
+        0x6752, 0x22F2, 0xEC12, 0xA9B2, 0x61F3, 0x2453, 0xEAB3, 0xAF13,
+        0x7094, 0x3534, 0xFBD4, 0xBE74, 0x7635, 0x3395, 0xFD75, 0xB8D5,
+        0x7DD6, 0x3876, 0xF696, 0xB336, 0x7B77, 0x3ED7, 0xF037, 0xB597,
+        0x5F18, 0x1AB8, 0xD458, 0x91F8, 0x59B9, 0x1C19, 0xD2F9, 0x9759,
+        0x525A, 0x17FA, 0xD91A, 0x9CBA, 0x54FB, 0x115B, 0xDFBB, 0x9A1B,
+        0x459C, 0x003C, 0xCEDC, 0x8B7C, 0x433D, 0x069D, 0xC87D, 0x8DDD,
+        0x48DE, 0x0D7E, 0xC39E, 0x863E, 0x4E7F, 0x0BDF, 0xC53F, 0x809F,
+        0xD420, 0x9180, 0x5F60, 0x1AC0, 0xD281, 0x9721, 0x59C1, 0x1C61,
+        0xD962, 0x9CC2, 0x5222, 0x1782, 0xDFC3, 0x9A63, 0x5483, 0x1123,
+        0xCEA4, 0x8B04, 0x45E4, 0x0044, 0xC805, 0x8DA5, 0x4345, 0x06E5,
+        0xC3E6, 0x8646, 0x48A6, 0x0D06, 0xC547, 0x80E7, 0x4E07, 0x0BA7,
+        0xE128, 0xA488, 0x6A68, 0x2FC8, 0xE789, 0xA229, 0x6CC9, 0x2969,
+        0xEC6A, 0xA9CA, 0x672A, 0x228A, 0xEACB, 0xAF6B, 0x618B, 0x242B,
+        0xFBAC, 0xBE0C, 0x70EC, 0x354C, 0xFD0D, 0xB8AD, 0x764D, 0x33ED,
+        0xF6EE, 0xB34E, 0x7DAE, 0x380E, 0xF04F, 0xB5EF, 0x7B0F, 0x3EAF,
+        0xBE30, 0xFB90, 0x3570, 0x70D0, 0xB891, 0xFD31, 0x33D1, 0x7671,
+        0xB372, 0xF6D2, 0x3832, 0x7D92, 0xB5D3, 0xF073, 0x3E93, 0x7B33,
+        0xA4B4, 0xE114, 0x2FF4, 0x6A54, 0xA215, 0xE7B5, 0x2955, 0x6CF5,
+        0xA9F6, 0xEC56, 0x22B6, 0x6716, 0xAF57, 0xEAF7, 0x2417, 0x61B7,
+        0x8B38, 0xCE98, 0x0078, 0x45D8, 0x8D99, 0xC839, 0x06D9, 0x4379,
+        0x867A, 0xC3DA, 0x0D3A, 0x489A, 0x80DB, 0xC57B, 0x0B9B, 0x4E3B,
+        0x91BC, 0xD41C, 0x1AFC, 0x5F5C, 0x971D, 0xD2BD, 0x1C5D, 0x59FD,
+        0x9CFE, 0xD95E, 0x17BE, 0x521E, 0x9A5F, 0xDFFF, 0x111F, 0x54BF
+    },
+    {
+        0x0000, 0xB861, 0x60E3, 0xD882, 0xC1C6, 0x79A7, 0xA125, 0x1944,
+        0x93AD, 0x2BCC, 0xF34E, 0x4B2F, 0x526B, 0xEA0A, 0x3288, 0x8AE9,
+        0x377B, 0x8F1A, 0x5798, 0xEFF9, 0xF6BD, 0x4EDC, 0x965E, 0x2E3F,
+        0xA4D6, 0x1CB7, 0xC435, 0x7C54, 0x6510, 0xDD71, 0x05F3, 0xBD92,
+        0x6EF6, 0xD697, 0x0E15, 0xB674, 0xAF30, 0x1751, 0xCFD3, 0x77B2,
+        0xFD5B, 0x453A, 0x9DB8, 0x25D9, 0x3C9D, 0x84FC, 0x5C7E, 0xE41F,
+        0x598D, 0xE1EC, 0x396E, 0x810F, 0x984B, 0x202A, 0xF8A8, 0x40C9,
+        0xCA20, 0x7241, 0xAAC3, 0x12A2, 0x0BE6, 0xB387, 0x6B05, 0xD364,
+        0xDDEC, 0x658D, 0xBD0F, 0x056E, 0x1C2A, 0xA44B, 0x7CC9, 0xC4A8,
+        0x4E41, 0xF620, 0x2EA2, 0x96C3, 0x8F87, 0x37E6, 0xEF64, 0x5705,
+        0xEA97, 0x52F6, 0x8A74, 0x3215, 0x2B51, 0x9330, 0x4BB2, 0xF3D3,
+        0x793A, 0xC15B, 0x19D9, 0xA1B8, 0xB8FC, 0x009D, 0xD81F, 0x607E,
+        0xB31A, 0x0B7B, 0xD3F9, 0x6B98, 0x72DC, 0xCABD, 0x123F, 0xAA5E,
+        0x20B7, 0x98D6, 0x4054, 0xF835, 0xE171, 0x5910, 0x8192, 0x39F3,
+        0x8461, 0x3C00, 0xE482, 0x5CE3, 0x45A7, 0xFDC6, 0x2544, 0x9D25,
+        0x17CC, 0xAFAD, 0x772F, 0xCF4E, 0xD60A, 0x6E6B, 0xB6E9, 0x0E88,
+        0xABF9, 0x1398, 0xCB1A, 0x737B, 0x6A3F, 0xD25E, 0x0ADC, 0xB2BD,
+        0x3854, 0x8035, 0x58B7, 0xE0D6, 0xF992, 0x41F3, 0x9971, 0x2110,
+        0x9C82, 0x24E3, 0xFC61, 0x4400, 0x5D44, 0xE525, 0x3DA7, 0x85C6,
+        0x0F2F, 0xB74E, 0x6FCC, 0xD7AD, 0xCEE9, 0x7688, 0xAE0A, 0x166B,
+        0xC50F, 0x7D6E, 0xA5EC, 0x1D8D, 0x04C9, 0xBCA8, 0x642A, 0xDC4B,
+        0x56A2, 0xEEC3, 0x3641, 0x8E20, 0x9764, 0x2F05, 0xF787, 0x4FE6,
+        0xF274, 0x4A15, 0x9297, 0x2AF6, 0x33B2, 0x8BD3, 0x5351, 0xEB30,
+        0x61D9, 0xD9B8, 0x013A, 0xB95B, 0xA01F, 0x187E, 0xC0FC, 0x789D,
+        0x7615, 0xCE74, 0x16F6, 0xAE97, 0xB7D3, 0x0FB2, 0xD730, 0x6F51,
+        0xE5B8, 0x5DD9, 0x855B, 0x3D3A, 0x247E, 0x9C1F, 0x449D, 0xFCFC,
+        0x416E, 0xF90F, 0x218D, 0x99EC, 0x80A8, 0x38C9, 0xE04B, 0x582A,
+        0xD2C3, 0x6AA2, 0xB220, 0x0A41, 0x1305, 0xAB64, 0x73E6, 0xCB87,
+        0x18E3, 0xA082, 0x7800, 0xC061, 0xD925, 0x6144, 0xB9C6, 0x01A7,
+        0x8B4E, 0x332F, 0xEBAD, 0x53CC, 0x4A88, 0xF2E9, 0x2A6B, 0x920A,
+        0x2F98, 0x97F9, 0x4F7B, 0xF71A, 0xEE5E, 0x563F, 0x8EBD, 0x36DC,
+        0xBC35, 0x0454, 0xDCD6, 0x64B7, 0x7DF3, 0xC592, 0x1D10, 0xA571
+    },
+    {
+        0x0000, 0x47D3, 0x8FA6, 0xC875, 0x0F6D, 0x48BE, 0x80CB, 0xC718,
+        0x1EDA, 0x5909, 0x917C, 0xD6AF, 0x11B7, 0x5664, 0x9E11, 0xD9C2,
+        0x3DB4, 0x7A67, 0xB212, 0xF5C1, 0x32D9, 0x750A, 0xBD7F, 0xFAAC,
+        0x236E, 0x64BD, 0xACC8, 0xEB1B, 0x2C03, 0x6BD0, 0xA3A5, 0xE476,
+        0x7B68, 0x3CBB, 0xF4CE, 0xB31D, 0x7405, 0x33D6, 0xFBA3, 0xBC70,
+        0x65B2, 0x2261, 0xEA14, 0xADC7, 0x6ADF, 0x2D0C, 0xE579, 0xA2AA,
+        0x46DC, 0x010F, 0xC97A, 0x8EA9, 0x49B1, 0x0E62, 0xC617, 0x81C4,
+        0x5806, 0x1FD5, 0xD7A0, 0x9073, 0x576B, 0x10B8, 0xD8CD, 0x9F1E,
+        0xF6D0, 0xB103, 0x7976, 0x3EA5, 0xF9BD, 0xBE6E, 0x761B, 0x31C8,
+        0xE80A, 0xAFD9, 0x67AC, 0x207F, 0xE767, 0xA0B4, 0x68C1, 0x2F12,
+        0xCB64, 0x8CB7, 0x44C2, 0x0311, 0xC409, 0x83DA, 0x4BAF, 0x0C7C,
+        0xD5BE, 0x926D, 0x5A18, 0x1DCB, 0xDAD3, 0x9D00, 0x5575, 0x12A6,
+        0x8DB8, 0xCA6B, 0x021E, 0x45CD, 0x82D5, 0xC506, 0x0D73, 0x4AA0,
+        0x9362, 0xD4B1, 0x1CC4, 0x5B17, 0x9C0F, 0xDBDC, 0x13A9, 0x547A,
+        0xB00C, 0xF7DF, 0x3FAA, 0x7879, 0xBF61, 0xF8B2, 0x30C7, 0x7714,
+        0xAED6, 0xE905, 0x2170, 0x66A3, 0xA1BB, 0xE668, 0x2E1D, 0x69CE,
+        0xFD81, 0xBA52, 0x7227, 0x35F4, 0xF2EC, 0xB53F, 0x7D4A, 0x3A99,
+        0xE35B, 0xA488, 0x6CFD, 0x2B2E, 0xEC36, 0xABE5, 0x6390, 0x2443,
+        0xC035, 0x87E6, 0x4F93, 0x0840, 0xCF58, 0x888B, 0x40FE, 0x072D,
+        0xDEEF, 0x993C, 0x5149, 0x169A, 0xD182, 0x9651, 0x5E24, 0x19F7,
+        0x86E9, 0xC13A, 0x094F, 0x4E9C, 0x8984, 0xCE57, 0x0622, 0x41F1,
+        0x9833, 0xDFE0, 0x1795, 0x5046, 0x975E, 0xD08D, 0x18F8, 0x5F2B,
+        0xBB5D, 0xFC8E, 0x34FB, 0x7328, 0xB430, 0xF3E3, 0x3B96, 0x7C45,
+        0xA587, 0xE254, 0x2A21, 0x6DF2, 0xAAEA, 0xED39, 0x254C, 0x629F,
+        0x0B51, 0x4C82, 0x84F7, 0xC324, 0x043C, 0x43EF, 0x8B9A, 0xCC49,
+        0x158B, 0x5258, 0x9A2D, 0xDDFE, 0x1AE6, 0x5D35, 0x9540, 0xD293,
+        0x36E5, 0x7136, 0xB943, 0xFE90, 0x3988, 0x7E5B, 0xB62E, 0xF1FD,
+        0x283F, 0x6FEC, 0xA799, 0xE04A, 0x2752, 0x6081, 0xA8F4, 0xEF27,
+        0x7039, 0x37EA, 0xFF9F, 0xB84C, 0x7F54, 0x3887, 0xF0F2, 0xB721,
+        0x6EE3, 0x2930, 0xE145, 0xA696, 0x618E, 0x265D, 0xEE28, 0xA9FB,
+        0x4D8D, 0x0A5E, 0xC22B, 0x85F8, 0x42E0, 0x0533, 0xCD46, 0x8A95,
+        0x5357, 0x1484, 0xDCF1, 0x9B22, 0x5C3A, 0x1BE9, 0xD39C, 0x944F
+    },
+#endif
+};
+
+/* 单字节查表更新 */
+#define CRC16_UPDATE_BYTE(crc, byte) \
+    ((uint16_t)(((crc) << 8) ^ crc16_table[0][(((crc) >> 8) ^ (byte)) & 0xFF]))
+#else
+/**
+  * @brief  CRC16-CCITT逐位更新一个字节
+  * @param  crc  : 当前CRC值
+  * @param  byte : 输入字节
+  * @retval 更新后的CRC值
+  */
+static uint16_t crc16_update_bitwise(uint16_t crc, uint8_t byte)
+{
+    uint8_t i;
+    
+    crc ^= (uint16_t)byte << 8;
+    for (i = 0; i < 8; i++) {
+        if (crc & 0x8000) {
+            crc = (crc << 1) ^ 0x1021;
+        } else {
+            crc <<= 1;
+        }
+    }
+    return crc;
+}
+
+#define CRC16_UPDATE_BYTE(crc, byte)  crc16_update_bitwise((crc), (byte))
+#endif /* CRC16_TABLE_NUM */
+
+/* 实例的校验算法：未选择（NULL）时为内置CRC16，逐字节更新仍内联查表 */
+#if DATA_COMM_CHECKSUM
+static uint32_t csum_update_byte(DataCommHandle *handle, uint32_t state, uint8_t byte)
+{
+    return handle->checksum->update(state, &byte, 1);
+}
+
+#define CRC_INIT(handle)        ((handle)->checksum != NULL ? (handle)->checksum->init : CRC16_INIT)
+#define CRC_SIZE(handle)        ((handle)->checksum != NULL ? (handle)->checksum->size : 2)
+#define CRC_UPDATE_BYTE(handle, crc, byte) \
+    ((handle)->checksum != NULL ? csum_update_byte((handle), (crc), (byte)) : CRC16_UPDATE_BYTE((crc), (byte)))
+#define CRC_UPDATE(handle, crc, data, len) \
+    ((handle)->checksum != NULL ? (handle)->checksum->update((crc), (data), (len)) : data_comm_crc16((uint16_t)(crc), (data), (len)))
+#define CRC_FINAL(handle, crc) \
+    (((handle)->checksum != NULL && (handle)->checksum->final != NULL) ? (handle)->checksum->final(crc) : (crc))
+#else
+#define CRC_INIT(handle)                    CRC16_INIT
+#define CRC_SIZE(handle)                    2
+#define CRC_UPDATE_BYTE(handle, crc, byte)  CRC16_UPDATE_BYTE((crc), (byte))
+#define CRC_UPDATE(handle, crc, data, len)  data_comm_crc16((crc), (data), (len))
+#define CRC_FINAL(handle, crc)              (crc)
+#endif
+#endif /* USE_CRC16 */
+
+/**
+  * @brief  默认实例的发送函数，转发到user_transmit()
+  */
+static void default_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    user_transmit(data, len);
+}
+
+/**
+  * @brief  默认实例的数据包回调，转发到user_packet_handler()
+  */
+static void default_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    user_packet_handler(cmd, data, len);
+}
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  默认实例的异步发送函数，转发到user_transmit_async()
+  */
+static void default_transmit_async(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    user_transmit_async(data, len);
+}
+#endif
+
+#if DATA_COMM_CAPTURE
+#if DATA_COMM_CAPTURE_RING_SIZE > 0
+/**
+  * @brief  向环形缓冲区写入数据（调用者保证空间足够）
+  */
+static void cap_ring_put(const uint8_t *data, uint16_t len)
+{
+    uint32_t pos = g_cap_ring.head % DATA_COMM_CAPTURE_RING_SIZE;
+    uint32_t first = DATA_COMM_CAPTURE_RING_SIZE - pos;
+    
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&g_cap_ring.buf[pos], data, first);
+    memcpy(g_cap_ring.buf, data + first, len - first);
+    g_cap_ring.head += len;
+}
+
+/**
+  * @brief  内置环形缓冲区输出函数：空间不足时丢弃最早的完整记录
+  */
+static void cap_ring_sink(DataCommHandle *handle, const uint8_t *head, uint8_t head_len,
+                          const uint8_t *data, uint16_t data_len)
+{
+    uint32_t total = (uint32_t)head_len + data_len;
+    uint32_t len_pos;
+    
+    (void)handle;
+    DATA_COMM_CAPTURE_LOCK();
+    if (total > DATA_COMM_CAPTURE_RING_SIZE) {
+        g_cap_ring.dropped++;
+        DATA_COMM_CAPTURE_UNLOCK();
+        return;
+    }
+    while (DATA_COMM_CAPTURE_RING_SIZE - (g_cap_ring.head - g_cap_ring.tail) < total) {
+        len_pos = g_cap_ring.tail + 2;
+        g_cap_ring.tail += DATA_COMM_CAP_HEAD_SIZE +
+                           (((uint32_t)g_cap_ring.buf[len_pos % DATA_COMM_CAPTURE_RING_SIZE] << 8) |
+                            g_cap_ring.buf[(len_pos + 1) % DATA_COMM_CAPTURE_RING_SIZE]);
+        g_cap_ring.dropped++;
+    }
+    cap_ring_put(head, head_len);
+    cap_ring_put(data, data_len);
+    DATA_COMM_CAPTURE_UNLOCK();
+}
+#endif
+
+/**
+  * @brief  输出一条抓包记录
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  type   : 记录类型
+  * @param  time   : 时间戳
+  * @param  cmd    : FRAME记录的命令字节（其他类型忽略）
+  * @param  data   : 记录数据
+  * @param  len    : 记录数据长度（FRAME记录不含命令字节）
+  * @retval 无
+  */
+static void capture_emit(DataCommHandle *handle, uint8_t type, uint32_t time, uint8_t cmd,
+                         const uint8_t *data, uint16_t len)
+{
+    uint8_t head[DATA_COMM_CAP_HEAD_SIZE + 1];
+    uint16_t rec_len = (type == DATA_COMM_CAP_FRAME) ? (uint16_t)(len + 1) : len;
+    
+    head[0] = type;
+    head[1] = handle->cap_link;
+    head[2] = (uint8_t)(rec_len >> 8);
+    head[3] = (uint8_t)rec_len;
+    head[4] = (uint8_t)(time >> 24);
+    head[5] = (uint8_t)(time >> 16);
+    head[6] = (uint8_t)(time >> 8);
+    head[7] = (uint8_t)time;
+    head[8] = cmd;
+    
+#if DATA_COMM_CAPTURE_RING_SIZE > 0
+    if (handle->cap_sink == NULL) {
+        cap_ring_sink(handle, head, (uint8_t)(DATA_COMM_CAP_HEAD_SIZE + rec_len - len), data, len);
+        return;
+    }
+#endif
+    if (handle->cap_sink != NULL) {
+        handle->cap_sink(handle, head, (uint8_t)(DATA_COMM_CAP_HEAD_SIZE + rec_len - len), data, len);
+    }
+}
+
+/**
+  * @brief  输出暂存的逐字节接收数据
+  */
+static void capture_rx_flush(DataCommHandle *handle)
+{
+    if (handle->cap_rx_len > 0) {
+        capture_emit(handle, DATA_COMM_CAP_RX, handle->cap_rx_time, 0, handle->cap_rx_buf, handle->cap_rx_len);
+        handle->cap_rx_len = 0;
+    }
+}
+
+/**
+  * @brief  暂存一个逐字节接收的字节，满DATA_COMM_CAPTURE_CHUNK字节输出一条记录
+  */
+static void capture_rx_byte(DataCommHandle *handle, uint8_t byte)
+{
+    if (handle->cap_rx_len == 0) {
+        handle->cap_rx_time = DATA_COMM_CAPTURE_TIME();
+    }
+    handle->cap_rx_buf[handle->cap_rx_len++] = byte;
+    if (handle->cap_rx_len >= DATA_COMM_CAPTURE_CHUNK) {
+        capture_rx_flush(handle);
+    }
+}
+
+/**
+  * @brief  记录批量接收的数据块（先输出暂存的逐字节数据，超过65535字节时分为多条）
+  */
+static void capture_rx_block(DataCommHandle *handle, const uint8_t *buf, size_t len)
+{
+    uint32_t time = DATA_COMM_CAPTURE_TIME();
+    uint16_t n;
+    
+    capture_rx_flush(handle);
+    while (len > 0) {
+        n = (len > 0xFFFF) ? 0xFFFF : (uint16_t)len;
+        capture_emit(handle, DATA_COMM_CAP_RX, time, 0, buf, n);
+        buf += n;
+        len -= n;
+    }
+}
+#endif
+
+#if DATA_COMM_FRAG
+/**
+  * @brief  中止正在重组的数据块
+  */
+static void frag_abort(DataCommHandle *handle)
+{
+    handle->frag_rx_active = 0;
+    handle->frag_rx_err++;
+    handle->config.stream->end(handle, 0);
+}
+
+/**
+  * @brief  接收一个分片，按顺序交给config.stream回调
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  data   : 分片载荷：编号(1) + 命令(1) + 偏移(4) + 总长度(4) + 数据(n)
+  * @param  len    : 分片载荷长度
+  * @retval 无
+  * @note   偏移为0的分片开始新数据块（未完成的数据块被中止）；其后分片须按偏移连续到达，
+  *         丢失或乱序时中止，等待下一个数据块从头重发；begin回调拒绝的数据块其余分片被忽略
+  */
+static void frag_receive(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    const DataCommStreamOps *ops = handle->config.stream;
+    uint32_t offset, total;
+    uint16_t n;
+    
+    if (ops == NULL || len < DATA_COMM_FRAG_HEADER) {
+        handle->cmd_len_err++;
+        return;
+    }
+    offset = ((uint32_t)data[2] << 24) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+    total = ((uint32_t)data[6] << 24) | ((uint32_t)data[7] << 16) | ((uint32_t)data[8] << 8) | data[9];
+    n = (uint16_t)(len - DATA_COMM_FRAG_HEADER);
+    
+    if (offset == 0) {
+        if (handle->frag_rx_active) {
+            frag_abort(handle);
+        }
+        handle->frag_rx_active = ops->begin(handle, data[1], total) ? 1 : 0;
+        handle->frag_rx_id = data[0];
+        handle->frag_rx_next = 0;
+        handle->frag_rx_total = total;
+    }
+    if (!handle->frag_rx_active) {
+        return;     /* 未在重组，或数据块被begin拒绝 */
+    }
+    if (data[0] != handle->frag_rx_id || offset != handle->frag_rx_next ||
+        total != handle->frag_rx_total || n > total - offset) {
+        frag_abort(handle);
+        return;
+    }
+    if (n > 0) {
+        ops->chunk(handle, &data[DATA_COMM_FRAG_HEADER], n);
+    }
+    handle->frag_rx_next += n;
+    if (handle->frag_rx_next == total) {
+        handle->frag_rx_active = 0;
+        ops->end(handle, 1);
+    }
+}
+#endif
+
+#if DATA_COMM_STREAM
+/**
+  * @brief  在命令字节处决定本帧是否流式接收
+  * @param  handle : 协议实例句柄（非NULL）
+  * @retval PKG_OK-继续接收，PKG_LENGTH_ERR-载荷超过MAX_DATA_LENGTH且未被流式接收
+  * @note   库内部使用的命令（分片、合并、可靠传输）总是缓存后交付；
+  *         一个实例同一时刻只有一个流式会话，正在重组的分片数据块先被中止
+  */
+static PkgStatus stream_begin(DataCommHandle *handle)
+{
+    ParseContext *ctx = &handle->rx;
+    const DataCommStreamOps *ops = handle->config.stream;
+    uint8_t internal = 0;
+    
+#if DATA_COMM_FRAG
+    internal |= (ctx->cmd == DATA_COMM_FRAG_CMD);
+#endif
+#if DATA_COMM_BATCH
+    internal |= (ctx->cmd == DATA_COMM_BATCH_CMD);
+#endif
+#if DATA_COMM_RELIABLE
+    internal |= (ctx->cmd == DATA_COMM_REL_CMD || ctx->cmd == DATA_COMM_REL_ACK_CMD);
+#endif
+    
+    ctx->streaming = 0;
+    ctx->stream_fill = 0;
+#if DATA_COMM_FRAG
+    if (ops != NULL && !internal && handle->frag_rx_active) {
+        frag_abort(handle);
+    }
+#endif
+    if (ops != NULL && !internal && ops->begin(handle, ctx->cmd, (uint32_t)(ctx->pkg_length - 1))) {
+        ctx->streaming = 1;
+    } else if (ctx->pkg_length > MAX_DATA_LENGTH + 1) {
+        return PKG_LENGTH_ERR;
+    }
+    return PKG_OK;
+}
+
+/**
+  * @brief  把逐字节接收暂存的载荷交给chunk回调
+  */
+static void stream_flush(DataCommHandle *handle)
+{
+    ParseContext *ctx = &handle->rx;
+    
+    if (ctx->stream_fill > 0) {
+        handle->config.stream->chunk(handle, ctx->data, ctx->stream_fill);
+        ctx->stream_fill = 0;
+    }
+}
+
+/**
+  * @brief  结束流式帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  ok     : 1-帧完整且校验通过，0-出错中止
+  */
+static void stream_end(DataCommHandle *handle, uint8_t ok)
+{
+    handle->rx.streaming = 0;
+    if (ok) {
+        STATS_INC(handle, frames_ok);
+#if DATA_COMM_STATS && DATA_COMM_STATS_CYCLES
+        handle->cycles_acc = 0;
+#endif
+    }
+    handle->config.stream->end(handle, ok);
+}
+#endif
+
+#if DATA_COMM_BATCH || DATA_COMM_RELIABLE
+static void packet_deliver(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len);
+#endif
+
+#if DATA_COMM_BATCH
+/**
+  * @brief  拆分合并帧，逐条交付其中的消息
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  data   : 合并帧载荷：[命令(1) + 长度(1) + 数据(n)] × 消息数
+  * @param  len    : 合并帧载荷长度
+  * @retval 无
+  * @note   消息格式错误（越界或嵌套合并帧）时丢弃剩余部分，计入命令长度错误
+  */
+static void batch_unpack(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    uint16_t i = 0;
+    
+    while (i < len) {
+        if (len - i < 2 || data[i] == DATA_COMM_BATCH_CMD || data[i + 1] > len - i - 2) {
+            handle->cmd_len_err++;
+            return;
+        }
+        packet_deliver(handle, data[i], &data[i + 2], data[i + 1]);
+        i += 2 + data[i + 1];
+    }
+}
+#endif
+
+#if DATA_COMM_RELIABLE
+/**
+  * @brief  发送（或重传）发送窗口中的一条消息
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  seq    : 消息序号
+  * @retval 无
+  * @note   帧格式：DATA_COMM_REL_CMD + [会话号 + 标志 + 序号 + 窗口起点 + 命令 + 数据]
+  *         收到本会话的确认前带DATA_COMM_REL_FLAG_SYN；发送队列已满时保持未发送状态，由data_comm_tick()补发
+  */
+static void rel_transmit(DataCommHandle *handle, uint8_t seq)
+{
+    DataCommRelSlot *slot = &handle->rel_tx[seq % DATA_COMM_REL_WINDOW];
+    uint8_t header[DATA_COMM_REL_HEADER];
+    DataCommIovec iov[2];
+    
+    header[0] = handle->rel_session;
+    header[1] = handle->rel_syn ? DATA_COMM_REL_FLAG_SYN : 0;
+    header[2] = seq;
+    header[3] = handle->rel_snd_una;
+    header[4] = slot->cmd;
+    iov[0].data = header;
+    iov[0].len = DATA_COMM_REL_HEADER;
+    iov[1].data = slot->data;
+    iov[1].len = slot->len;
+    
+    if (data_comm_sendv(handle, DATA_COMM_REL_CMD, iov, 2) == 0) {
+        return;
+    }
+    if (slot->sent) {
+        handle->rel_retransmits++;
+    }
+    slot->sent = 1;
+    slot->sent_time = handle->tick_now;
+}
+
+/**
+  * @brief  处理收到的可靠数据帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  data   : 帧载荷：会话号 + 标志 + 序号 + 窗口起点 + 命令 + 数据
+  * @param  len    : 帧载荷长度
+  * @retval 无
+  * @note   带DATA_COMM_REL_FLAG_SYN的帧表示对端刚开始会话，从其窗口起点重新接收（即使会话号与之前相同）；
+  *         同一会话建立期间重发的此类帧不再重新开始，直到收到该会话的普通数据帧。
+  *         窗口内首次收到的消息立即交付，重复消息只确认不交付；无论哪种情况都在下次data_comm_tick()时回复确认
+  */
+static void rel_receive(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    uint8_t syn, offset;
+    
+    if (len < DATA_COMM_REL_HEADER || data[0] == 0 ||
+        data[4] == DATA_COMM_REL_CMD || data[4] == DATA_COMM_REL_ACK_CMD) {
+        handle->cmd_len_err++;
+        return;
+    }
+    syn = data[1] & DATA_COMM_REL_FLAG_SYN;
+    
+    /* 对端建立会话（复位或首次通信），或本端复位后收到未知会话：从其窗口起点开始 */
+    if (data[0] != handle->rel_rx_session || (syn && !handle->rel_rx_syn)) {
+        handle->rel_rx_session = data[0];
+        handle->rel_rcv_nxt = data[3];
+        handle->rel_rcv_mask = 0;
+        handle->rel_resyncs++;
+    }
+    handle->rel_rx_syn = syn;
+    
+    offset = (uint8_t)(data[2] - handle->rel_rcv_nxt);
+    if (offset < DATA_COMM_REL_WINDOW && !(handle->rel_rcv_mask & (1UL << offset))) {
+        handle->rel_rcv_mask |= 1UL << offset;
+        packet_deliver(handle, data[4], &data[DATA_COMM_REL_HEADER], len - DATA_COMM_REL_HEADER);
+        
+        /* 连续收到的部分滑出窗口 */
+        while (handle->rel_rcv_mask & 1) {
+            handle->rel_rcv_mask >>= 1;
+            handle->rel_rcv_nxt++;
+        }
+    }
+    handle->rel_ack_pending = 1;
+}
+
+/**
+  * @brief  处理收到的确认帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  data   : 帧载荷：会话号 + 标志 + 累计确认序号 + 选择确认位图(4，大端序)
+  * @param  len    : 帧载荷长度
+  * @retval 无
+  * @note   会话建立期间只接受带DATA_COMM_REL_FLAG_SYN的确认（对端已按本次会话重新开始接收），
+  *         之前到达的是对端对旧会话状态的确认，不能用来释放消息。
+  *         累计确认序号之前的消息全部释放；位图中bit i表示序号（累计确认序号 + i）已收到，
+  *         位于已收到消息之前的空缺在下次data_comm_tick()时重传（快速重传），无需等待超时
+  */
+static void rel_ack_receive(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    uint8_t cum, inflight, top, i;
+    uint32_t mask;
+    DataCommRelSlot *slot;
+    
+    if (len != 7 || data[0] != handle->rel_session || handle->rel_session == 0) {
+        return;     /* 旧会话的确认 */
+    }
+    if (handle->rel_syn && !(data[1] & DATA_COMM_REL_FLAG_SYN)) {
+        return;     /* 对端尚未收到本次会话的数据帧 */
+    }
+    cum = data[2];
+    mask = ((uint32_t)data[3] << 24) | ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 8) | data[6];
+    
+    /* 1. 累计确认：释放窗口起点到cum之间的消息 */
+    inflight = (uint8_t)(handle->rel_snd_nxt - handle->rel_snd_una);
+    if ((uint8_t)(cum - handle->rel_snd_una) > inflight) {
+        return;     /* 串口按序送达，本会话的确认序号不会后退，窗口外的确认不属于本次会话 */
+    }
+    handle->rel_syn = 0;
+    while (handle->rel_snd_una != cum) {
+        handle->rel_tx[handle->rel_snd_una % DATA_COMM_REL_WINDOW].state = 0;
+        handle->rel_snd_una++;
+    }
+    
+    /* 2. 选择确认：找到已收到的最高位置，其前的空缺标记为快速重传 */
+    inflight = (uint8_t)(handle->rel_snd_nxt - cum);
+    for (top = inflight; top > 0 && !(mask & (1UL << (top - 1))); top--) {
+    }
+    for (i = 0; i < top; i++) {
+        slot = &handle->rel_tx[(uint8_t)(cum + i) % DATA_COMM_REL_WINDOW];
+        if (mask & (1UL << i)) {
+            slot->state = 2;
+        } else if (slot->state == 1 && !slot->fast) {
+            /* 每条消息只快速重传一次，之后的丢失由超时重传恢复 */
+            slot->fast = 1;
+            slot->sent_time = handle->tick_now - DATA_COMM_REL_RTO;
+        }
+    }
+}
+#endif
+
+/**
+  * @brief  向用户交付一个数据包
+  * @note   优先按命令分发表调用对应处理函数，未注册的命令交给packet_handler
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  cmd    : 命令字节
+  * @param  data   : 数据载荷
+  * @param  len    : 数据载荷长度
+  * @retval 无
+  */
+static void packet_deliver(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    const DataCommCmdEntry *entry = NULL;
+    
+#if DATA_COMM_BATCH
+    if (cmd == DATA_COMM_BATCH_CMD) {
+        batch_unpack(handle, data, len);
+        return;
+    }
+#endif
+#if DATA_COMM_FRAG
+    if (cmd == DATA_COMM_FRAG_CMD) {
+        frag_receive(handle, data, len);
+        return;
+    }
+#endif
+#if DATA_COMM_RELIABLE
+    if (cmd == DATA_COMM_REL_CMD) {
+        rel_receive(handle, data, len);
+        return;
+    }
+    if (cmd == DATA_COMM_REL_ACK_CMD) {
+        rel_ack_receive(handle, data, len);
+        return;
+    }
+#endif
+    
+    /* 1. 命令分发表查找：运行时注册优先，其次为常量表，均为O(1) */
+#if DATA_COMM_CMD_REGISTER_MAX > 0
+    if (handle->cmd_index[cmd] != 0) {
+        entry = &handle->cmd_entries[handle->cmd_index[cmd] - 1];
+    } else
+#endif
+    if (handle->config.cmd_table != NULL && handle->config.cmd_table[cmd].handler != NULL) {
+        entry = &handle->config.cmd_table[cmd];
+    }
+    
+    if (entry != NULL) {
+        /* 2. 按命令检查载荷长度，处理函数无需再检查 */
+        if (len < entry->min_len || len > entry->max_len) {
+            handle->cmd_len_err++;
+            return;
+        }
+        entry->handler(handle, cmd, data, len);
+        return;
+    }
+    
+    /* 3. 未在分发表中的命令交给通用回调 */
+    if (handle->config.packet_handler != NULL) {
+        handle->config.packet_handler(handle, cmd, data, len);
+    } else {
+        handle->cmd_unknown++;
+    }
+}
+
+/**
+  * @brief  处理一个校验通过的完整数据包
+  * @param  handle : 协议实例句柄（非NULL）
+  * @retval 无
+  * @note   启用接收队列时写入队列等待data_comm_poll()处理，否则直接交付
+  */
+static void packet_complete(DataCommHandle *handle)
+{
+    ParseContext *ctx = &handle->rx;
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+    DataCommPacket *slot;
+#endif
+#if DATA_COMM_STATS && DATA_COMM_STATS_CYCLES
+    uint32_t cycles = handle->cycles_acc + (DATA_COMM_CYCLE_COUNT() - handle->cycles_start);
+    
+    handle->stats.parse_cycles_last = cycles;
+    handle->stats.parse_cycles_total += cycles;
+    if (cycles > handle->stats.parse_cycles_max) {
+        handle->stats.parse_cycles_max = cycles;
+    }
+    handle->cycles_acc = 0;
+#endif
+    STATS_INC(handle, frames_ok);
+#if DATA_COMM_CAPTURE
+    if (CAPTURE_ON(handle, DATA_COMM_CAP_FRAME)) {
+        capture_rx_flush(handle);
+        capture_emit(handle, DATA_COMM_CAP_FRAME, DATA_COMM_CAPTURE_TIME(), ctx->cmd, ctx->data, ctx->data_index);
+    }
+#endif
+    
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+    if ((uint8_t)(handle->rx_tail - handle->rx_head) >= DATA_COMM_RX_QUEUE_SIZE) {
+        /* 队列已满，丢弃本帧 */
+        handle->rx_overflow++;
+        return;
+    }
+    slot = &handle->rx_queue[handle->rx_tail % DATA_COMM_RX_QUEUE_SIZE];
+    slot->cmd = ctx->cmd;
+    slot->len = ctx->data_index;
+    memcpy(slot->data, ctx->data, ctx->data_index);
+    DATA_COMM_BARRIER();
+    handle->rx_tail++;
+#else
+    packet_deliver(handle, ctx->cmd, ctx->data, ctx->data_index);
+    PARSE_CYCLES_BEGIN(handle);
+#endif
+}
+
+#if DATA_COMM_STATS
+/**
+  * @brief  统计一次帧错误
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  status : 错误原因
+  * @retval 无
+  */
+static void stats_rx_error(DataCommHandle *handle, PkgStatus status)
+{
+    switch (status) {
+        case PKG_HEADER_ERR: handle->stats.header_err++; break;
+        case PKG_LENGTH_ERR: handle->stats.length_err++; break;
+        case PKG_CRC_ERR:    handle->stats.crc_err++;    break;
+        case PKG_END_ERR:    handle->stats.end_err++;    break;
+        default: break;
+    }
+}
+#endif
+
+/**
+  * @brief  复位解析状态机，等待下一帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @retval 无
+  * @note   帧头帧尾格式回到搜索帧头；COBS格式直接从帧内容开始（分隔符之后即为新帧）
+  */
+static void parse_reset(DataCommHandle *handle)
+{
+    ParseContext *ctx = &handle->rx;
+    
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+    ctx->state = STATE_WAIT_LENGTH_HIGH;
+    ctx->cobs_remaining = 0;
+    ctx->cobs_zero = 0;
+#if USE_CRC16
+    ctx->calc_crc = CRC_INIT(handle);
+#endif
+#else
+    ctx->state = STATE_WAIT_HEADER1;
+#endif
+}
+
+/**
+  * @brief  解析一个字节（状态机主体）
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  byte   : 接收到的字节
+  * @retval PKG_OK-正常推进，其他-本字节导致当前帧被丢弃的原因
+  */
+static PkgStatus parse_step(DataCommHandle *handle, uint8_t byte)
+{
+    ParseContext *ctx = &handle->rx;
+    
+    switch (ctx->state) {
+        case STATE_WAIT_HEADER1:
+            if (byte == ((FRAME_HEADER >> 8) & 0xFF)) {
+                ctx->state = STATE_WAIT_HEADER2;
+            }
+            break;
+            
+        case STATE_WAIT_HEADER2:
+            if (byte == (FRAME_HEADER & 0xFF)) {
+                ctx->state = STATE_WAIT_LENGTH_HIGH;
+#if USE_CRC16
+                ctx->calc_crc = CRC_INIT(handle);
+#endif
+            } else if (byte != ((FRAME_HEADER >> 8) & 0xFF)) {
+                /* 本字节若为帧头第1字节则保持等待第2字节，避免丢失紧随其后的真实帧头 */
+                ctx->state = STATE_WAIT_HEADER1;
+                return PKG_HEADER_ERR;
+            }
+            break;
+            
+        case STATE_WAIT_LENGTH_HIGH:
+            ctx->pkg_length = byte << 8;
+#if USE_CRC16
+            ctx->calc_crc = CRC_UPDATE_BYTE(handle, ctx->calc_crc, byte);
+#endif
+            ctx->state = STATE_WAIT_LENGTH_LOW;
+            break;
+            
+        case STATE_WAIT_LENGTH_LOW:
+            ctx->pkg_length |= byte;
+#if USE_CRC16
+            ctx->calc_crc = CRC_UPDATE_BYTE(handle, ctx->calc_crc, byte);
+#endif
+            
+            /* 长度检查（可能流式接收的帧在命令字节处再按MAX_DATA_LENGTH检查） */
+#if DATA_COMM_STREAM
+            if (ctx->pkg_length == 0 ||
+                ctx->pkg_length > ((handle->config.stream != NULL) ? DATA_COMM_STREAM_MAX_LENGTH : MAX_DATA_LENGTH) + 1) {
+#else
+            if (ctx->pkg_length == 0 || ctx->pkg_length > (MAX_DATA_LENGTH + 1)) {
+#endif
+                ctx->state = STATE_WAIT_HEADER1;
+                return PKG_LENGTH_ERR;
+            }
+            ctx->state = STATE_WAIT_CMD;
+            break;
+            
+        case STATE_WAIT_CMD:
+            ctx->cmd = byte;
+#if USE_CRC16
+            ctx->calc_crc = CRC_UPDATE_BYTE(handle, ctx->calc_crc, byte);
+#endif
+#if DATA_COMM_CHECKSUM
+            ctx->crc_count = 0;
+#endif
+            ctx->data_index = 0;
+#if DATA_COMM_STREAM
+            if (stream_begin(handle) != PKG_OK) {
+                ctx->state = STATE_WAIT_HEADER1;
+                return PKG_LENGTH_ERR;
+            }
+#endif
+            
+            /* 如果只有命令字节，没有数据 */
+            if (ctx->pkg_length == 1) {
+#if USE_CRC16
+                ctx->state = STATE_WAIT_CRC1;
+#else
+                ctx->state = STATE_WAIT_END1;
+#endif
+            } else {
+                ctx->state = STATE_READ_DATA;
+            }
+            break;
+            
+        case STATE_READ_DATA:
+#if DATA_COMM_STREAM
+            if (ctx->streaming) {
+                /* 暂存到data，满或载荷结束时交给chunk回调 */
+                ctx->data[ctx->stream_fill++] = byte;
+                if (ctx->stream_fill >= MAX_DATA_LENGTH || ctx->data_index + 1 >= ctx->pkg_length - 1) {
+                    stream_flush(handle);
+                }
+            } else
+#endif
+            ctx->data[ctx->data_index] = byte;
+#if USE_CRC16
+            ctx->calc_crc = CRC_UPDATE_BYTE(handle, ctx->calc_crc, byte);
+#endif
+            ctx->data_index++;
+            
+            /* 数据接收完成 */
+            if (ctx->data_index >= (ctx->pkg_length - 1)) {
+#if USE_CRC16
+                ctx->state = STATE_WAIT_CRC1;
+#else
+                ctx->state = STATE_WAIT_END1;
+#endif
+            }
+            break;
+            
+#if USE_CRC16
+        case STATE_WAIT_CRC1:
+#if DATA_COMM_CHECKSUM
+            /* 校验值大端序，除最后1字节外都在本状态接收 */
+            ctx->recv_crc = (ctx->crc_count == 0) ? byte : ((ctx->recv_crc << 8) | byte);
+            if (++ctx->crc_count < CRC_SIZE(handle) - 1) {
+                break;
+            }
+#else
+            ctx->recv_crc = byte << 8;
+#endif
+            ctx->state = STATE_WAIT_CRC2;
+            break;
+            
+        case STATE_WAIT_CRC2:
+#if DATA_COMM_CHECKSUM
+            ctx->recv_crc = (ctx->recv_crc << 8) | byte;
+#else
+            ctx->recv_crc |= byte;
+#endif
+            
+            /* CRC校验（CRC已在接收过程中逐字节累计） */
+            if (CRC_FINAL(handle, ctx->calc_crc) != ctx->recv_crc) {
+                /* CRC错误，重新开始 */
+                ctx->state = STATE_WAIT_HEADER1;
+                STREAM_ABORT(handle);
+                return PKG_CRC_ERR;
+            }
+            ctx->state = STATE_WAIT_END1;
+            break;
+#endif
+            
+        case STATE_WAIT_END1:
+            if (byte == ((FRAME_END >> 8) & 0xFF)) {
+                ctx->state = STATE_WAIT_END2;
+            } else {
+                ctx->state = STATE_WAIT_HEADER1;
+                STREAM_ABORT(handle);
+                return PKG_END_ERR;
+            }
+            break;
+            
+        case STATE_WAIT_END2:
+            ctx->state = STATE_WAIT_HEADER1;
+            if (byte != (FRAME_END & 0xFF)) {
+                STREAM_ABORT(handle);
+                return PKG_END_ERR;
+            }
+            /* 完整数据包接收成功，交付或入队（流式帧结束） */
+#if DATA_COMM_STREAM
+            if (ctx->streaming) {
+                stream_end(handle, 1);
+                break;
+            }
+#endif
+            packet_complete(handle);
+            break;
+            
+        default:
+            ctx->state = STATE_WAIT_HEADER1;
+            break;
+    }
+    
+    return PKG_OK;
+}
+
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+/**
+  * @brief  COBS格式解析一个字节
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  byte   : 接收到的字节
+  * @retval 无
+  * @note   逐字节COBS解码后送入帧内容状态机（长度~CRC），遇到0x00分隔符即结束一帧
+  *         任何错误只丢弃到下一个分隔符为止，分隔符之后必然重新同步
+  */
+static void parse_cobs(DataCommHandle *handle, uint8_t byte)
+{
+    ParseContext *ctx = &handle->rx;
+    PkgStatus status;
+    uint8_t zero;
+    
+    if (byte == 0x00) {
+        /* 分隔符：帧内容完整且CRC正确时交付 */
+        if (ctx->state == STATE_WAIT_END1) {
+            packet_complete(handle);
+        } else if (ctx->state != STATE_WAIT_HEADER1 && ctx->state != STATE_WAIT_LENGTH_HIGH) {
+            STATS_INC(handle, length_err);      /* 帧被截断 */
+        }
+        parse_reset(handle);
+        return;
+    }
+    
+    if (ctx->state == STATE_WAIT_HEADER1) {
+        STATS_INC(handle, discard_bytes);
+        return;     /* 已出错，丢弃直到分隔符 */
+    }
+    
+    if (ctx->cobs_remaining == 0) {
+        /* 编码字节：其后还有数据，说明上一块末尾隐含的0x00有效 */
+        zero = ctx->cobs_zero;
+        ctx->cobs_remaining = byte - 1;
+        ctx->cobs_zero = (byte != 0xFF);
+        if (!zero) {
+            return;
+        }
+        byte = 0x00;
+    } else {
+        ctx->cobs_remaining--;
+    }
+    
+    if (ctx->state == STATE_WAIT_END1) {
+        /* 帧内容已完整却仍有数据 */
+        STATS_INC(handle, length_err);
+        ctx->state = STATE_WAIT_HEADER1;
+        return;
+    }
+    status = parse_step(handle, byte);
+    if (status != PKG_OK) {
+        /* 长度/CRC错误 */
+#if DATA_COMM_STATS
+        stats_rx_error(handle, status);
+#endif
+        ctx->state = STATE_WAIT_HEADER1;
+    }
+}
+#endif
+
+#if DATA_COMM_RESYNC && DATA_COMM_FRAMING == DATA_COMM_FRAMING_HEADER
+/**
+  * @brief  帧校验失败后，在本帧已消耗的字节中重新搜索帧头
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  state  : 失败时所处的解析状态
+  * @param  last   : 导致失败的字节
+  * @retval 无
+  * @note   已消耗的字节可由解析上下文完整还原（长度、命令、数据、CRC），无需额外缓存
+  *         还原到栈上的临时窗口后重新送入状态机，窗口内的真实帧可被正常解析
+  */
+static void parse_resync(DataCommHandle *handle, ParseState state, uint8_t last)
+{
+    ParseContext *ctx = &handle->rx;
+    uint8_t win[DATA_COMM_FRAME_SIZE];
+    const uint8_t *hit;
+    uint16_t n = 0;
+    uint16_t i, cand = 0;
+#if USE_CRC16
+    uint8_t k;
+#endif
+    
+    /* 1. 还原帧头第1字节之后已消耗的全部字节 */
+    win[n++] = FRAME_HEADER & 0xFF;
+    win[n++] = (ctx->pkg_length >> 8) & 0xFF;
+    win[n++] = ctx->pkg_length & 0xFF;
+    if (state == STATE_WAIT_CMD) {
+        win[n++] = last;    /* 载荷过长且未被流式接收 */
+    } else if (state != STATE_WAIT_LENGTH_LOW) {
+        win[n++] = ctx->cmd;
+        memcpy(&win[n], ctx->data, ctx->data_index);
+        n += ctx->data_index;
+#if USE_CRC16
+        for (k = CRC_SIZE(handle); k > 0; k--) {
+            win[n++] = (uint8_t)(ctx->recv_crc >> ((k - 1) * 8));
+        }
+#endif
+        if (state == STATE_WAIT_END2) {
+            win[n++] = (FRAME_END >> 8) & 0xFF;
+        }
+        if (state == STATE_WAIT_END1 || state == STATE_WAIT_END2) {
+            win[n++] = last;
+        }
+    }
+    
+    /* 2. 从每个帧头候选位置重新解析，失败则从下一候选继续 */
+    ctx->state = STATE_WAIT_HEADER1;
+    i = 0;
+    while (i < n) {
+        if (ctx->state == STATE_WAIT_HEADER1) {
+            hit = memchr(&win[i], (FRAME_HEADER >> 8) & 0xFF, n - i);
+            if (hit == NULL) {
+                return;
+            }
+            i = (uint16_t)(hit - win);
+            cand = i;
+        }
+        state = ctx->state;
+        if (parse_step(handle, win[i]) != PKG_OK && state != STATE_WAIT_HEADER2) {
+            ctx->state = STATE_WAIT_HEADER1;
+            i = cand + 1;
+            continue;
+        }
+        i++;
+    }
+}
+#endif
+
+/**
+  * @brief  解析一个字节
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  byte   : 接收到的字节
+  * @retval 无
+  */
+static void parse_byte(DataCommHandle *handle, uint8_t byte)
+{
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+    parse_cobs(handle, byte);
+#elif DATA_COMM_RESYNC || DATA_COMM_STATS
+    ParseState state = handle->rx.state;
+#if DATA_COMM_RESYNC && DATA_COMM_STREAM
+    uint8_t streamed = handle->rx.streaming;
+#endif
+    PkgStatus status = parse_step(handle, byte);
+    
+#if DATA_COMM_STATS
+    if (status != PKG_OK) {
+        stats_rx_error(handle, status);
+    } else if (state == STATE_WAIT_HEADER1 && handle->rx.state == STATE_WAIT_HEADER1) {
+        handle->stats.discard_bytes++;
+    }
+#endif
+#if DATA_COMM_RESYNC
+#if DATA_COMM_STREAM
+    /* 流式帧的载荷未缓存，无法在其中重新搜索帧头 */
+    if (streamed) {
+        return;
+    }
+#endif
+    if (status != PKG_OK && status != PKG_HEADER_ERR) {
+        parse_resync(handle, state, byte);
+    }
+#endif
+#else
+    (void)parse_step(handle, byte);
+#endif
+}
+
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+/**
+  * @brief  COBS就地编码
+  * @param  buffer : 缓冲区，待编码内容位于buffer[offset]处，编码结果从buffer[0]开始
+  * @param  offset : 待编码内容的偏移（不小于1 + len/254，保证写位置不超过读位置）
+  * @param  len    : 待编码内容长度
+  * @retval 编码后长度（含末尾0x00分隔符）
+  */
+static uint16_t cobs_encode(uint8_t *buffer, uint16_t offset, uint16_t len)
+{
+    uint16_t out = 1;           // 输出位置
+    uint16_t code_pos = 0;      // 当前块编码字节位置
+    uint8_t code = 1;
+    uint16_t i;
+    uint8_t byte;
+    
+    for (i = 0; i < len; i++) {
+        byte = buffer[offset + i];
+        if (byte == 0x00) {
+            buffer[code_pos] = code;
+            code_pos = out++;
+            code = 1;
+        } else {
+            buffer[out++] = byte;
+            code++;
+            if (code == 0xFF) {
+                buffer[code_pos] = code;
+                code_pos = out++;
+                code = 1;
+            }
+        }
+    }
+    buffer[code_pos] = code;
+    buffer[out++] = 0x00;
+    
+    return out;
+}
+#endif
+
+/**
+  * @brief  填写帧头、长度和命令字节
+  * @param  buffer : 帧缓冲区，载荷已位于buffer[FRAME_PAYLOAD_OFFSET]处
+  * @param  cmd    : 命令字节
+  * @param  len    : 数据载荷长度
+  * @retval 校验字段的位置（载荷之后）
+  */
+static uint16_t frame_head(uint8_t *buffer, uint8_t cmd, uint16_t len)
+{
+    uint16_t index = FRAME_BODY_OFFSET;
+    uint16_t total_len;
+    
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_HEADER
+    /* 1. 帧头（2字节） */
+    buffer[0] = (FRAME_HEADER >> 8) & 0xFF;
+    buffer[1] = FRAME_HEADER & 0xFF;
+#endif
+    
+    /* 2. 长度字段（2字节，表示CMD+DATA的总长度） */
+    total_len = len + 1;  // +1 for CMD
+    buffer[index++] = (total_len >> 8) & 0xFF;
+    buffer[index++] = total_len & 0xFF;
+    
+    /* 3. 命令字节（1字节） */
+    buffer[index++] = cmd;
+    
+    /* 4. 数据载荷（len字节，已就位） */
+    return index + len;
+}
+
+/**
+  * @brief  填写校验值和帧尾（COBS格式为编码并追加分隔符）
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  buffer : 帧缓冲区，frame_head()已完成
+  * @param  index  : 校验字段的位置
+  * @param  crc    : 校验值（USE_CRC16为0时忽略）
+  * @retval 帧总长度（帧从buffer[0]开始）
+  */
+static uint16_t frame_tail(DataCommHandle *handle, uint8_t *buffer, uint16_t index, uint32_t crc)
+{
+#if USE_CRC16
+    uint8_t k;
+    
+    /* 5. 校验值（大端序，CRC16为2字节）- 从长度字段开始计算 */
+    for (k = CRC_SIZE(handle); k > 0; k--) {
+        buffer[index++] = (uint8_t)(crc >> ((k - 1) * 8));
+    }
+#else
+    (void)crc;
+#endif
+    (void)handle;
+    
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+    /* 6. COBS编码并追加0x00分隔符 */
+    return cobs_encode(buffer, FRAME_BODY_OFFSET, index - FRAME_BODY_OFFSET);
+#else
+    /* 6. 帧尾（2字节） */
+    buffer[index++] = (FRAME_END >> 8) & 0xFF;
+    buffer[index++] = FRAME_END & 0xFF;
+    
+    return index;
+#endif
+}
+
+/**
+  * @brief  在帧缓冲区中就地完成组帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  buffer : 帧缓冲区，载荷已位于buffer[FRAME_PAYLOAD_OFFSET]处
+  * @param  cmd    : 命令字节
+  * @param  len    : 数据载荷长度
+  * @retval 帧总长度（帧从buffer[0]开始）
+  */
+static uint16_t frame_build(DataCommHandle *handle, uint8_t *buffer, uint8_t cmd, uint16_t len)
+{
+    uint16_t index = frame_head(buffer, cmd, len);
+    uint32_t crc = 0;
+    
+#if USE_CRC16
+    crc = CRC_FINAL(handle, CRC_UPDATE(handle, CRC_INIT(handle), &buffer[FRAME_BODY_OFFSET], index - FRAME_BODY_OFFSET));
+#endif
+    return frame_tail(handle, buffer, index, crc);
+}
+
+/**
+  * @brief  获取下一帧的组帧缓冲区
+  * @param  handle : 协议实例句柄（非NULL）
+  * @retval 帧缓冲区指针（未配置发送函数或发送队列已满时返回NULL）
+  */
+static uint8_t *tx_frame_get(DataCommHandle *handle)
+{
+#if DATA_COMM_CHECKSUM
+    if (handle->csum_frame != NULL) {
+        return NULL;    /* 上一帧等待异步校验完成 */
+    }
+#endif
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+    if (handle->config.transmit_async != NULL) {
+        uint8_t c = TX_CLASS(handle);
+        
+        if ((uint8_t)(handle->tx_tail[c] - handle->tx_head[c]) >= DATA_COMM_TX_QUEUE_SIZE) {
+            TX_CLASS_STATS_INC(handle, c, queue_full);
+            return NULL;    /* 队列已满，向调用者反压 */
+        }
+#if DATA_COMM_TX_PRIO > 0
+        if (handle->tx_rate[c] != 0 && handle->tx_tokens[c] < 0) {
+            TX_CLASS_STATS_INC(handle, c, rate_limited);
+            return NULL;    /* 令牌不足，等待data_comm_tick()补充 */
+        }
+#endif
+        return handle->tx_buffer[TX_SLOT(c, handle->tx_tail[c])];
+    }
+#endif
+    if (handle->config.transmit == NULL) {
+        return NULL;
+    }
+    return handle->tx_buffer[0];
+}
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  启动发送队列中的一帧
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  c      : 优先级，取该级队首帧
+  * @retval 无
+  * @note   链路空闲时由发送函数调用，否则在发送完成中断中调用
+  */
+static void tx_start(DataCommHandle *handle, uint8_t c)
+{
+    uint16_t slot = TX_SLOT(c, handle->tx_head[c]);
+    
+#if DATA_COMM_TX_PRIO > 0
+    handle->tx_cur = c;
+#if DATA_COMM_STATS
+    {
+        DataCommTxClassStats *st = &handle->tx_class_stats[c];
+        uint32_t latency = DATA_COMM_TX_TIME() - handle->tx_enqueue_time[slot];
+        
+        st->frames++;
+        st->bytes += handle->tx_frame_len[slot];
+        st->latency_last = latency;
+        st->latency_total += latency;
+        if (latency > st->latency_max) {
+            st->latency_max = latency;
+        }
+    }
+#endif
+#endif
+    handle->config.transmit_async(handle, handle->tx_buffer[slot], handle->tx_frame_len[slot]);
+}
+#endif
+
+/**
+  * @brief  发送已组好的帧
+  * @param  handle    : 协议实例句柄（非NULL）
+  * @param  frame     : tx_frame_get()返回的帧缓冲区
+  * @param  frame_len : 帧长度
+  * @retval 无
+  * @note   同步方式直接调用transmit；异步方式入队，链路空闲时立即启动transmit_async
+  */
+static void tx_frame_submit(DataCommHandle *handle, uint8_t *frame, uint16_t frame_len)
+{
+    STATS_INC(handle, tx_frames);
+    STATS_ADD(handle, tx_bytes, frame_len);
+#if DATA_COMM_CAPTURE
+    if (CAPTURE_ON(handle, DATA_COMM_CAP_TX)) {
+        capture_emit(handle, DATA_COMM_CAP_TX, DATA_COMM_CAPTURE_TIME(), 0, frame, frame_len);
+    }
+#endif
+    
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+    if (handle->config.transmit_async != NULL) {
+        uint8_t c = TX_FRAME_CLASS(handle, frame);
+        uint16_t slot = TX_SLOT(c, handle->tx_tail[c]);
+        
+        handle->tx_frame_len[slot] = frame_len;
+#if DATA_COMM_TX_PRIO > 0
+        if (handle->tx_rate[c] != 0) {
+            handle->tx_tokens[c] -= frame_len;
+        }
+#if DATA_COMM_STATS
+        handle->tx_enqueue_time[slot] = DATA_COMM_TX_TIME();
+#endif
+#endif
+        DATA_COMM_BARRIER();
+        handle->tx_tail[c]++;
+#if DATA_COMM_STATS
+        {
+            uint16_t depth = 0;
+            uint8_t k;
+            
+            for (k = 0; k < DATA_COMM_TX_CLASSES; k++) {
+                depth += (uint8_t)(handle->tx_tail[k] - handle->tx_head[k]);
+            }
+            if (depth > handle->stats.tx_queue_hwm) {
+                handle->stats.tx_queue_hwm = depth;
+            }
+#if DATA_COMM_TX_PRIO > 0
+            depth = (uint8_t)(handle->tx_tail[c] - handle->tx_head[c]);
+            if (depth > handle->tx_class_stats[c].queue_hwm) {
+                handle->tx_class_stats[c].queue_hwm = depth;
+            }
+#endif
+        }
+#endif
+        
+        /* 链路空闲时各级队列在入队前均为空，本帧即为队首 */
+        if (!handle->tx_active) {
+            handle->tx_active = 1;
+            tx_start(handle, c);
+        }
+        return;
+    }
+#endif
+    handle->config.transmit(handle, frame, frame_len);
+}
+
+/**
+  * @brief  组帧并发送
+  * @param  handle : 协议实例句柄（非NULL）
+  * @param  frame  : tx_frame_get()返回的帧缓冲区，载荷已就位
+  * @param  cmd    : 命令字节
+  * @param  len    : 数据载荷长度
+  * @retval 帧长度
+  * @note   校验算法提供start时交给外设异步计算，data_comm_checksum_done()中再发送，
+  *         此时返回预计的帧长度（COBS格式为上限）
+  */
+static uint16_t tx_frame_send(DataCommHandle *handle, uint8_t *frame, uint8_t cmd, uint16_t len)
+{
+    uint16_t frame_len;
+    
+#if DATA_COMM_CHECKSUM
+    if (handle->checksum != NULL && handle->checksum->start != NULL) {
+        uint16_t index = frame_head(frame, cmd, len);
+        
+        handle->csum_index = index;
+        handle->csum_frame = frame;
+        if (handle->checksum->start(handle, &frame[FRAME_BODY_OFFSET], index - FRAME_BODY_OFFSET)) {
+            return (uint16_t)(index + handle->checksum->size + 2);
+        }
+        handle->csum_frame = NULL;
+    }
+#endif
+    frame_len = frame_build(handle, frame, cmd, len);
+    tx_frame_submit(handle, frame, frame_len);
+    return frame_len;
+}
+
+/* ========================= API函数实现 ========================= */
+/**
+  * @brief  初始化协议实例
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  config : 实例配置（回调函数等）
+  * @retval 无
+  * @note   同一句柄的解析和发送互不影响，不同句柄之间完全独立
+  */
+void data_comm_init_ex(DataCommHandle *handle, const DataCommConfig *config)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    memset(handle, 0, sizeof(DataCommHandle));
+    if (config != NULL) {
+        handle->config = *config;
+    }
+#if DATA_COMM_TX_PRIO > 0
+    handle->tx_class = DATA_COMM_TX_PRIO - 1;
+#endif
+    parse_reset(handle);
+}
+
+#if USE_CRC16
+/**
+  * @brief  增量计算CRC16-CCITT
+  * @param  crc  : 上一次的CRC值（首次计算传入CRC16_INIT）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval 更新后的CRC16值
+  * @note   多项式: 0x1021，计算方式由CRC16_METHOD选择
+  */
+uint16_t data_comm_crc16(uint16_t crc, const uint8_t *data, uint16_t len)
+{
+#if CRC16_METHOD == CRC16_METHOD_SLICE8
+    /* 每次处理8字节：CRC只与前2字节叠加，其余字节直接查各自位置的表 */
+    while (len >= 8) {
+        crc = crc16_table[7][(data[0] ^ (crc >> 8)) & 0xFF] ^
+              crc16_table[6][(data[1] ^ crc) & 0xFF] ^
+              crc16_table[5][data[2]] ^
+              crc16_table[4][data[3]] ^
+              crc16_table[3][data[4]] ^
+              crc16_table[2][data[5]] ^
+              crc16_table[1][data[6]] ^
+              crc16_table[0][data[7]];
+        data += 8;
+        len -= 8;
+    }
+#endif
+#if CRC16_METHOD == CRC16_METHOD_SLICE8 || CRC16_METHOD == CRC16_METHOD_SLICE4
+    /* 每次处理4字节 */
+    while (len >= 4) {
+        crc = crc16_table[3][(data[0] ^ (crc >> 8)) & 0xFF] ^
+              crc16_table[2][(data[1] ^ crc) & 0xFF] ^
+              crc16_table[1][data[2]] ^
+              crc16_table[0][data[3]];
+        data += 4;
+        len -= 4;
+    }
+#endif
+    /* 剩余字节逐字节处理 */
+    while (len--) {
+        crc = CRC16_UPDATE_BYTE(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+#if DATA_COMM_CHECKSUM
+/* ========================= 校验算法 ========================= */
+static uint32_t csum_crc16_update(uint32_t state, const uint8_t *data, uint16_t len)
+{
+    return data_comm_crc16((uint16_t)state, data, len);
+}
+
+/* CRC32半字节查找表（反射多项式0xEDB88320），只占64字节Flash */
+static const uint32_t crc32_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+static uint32_t csum_crc32_update(uint32_t state, const uint8_t *data, uint16_t len)
+{
+    while (len--) {
+        state ^= *data++;
+        state = (state >> 4) ^ crc32_nibble[state & 0x0F];
+        state = (state >> 4) ^ crc32_nibble[state & 0x0F];
+    }
+    return state;
+}
+
+static uint32_t csum_crc32_final(uint32_t state)
+{
+    return ~state;
+}
+
+/**
+  * @note   状态为 sum2 << 8 | sum1（均已对255取模）；每块最多累加4096字节后取模一次，
+  *         32位累加不会溢出（sum2 <= 254 + 254n + 255n(n+1)/2，n = 4096时约2.1e9）
+  */
+static uint32_t csum_fletcher16_update(uint32_t state, const uint8_t *data, uint16_t len)
+{
+    uint32_t sum1 = state & 0xFF;
+    uint32_t sum2 = (state >> 8) & 0xFF;
+    uint16_t n;
+    
+    while (len > 0) {
+        n = (len > 4096) ? 4096 : len;
+        len -= n;
+        do {
+            sum1 += *data++;
+            sum2 += sum1;
+        } while (--n);
+        sum1 %= 255;
+        sum2 %= 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+static uint32_t csum_hw_update(uint32_t state, const uint8_t *data, uint16_t len)
+{
+    return user_checksum_hw(state, data, len);
+}
+
+const DataCommChecksum data_comm_checksum_crc16 = {2, CRC16_INIT, csum_crc16_update, NULL, NULL};
+const DataCommChecksum data_comm_checksum_crc32 = {4, 0xFFFFFFFFu, csum_crc32_update, csum_crc32_final, NULL};
+const DataCommChecksum data_comm_checksum_fletcher16 = {2, 0, csum_fletcher16_update, NULL, NULL};
+const DataCommChecksum data_comm_checksum_hw = {2, CRC16_INIT, csum_hw_update, NULL, user_checksum_hw_start};
+
+/**
+  * @brief  选择实例的校验算法
+  * @param  handle   : 协议实例句柄（NULL表示默认实例）
+  * @param  checksum : 校验算法（NULL表示内置CRC16）
+  * @retval 无
+  * @note   复位接收状态机，正在接收的帧被丢弃
+  */
+void data_comm_set_checksum(DataCommHandle *handle, const DataCommChecksum *checksum)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    handle->checksum = checksum;
+    parse_reset(handle);
+}
+
+/**
+  * @brief  异步校验计算完成，填写校验字段并发送等待中的帧
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  value  : 校验值
+  * @retval 无
+  */
+void data_comm_checksum_done(DataCommHandle *handle, uint32_t value)
+{
+    uint8_t *frame;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    frame = handle->csum_frame;
+    if (frame == NULL) {
+        return;
+    }
+    tx_frame_submit(handle, frame, frame_tail(handle, frame, handle->csum_index, value));
+    handle->csum_frame = NULL;
+}
+#endif
+
+/**
+  * @brief  打包并发送数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 实际发送（或入队）的字节数，发送队列已满时返回0
+  */
+uint16_t data_comm_send_ex(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint8_t *frame;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    /* 参数检查 */
+    if (len > MAX_DATA_LENGTH || (data == NULL && len > 0) || handle->tx_reserved) {
+        return 0;
+    }
+    frame = tx_frame_get(handle);
+    if (frame == NULL) {
+        return 0;
+    }
+    
+    /* 数据载荷直接拷贝到帧内位置，其余字段就地填充 */
+    if (len > 0) {
+        memcpy(&frame[FRAME_PAYLOAD_OFFSET], data, len);
+    }
+    
+    /* 组帧后发送或入队 */
+    return tx_frame_send(handle, frame, cmd, len);
+}
+
+/**
+  * @brief  分散载荷打包并发送（scatter-gather）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  iov    : 载荷片段数组
+  * @param  iovcnt : 片段数量
+  * @retval 实际发送（或入队）的字节数（载荷总长度超过MAX_DATA_LENGTH或队列已满时返回0）
+  * @note   各片段按顺序直接拷贝到发送帧内，调用者无需先拼接
+  */
+uint16_t data_comm_sendv(DataCommHandle *handle, uint8_t cmd, const DataCommIovec *iov, uint8_t iovcnt)
+{
+    uint8_t *frame;
+    uint8_t *payload;
+    uint16_t len = 0;
+    uint8_t i;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    /* 参数检查 */
+    if ((iov == NULL && iovcnt > 0) || handle->tx_reserved) {
+        return 0;
+    }
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].len > MAX_DATA_LENGTH - len || (iov[i].data == NULL && iov[i].len > 0)) {
+            return 0;
+        }
+        len += iov[i].len;
+    }
+    frame = tx_frame_get(handle);
+    if (frame == NULL) {
+        return 0;
+    }
+    
+    /* 片段依次拷贝到帧内载荷位置 */
+    payload = &frame[FRAME_PAYLOAD_OFFSET];
+    for (i = 0; i < iovcnt; i++) {
+        if (iov[i].len > 0) {
+            memcpy(payload, iov[i].data, iov[i].len);
+            payload += iov[i].len;
+        }
+    }
+    
+    return tx_frame_send(handle, frame, cmd, len);
+}
+
+/**
+  * @brief  预留发送帧内的载荷空间（零拷贝组帧）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  len    : 需要预留的最大载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 载荷写入位置指针（失败或发送队列已满返回NULL）
+  * @note   调用者直接在返回的指针处序列化载荷，然后调用data_comm_commit()发送
+  *         预留期间该实例的data_comm_send_ex()/data_comm_sendv()返回0
+  *         异步发送时返回的指针直接位于发送队列的空闲帧槽内
+  */
+uint8_t *data_comm_reserve(DataCommHandle *handle, uint16_t len)
+{
+    uint8_t *frame;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (len > MAX_DATA_LENGTH || handle->tx_reserved) {
+        return NULL;
+    }
+    frame = tx_frame_get(handle);
+    if (frame == NULL) {
+        return NULL;
+    }
+    handle->tx_reserved = 1;
+    handle->tx_reserve_len = len;
+    
+    return &frame[FRAME_PAYLOAD_OFFSET];
+}
+
+/**
+  * @brief  提交预留的载荷并发送
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  len    : 实际写入的载荷长度（不超过预留长度）
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  * @note   就地填写长度、命令、CRC和帧尾，无论成功与否都会释放预留
+  */
+uint16_t data_comm_commit(DataCommHandle *handle, uint8_t cmd, uint16_t len)
+{
+    uint8_t *frame;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (!handle->tx_reserved) {
+        return 0;
+    }
+    handle->tx_reserved = 0;
+    if (len > handle->tx_reserve_len) {
+        return 0;
+    }
+    
+    /* 预留期间帧槽不会被其他发送占用，此处必然取回同一缓冲区 */
+    frame = tx_frame_get(handle);
+    return tx_frame_send(handle, frame, cmd, len);
+}
+
+/**
+  * @brief  取消预留，不发送
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_cancel(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    handle->tx_reserved = 0;
+}
+
+/**
+  * @brief  查询当前可立即发送的帧数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 异步发送：发送队列空闲帧槽数；同步发送：1（可发送）或0（已被预留）
+  * @note   返回0时data_comm_send_ex()等发送函数将失败，调用者可据此降频或丢弃低优先级数据
+  */
+uint8_t data_comm_tx_free(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (handle->tx_reserved) {
+        return 0;
+    }
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+    if (handle->config.transmit_async != NULL) {
+        uint8_t c = TX_CLASS(handle);
+        
+#if DATA_COMM_TX_PRIO > 0
+        if (handle->tx_rate[c] != 0 && handle->tx_tokens[c] < 0) {
+            return 0;
+        }
+#endif
+        return DATA_COMM_TX_QUEUE_SIZE - (uint8_t)(handle->tx_tail[c] - handle->tx_head[c]);
+    }
+#endif
+    return (handle->config.transmit != NULL) ? 1 : 0;
+}
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  异步发送完成回调
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  * @note   在DMA/串口发送完成中断中调用，释放当前帧槽并立即启动队列中的下一帧
+  */
+void data_comm_tx_complete_isr(DataCommHandle *handle)
+{
+    uint8_t c;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (!handle->tx_active) {
+        return;
+    }
+    handle->tx_head[TX_CUR(handle)]++;
+    
+    /* 链式启动下一帧：优先级最高的非空队列 */
+    for (c = 0; c < DATA_COMM_TX_CLASSES; c++) {
+        if (handle->tx_head[c] != handle->tx_tail[c]) {
+            tx_start(handle, c);
+            return;
+        }
+    }
+    handle->tx_active = 0;
+}
+#endif
+
+#if DATA_COMM_TX_PRIO > 0
+/**
+  * @brief  设置发送函数使用的优先级
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级（0最高）
+  * @retval 0-成功，-1-参数错误或发送缓冲区已被预留
+  * @note   预留期间不能切换，data_comm_commit()须取回预留时的帧槽
+  */
+int8_t data_comm_set_tx_prio(DataCommHandle *handle, uint8_t prio)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (prio >= DATA_COMM_TX_PRIO || handle->tx_reserved) {
+        return -1;
+    }
+    handle->tx_class = prio;
+    return 0;
+}
+
+/**
+  * @brief  以指定优先级打包并发送数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级（0最高）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 实际入队的字节数，该级队列已满或超出速率限制时返回0
+  * @note   不改变data_comm_set_tx_prio()设置的优先级
+  */
+uint16_t data_comm_send_prio(DataCommHandle *handle, uint8_t prio, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    uint8_t saved;
+    uint16_t ret;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (prio >= DATA_COMM_TX_PRIO) {
+        return 0;
+    }
+    saved = handle->tx_class;
+    handle->tx_class = prio;
+    ret = data_comm_send_ex(handle, cmd, data, len);
+    handle->tx_class = saved;
+    return ret;
+}
+
+/**
+  * @brief  设置优先级的速率限制（令牌桶）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级
+  * @param  rate   : 每个data_comm_tick()时间单位补充的字节数（0表示不限制）
+  * @param  burst  : 令牌桶容量（字节）
+  * @retval 无
+  * @note   令牌允许透支一帧：剩余令牌不为负即可入队，因此至少能发送一帧，
+  *         长期平均速率不超过rate，单次突发不超过burst加一帧
+  */
+void data_comm_set_tx_rate(DataCommHandle *handle, uint8_t prio, uint32_t rate, uint32_t burst)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    if (prio >= DATA_COMM_TX_PRIO) {
+        return;
+    }
+    
+    if (burst > INT32_MAX) {
+        burst = INT32_MAX;
+    }
+    handle->tx_rate[prio] = rate;
+    handle->tx_burst[prio] = burst;
+    handle->tx_tokens[prio] = (int32_t)burst;
+}
+
+/**
+  * @brief  补充各级发送速率令牌
+  * @param  handle  : 协议实例句柄（非NULL）
+  * @param  elapsed : 距上次data_comm_tick()经过的时间
+  * @retval 无
+  */
+static void tx_rate_refill(DataCommHandle *handle, uint32_t elapsed)
+{
+    uint8_t c;
+    
+    for (c = 0; c < DATA_COMM_TX_PRIO; c++) {
+        if (handle->tx_rate[c] == 0) {
+            continue;
+        }
+        /* 先判断是否补满，避免elapsed * rate溢出 */
+        if (elapsed >= handle->tx_burst[c] / handle->tx_rate[c] + 1) {
+            handle->tx_tokens[c] = (int32_t)handle->tx_burst[c];
+        } else {
+            handle->tx_tokens[c] += (int32_t)(elapsed * handle->tx_rate[c]);
+            if (handle->tx_tokens[c] > (int32_t)handle->tx_burst[c]) {
+                handle->tx_tokens[c] = (int32_t)handle->tx_burst[c];
+            }
+        }
+    }
+}
+
+#if DATA_COMM_STATS
+/**
+  * @brief  获取优先级统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级
+  * @param  stats  : 输出统计计数快照
+  * @retval 无
+  */
+void data_comm_get_tx_class_stats(DataCommHandle *handle, uint8_t prio, DataCommTxClassStats *stats)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    if (stats == NULL || prio >= DATA_COMM_TX_PRIO) {
+        return;
+    }
+    
+    *stats = handle->tx_class_stats[prio];
+}
+#endif
+#endif
+
+/**
+  * @brief  解析接收到的单个字节
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  byte   : 接收到的字节
+  * @retval 无
+  * @note   将接收到的每个字节传入此函数，内部自动进行协议解析
+  */
+void data_comm_parse_byte_ex(DataCommHandle *handle, uint8_t byte)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    PARSE_CYCLES_BEGIN(handle);
+#if DATA_COMM_CAPTURE
+    if (CAPTURE_ON(handle, DATA_COMM_CAP_RX)) {
+        capture_rx_byte(handle, byte);
+    }
+#endif
+    parse_byte(handle, byte);
+    PARSE_CYCLES_END(handle);
+}
+
+/**
+  * @brief  批量解析接收到的数据块
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  buf    : 数据块指针
+  * @param  len    : 数据块长度
+  * @retval 无
+  * @note   适用于DMA/空闲中断接收，结果与逐字节调用data_comm_parse_byte_ex()完全一致
+  *         等待帧头时使用memchr搜索帧头首字节，接收载荷时整段拷贝并整段计算CRC
+  *         COBS格式下出错后使用memchr直接跳到下一个分隔符
+  */
+void data_comm_parse_buffer_ex(DataCommHandle *handle, const uint8_t *buf, size_t len)
+{
+    ParseContext *ctx;
+    const uint8_t *p = buf;
+    const uint8_t *end = buf + len;
+    const uint8_t *hit;
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_HEADER
+    uint16_t chunk;
+#endif
+    
+    if (buf == NULL) {
+        return;
+    }
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    ctx = &handle->rx;
+#if DATA_COMM_CAPTURE
+    if (CAPTURE_ON(handle, DATA_COMM_CAP_RX)) {
+        capture_rx_block(handle, buf, len);
+    }
+#endif
+    PARSE_CYCLES_BEGIN(handle);
+    
+    while (p < end) {
+        switch (ctx->state) {
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+            case STATE_WAIT_HEADER1:
+                /* 快速路径：出错后直接跳到下一个分隔符 */
+                hit = memchr(p, 0x00, (size_t)(end - p));
+                if (hit == NULL) {
+                    STATS_ADD(handle, discard_bytes, end - p);
+                    p = end;
+                    break;
+                }
+                STATS_ADD(handle, discard_bytes, hit - p);
+                p = hit;
+                parse_byte(handle, *p++);
+                break;
+#else
+            case STATE_WAIT_HEADER1:
+                /* 快速路径：跳过帧头之前的所有无效字节 */
+                hit = memchr(p, (FRAME_HEADER >> 8) & 0xFF, (size_t)(end - p));
+                if (hit == NULL) {
+                    STATS_ADD(handle, discard_bytes, end - p);
+                    p = end;
+                    break;
+                }
+                STATS_ADD(handle, discard_bytes, hit - p);
+                p = hit + 1;
+                ctx->state = STATE_WAIT_HEADER2;
+                break;
+                
+            case STATE_READ_DATA:
+                /* 快速路径：载荷整段拷贝 */
+                chunk = (ctx->pkg_length - 1) - ctx->data_index;
+                if ((size_t)(end - p) < chunk) {
+                    chunk = (uint16_t)(end - p);
+                }
+#if DATA_COMM_STREAM
+                if (ctx->streaming) {
+                    /* 流式帧：先交付逐字节暂存的部分，再直接交付输入缓冲区中的数据（零拷贝） */
+                    stream_flush(handle);
+                    handle->config.stream->chunk(handle, p, chunk);
+                } else
+#endif
+                memcpy(&ctx->data[ctx->data_index], p, chunk);
+#if USE_CRC16
+                ctx->calc_crc = CRC_UPDATE(handle, ctx->calc_crc, p, chunk);
+#endif
+                ctx->data_index += chunk;
+                p += chunk;
+                
+                /* 数据接收完成 */
+                if (ctx->data_index >= (ctx->pkg_length - 1)) {
+#if USE_CRC16
+                    ctx->state = STATE_WAIT_CRC1;
+#else
+                    ctx->state = STATE_WAIT_END1;
+#endif
+                }
+                break;
+#endif
+                
+            default:
+                parse_byte(handle, *p++);
+                break;
+        }
+    }
+    PARSE_CYCLES_END(handle);
+}
+
+/**
+  * @brief  设置常量命令分发表
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  table  : 256项分发表（以命令字节为下标，可为const放在Flash中），NULL表示不使用
+  * @retval 无
+  */
+void data_comm_set_cmd_table(DataCommHandle *handle, const DataCommCmdEntry *table)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    handle->config.cmd_table = table;
+}
+
+#if DATA_COMM_CMD_REGISTER_MAX > 0
+/**
+  * @brief  运行时注册命令处理函数
+  * @param  handle  : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd     : 命令字节
+  * @param  handler : 处理函数（NULL表示注销该命令）
+  * @param  min_len : 允许的最小载荷长度
+  * @param  max_len : 允许的最大载荷长度
+  * @retval 0-成功，-1-注册表已满
+  * @note   重复注册同一命令会覆盖原处理函数；运行时注册优先于常量分发表
+  *         不要在该实例正在解析（接收中断可能触发）时修改，建议在初始化阶段完成注册
+  */
+int8_t data_comm_register(DataCommHandle *handle, uint8_t cmd, DataCommPacketFunc handler,
+                          uint16_t min_len, uint16_t max_len)
+{
+    uint8_t i;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    /* 注销 */
+    if (handler == NULL) {
+        if (handle->cmd_index[cmd] != 0) {
+            handle->cmd_entries[handle->cmd_index[cmd] - 1].handler = NULL;
+            handle->cmd_index[cmd] = 0;
+        }
+        return 0;
+    }
+    
+    /* 已注册则覆盖，否则占用一个空闲项 */
+    if (handle->cmd_index[cmd] == 0) {
+        for (i = 0; i < DATA_COMM_CMD_REGISTER_MAX; i++) {
+            if (handle->cmd_entries[i].handler == NULL) {
+                break;
+            }
+        }
+        if (i >= DATA_COMM_CMD_REGISTER_MAX) {
+            return -1;
+        }
+        handle->cmd_entries[i].handler = handler;
+        handle->cmd_index[cmd] = i + 1;
+    }
+    handle->cmd_entries[handle->cmd_index[cmd] - 1].handler = handler;
+    handle->cmd_entries[handle->cmd_index[cmd] - 1].min_len = min_len;
+    handle->cmd_entries[handle->cmd_index[cmd] - 1].max_len = max_len;
+    
+    return 0;
+}
+#endif
+
+/**
+  * @brief  获取未处理命令计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 既不在分发表中、也没有packet_handler可交付而丢弃的数据包数量
+  */
+uint32_t data_comm_cmd_unknown(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->cmd_unknown;
+}
+
+/**
+  * @brief  获取命令长度错误计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 载荷长度超出分发表中min_len~max_len范围而丢弃的数据包数量
+  */
+uint32_t data_comm_cmd_len_err(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->cmd_len_err;
+}
+
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+/**
+  * @brief  处理接收队列中的数据包
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 本次处理的数据包数量
+  * @note   在主循环中调用，依次对队列中的数据包调用packet_handler
+  *         解析在中断中进行，数据包回调在调用本函数的上下文中执行
+  */
+uint8_t data_comm_poll(DataCommHandle *handle)
+{
+    DataCommPacket *slot;
+    uint8_t count = 0;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    while (handle->rx_head != handle->rx_tail) {
+        slot = &handle->rx_queue[handle->rx_head % DATA_COMM_RX_QUEUE_SIZE];
+        packet_deliver(handle, slot->cmd, slot->data, slot->len);
+        
+        /* 回调返回后才释放帧槽，回调期间数据保持有效 */
+        DATA_COMM_BARRIER();
+        handle->rx_head++;
+        count++;
+    }
+    
+    return count;
+}
+
+/**
+  * @brief  获取接收队列溢出丢弃的帧数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 自初始化以来因队列已满而丢弃的完整帧数量
+  */
+uint32_t data_comm_rx_overflow(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->rx_overflow;
+}
+#endif
+
+#if DATA_COMM_BATCH
+/**
+  * @brief  合并发送一条短消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（不能为DATA_COMM_BATCH_CMD）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 0-成功（已并入合并帧或已发送），-1-失败（参数错误或发送队列已满）
+  * @note   每条消息只占用命令(1) + 长度(1)的开销，合并帧整体只有一份帧头、CRC和帧尾
+  */
+int8_t data_comm_batch_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint16_t len)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (cmd == DATA_COMM_BATCH_CMD || (data == NULL && len > 0) || len > MAX_DATA_LENGTH) {
+        return -1;
+    }
+    
+    /* 放不下则先发送已合并的消息 */
+    if (handle->batch_len + 2 + len > DATA_COMM_BATCH_SIZE) {
+        if (data_comm_batch_flush(handle) != 0) {
+            return -1;
+        }
+    }
+    
+    /* 长消息单独发送 */
+    if (2 + len > DATA_COMM_BATCH_SIZE || len > 0xFF) {
+        return data_comm_send_ex(handle, cmd, (uint8_t *)data, len) ? 0 : -1;
+    }
+    
+    if (handle->batch_count == 0) {
+        handle->batch_start = handle->tick_now;
+    }
+    handle->batch_buf[handle->batch_len] = cmd;
+    handle->batch_buf[handle->batch_len + 1] = (uint8_t)len;
+    if (len > 0) {
+        memcpy(&handle->batch_buf[handle->batch_len + 2], data, len);
+    }
+    handle->batch_len += 2 + len;
+    handle->batch_count++;
+    
+    /* 已装不下任何消息时立即发送 */
+    if (handle->batch_len + 2 > DATA_COMM_BATCH_SIZE) {
+        (void)data_comm_batch_flush(handle);
+    }
+    return 0;
+}
+
+/**
+  * @brief  立即发送合并帧中暂存的消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 0-成功（或没有暂存消息），-1-发送队列已满，消息继续暂存
+  * @note   只有一条消息时按普通帧发送，不使用合并格式
+  */
+int8_t data_comm_batch_flush(DataCommHandle *handle)
+{
+    uint16_t sent;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (handle->batch_count == 0) {
+        return 0;
+    }
+    if (handle->batch_count == 1) {
+        sent = data_comm_send_ex(handle, handle->batch_buf[0], &handle->batch_buf[2], handle->batch_buf[1]);
+    } else {
+        sent = data_comm_send_ex(handle, DATA_COMM_BATCH_CMD, handle->batch_buf, handle->batch_len);
+    }
+    if (sent == 0) {
+        return -1;
+    }
+    
+    handle->batch_len = 0;
+    handle->batch_count = 0;
+    return 0;
+}
+
+#endif
+
+#if DATA_COMM_RELIABLE
+/**
+  * @brief  可靠发送一条消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（对端收到后按此命令分发）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~DATA_COMM_REL_MAX_DATA）
+  * @retval 0-成功（已进入发送窗口），-1-失败（参数错误或发送窗口已满）
+  * @note   窗口内的消息连续发送，无需等待前一条确认（滑动窗口）
+  *         首次发送时建立会话：会话号取自user_rel_session()，收到确认前的数据帧带会话建立标志，
+  *         对端据此从本端的窗口起点重新接收
+  */
+int8_t data_comm_rel_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint16_t len)
+{
+    DataCommRelSlot *slot;
+    uint8_t seq;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+    if (len > DATA_COMM_REL_MAX_DATA || (data == NULL && len > 0)) {
+        return -1;
+    }
+    if ((uint8_t)(handle->rel_snd_nxt - handle->rel_snd_una) >= DATA_COMM_REL_WINDOW) {
+        return -1;  /* 发送窗口已满，向调用者反压 */
+    }
+    
+    if (handle->rel_session == 0) {
+        handle->rel_session = (uint8_t)DATA_COMM_REL_SESSION();
+        if (handle->rel_session == 0) {
+            handle->rel_session = 1;
+        }
+        handle->rel_syn = 1;
+    }
+    
+    seq = handle->rel_snd_nxt;
+    slot = &handle->rel_tx[seq % DATA_COMM_REL_WINDOW];
+    slot->cmd = cmd;
+    slot->len = len;
+    if (len > 0) {
+        memcpy(slot->data, data, len);
+    }
+    slot->sent = 0;
+    slot->fast = 0;
+    slot->state = 1;
+    DATA_COMM_BARRIER();
+    handle->rel_snd_nxt = seq + 1;
+    
+    rel_transmit(handle, seq);
+    return 0;
+}
+
+/**
+  * @brief  查询发送窗口中尚未确认的消息数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 未确认消息数（0表示全部已送达）
+  */
+uint8_t data_comm_rel_pending(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return (uint8_t)(handle->rel_snd_nxt - handle->rel_snd_una);
+}
+
+/**
+  * @brief  获取重传次数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 自初始化以来的重传帧数
+  */
+uint32_t data_comm_rel_retransmits(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->rel_retransmits;
+}
+
+/**
+  * @brief  获取接收窗口重新开始的次数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 对端建立会话使本端接收窗口从头开始的次数
+  */
+uint32_t data_comm_rel_resyncs(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->rel_resyncs;
+}
+
+/**
+  * @brief  可靠传输定时处理：发送确认帧，重传超时的消息
+  * @param  handle : 协议实例句柄（非NULL）
+  * @retval 无
+  * @note   确认帧在此合并发送，接收中断中不直接发送；连续收到多帧只回复一次确认
+  */
+static void rel_tick(DataCommHandle *handle)
+{
+    DataCommRelSlot *slot;
+    uint8_t ack[7];
+    uint8_t seq;
+    
+    /* 1. 确认：会话建立标志 + 累计确认序号 + 选择确认位图 */
+    if (handle->rel_ack_pending) {
+        handle->rel_ack_pending = 0;
+        ack[0] = handle->rel_rx_session;
+        ack[1] = handle->rel_rx_syn ? DATA_COMM_REL_FLAG_SYN : 0;
+        ack[2] = handle->rel_rcv_nxt;
+        ack[3] = (uint8_t)(handle->rel_rcv_mask >> 24);
+        ack[4] = (uint8_t)(handle->rel_rcv_mask >> 16);
+        ack[5] = (uint8_t)(handle->rel_rcv_mask >> 8);
+        ack[6] = (uint8_t)handle->rel_rcv_mask;
+        if (data_comm_send_ex(handle, DATA_COMM_REL_ACK_CMD, ack, sizeof(ack)) == 0) {
+            handle->rel_ack_pending = 1;
+        }
+    }
+    
+    /* 2. 补发未发出的消息，重传超时（或被快速重传标记）且未被选择确认的消息 */
+    for (seq = handle->rel_snd_una; seq != handle->rel_snd_nxt; seq++) {
+        slot = &handle->rel_tx[seq % DATA_COMM_REL_WINDOW];
+        if (slot->state == 1 &&
+            (!slot->sent || (uint32_t)(handle->tick_now - slot->sent_time) >= DATA_COMM_REL_RTO)) {
+            rel_transmit(handle, seq);
+        }
+    }
+}
+#endif
 
-/* ========================= 私有变量 ========================= */
-static ParseContext g_ctx;
+#if DATA_COMM_BATCH || DATA_COMM_RELIABLE || DATA_COMM_TX_PRIO > 0
+/**
+  * @brief  协议定时处理
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  now    : 当前时间（如HAL_GetTick()），单位与DATA_COMM_BATCH_TIMEOUT、DATA_COMM_REL_RTO一致
+  * @retval 无
+  */
+void data_comm_tick(DataCommHandle *handle, uint32_t now)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    
+#if DATA_COMM_TX_PRIO > 0
+    tx_rate_refill(handle, now - handle->tick_now);
+#endif
+    handle->tick_now = now;
+#if DATA_COMM_BATCH
+    if (handle->batch_count > 0 && (uint32_t)(now - handle->batch_start) >= DATA_COMM_BATCH_TIMEOUT) {
+        (void)data_comm_batch_flush(handle);
+    }
+#endif
+#if DATA_COMM_RELIABLE
+    rel_tick(handle);
+#endif
+}
+#endif
 
-/* ========================= 私有函数 ========================= */
+#if DATA_COMM_FRAG
 /**
-  * @brief  CRC16-CCITT计算
-  * @param  data : 数据缓冲区
-  * @param  len  : 数据长度
-  * @retval CRC16值
-  * @note   多项式: 0x1021, 初始值: 0xFFFF
+  * @brief  分片发送数据块
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 数据块的命令字节
+  * @param  data   : 数据块
+  * @param  len    : 数据块长度
+  * @param  offset : 从该偏移继续发送（首次为0）
+  * @retval 已发送到的偏移（等于len表示全部发送）
+  * @note   offset为0时分配新的数据块编号；发送队列满时返回当前偏移，稍后从该偏移继续
   */
-static uint16_t crc16_ccitt(uint8_t *data, uint16_t len)
+uint32_t data_comm_blob_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint32_t len, uint32_t offset)
 {
-    uint16_t crc = 0xFFFF;
-    uint16_t i;
+    uint8_t head[DATA_COMM_FRAG_HEADER];
+    DataCommIovec iov[2];
+    uint16_t n;
     
-    while (len--) {
-        crc ^= (uint16_t)(*data++) << 8;
-        for (i = 0; i < 8; i++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ 0x1021;
-            } else {
-                crc <<= 1;
-            }
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    if (data == NULL || offset >= len) {
+        return offset;
+    }
+    
+    if (offset == 0) {
+        handle->frag_tx_id++;
+    }
+    head[0] = handle->frag_tx_id;
+    head[1] = cmd;
+    head[6] = (uint8_t)(len >> 24);
+    head[7] = (uint8_t)(len >> 16);
+    head[8] = (uint8_t)(len >> 8);
+    head[9] = (uint8_t)len;
+    iov[0].data = head;
+    iov[0].len = DATA_COMM_FRAG_HEADER;
+    
+    while (offset < len) {
+        n = (len - offset > DATA_COMM_FRAG_DATA) ? DATA_COMM_FRAG_DATA : (uint16_t)(len - offset);
+        head[2] = (uint8_t)(offset >> 24);
+        head[3] = (uint8_t)(offset >> 16);
+        head[4] = (uint8_t)(offset >> 8);
+        head[5] = (uint8_t)offset;
+        iov[1].data = &data[offset];
+        iov[1].len = n;
+        if (data_comm_sendv(handle, DATA_COMM_FRAG_CMD, iov, 2) == 0) {
+            break;      /* 发送队列已满 */
         }
+        offset += n;
     }
-    return crc;
+    return offset;
 }
 
-/* ========================= API函数实现 ========================= */
 /**
-  * @brief  初始化通信协议模块
-  * @param  无
+  * @brief  获取因分片丢失或乱序而中止的数据块数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 中止的数据块数
+  */
+uint32_t data_comm_blob_errors(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    return handle->frag_rx_err;
+}
+#endif
+
+#if DATA_COMM_STATS
+/**
+  * @brief  获取收发统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  stats  : 输出统计计数快照
   * @retval 无
+  * @note   与接收中断并发读取时，各计数之间可能相差正在处理的一帧
   */
-void data_comm_init(void)
+void data_comm_get_stats(DataCommHandle *handle, DataCommStats *stats)
 {
-    memset(&g_ctx, 0, sizeof(g_ctx));
-    g_ctx.state = STATE_WAIT_HEADER1;
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    if (stats == NULL) {
+        return;
+    }
+    
+    *stats = handle->stats;
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+    stats->rx_overflow = handle->rx_overflow;
+#endif
+    stats->cmd_unknown = handle->cmd_unknown;
+    stats->cmd_len_err = handle->cmd_len_err;
 }
 
 /**
-  * @brief  打包并发送数据
-  * @param  cmd  : 命令字节（1字节）
-  * @param  data : 数据载荷指针
-  * @param  len  : 数据载荷长度（0~MAX_DATA_LENGTH）
-  * @retval 实际发送的字节数
+  * @brief  清零收发统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
   */
-uint16_t data_comm_send(uint8_t cmd, uint8_t *data, uint16_t len)
+void data_comm_reset_stats(DataCommHandle *handle)
 {
-    static uint8_t buffer[MAX_DATA_LENGTH + 10]; // 最大帧长度
-    uint16_t index = 0;
-    uint16_t total_len;
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
     
-    /* 参数检查 */
-    if (len > MAX_DATA_LENGTH) {
-        return 0;
+    memset(&handle->stats, 0, sizeof(handle->stats));
+#if DATA_COMM_TX_PRIO > 0
+    memset(handle->tx_class_stats, 0, sizeof(handle->tx_class_stats));
+#endif
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+    handle->rx_overflow = 0;
+#endif
+    handle->cmd_unknown = 0;
+    handle->cmd_len_err = 0;
+}
+
+/**
+  * @brief  通过本链路发送统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  * @note   命令字节为DATA_COMM_STATS_CMD，载荷为DataCommStats各成员依次按大端序排列
+  *         统计快照直接序列化到发送帧内，不占用额外缓冲区
+  */
+uint16_t data_comm_send_stats(DataCommHandle *handle)
+{
+    DataCommStats stats;
+    const uint32_t *src = (const uint32_t *)&stats;
+    uint8_t *payload;
+    uint16_t i;
+    
+    if (handle == NULL) {
+        handle = &g_default_handle;
     }
     
-    /* 1. 帧头（2字节） */
-    buffer[index++] = (FRAME_HEADER >> 8) & 0xFF;
-    buffer[index++] = FRAME_HEADER & 0xFF;
+    payload = data_comm_reserve(handle, DATA_COMM_STATS_SIZE);
+    if (payload == NULL) {
+        return 0;
+    }
+    data_comm_get_stats(handle, &stats);
+    for (i = 0; i < DATA_COMM_STATS_SIZE / 4; i++) {
+        payload[i * 4]     = (uint8_t)(src[i] >> 24);
+        payload[i * 4 + 1] = (uint8_t)(src[i] >> 16);
+        payload[i * 4 + 2] = (uint8_t)(src[i] >> 8);
+        payload[i * 4 + 3] = (uint8_t)src[i];
+    }
     
-    /* 2. 长度字段（2字节，表示CMD+DATA的总长度） */
-    total_len = len + 1;  // +1 for CMD
-    buffer[index++] = (total_len >> 8) & 0xFF;
-    buffer[index++] = total_len & 0xFF;
+    return data_comm_commit(handle, DATA_COMM_STATS_CMD, DATA_COMM_STATS_SIZE);
+}
+
+/**
+  * @brief  统计查询命令处理函数
+  * @param  handle : 协议实例句柄
+  * @param  cmd    : 命令字节（未使用）
+  * @param  data   : 数据载荷（未使用）
+  * @param  len    : 数据载荷长度（未使用）
+  * @retval 无
+  * @note   放入命令分发表后，对端发送该命令即可取回统计计数
+  *         回复在数据包回调的上下文中发送，须满足同一实例发送函数在同一执行上下文调用的要求
+  *         （启用接收队列时回调位于data_comm_poll()所在的主循环中）
+  */
+void data_comm_stats_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)cmd;
+    (void)data;
+    (void)len;
+    data_comm_send_stats(handle);
+}
+#endif
+
+#if DATA_COMM_CAPTURE
+/**
+  * @brief  开始抓包
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  link   : 链路号（区分多个实例写入同一输出的记录）
+  * @param  mask   : 记录内容，DATA_COMM_CAP_MASK_RX/TX/FRAME的组合
+  * @param  sink   : 输出函数（NULL表示写入内置环形缓冲区）
+  * @retval 无
+  */
+void data_comm_capture_start(DataCommHandle *handle, uint8_t link, uint8_t mask, DataCommCaptureFunc sink)
+{
+    uint8_t info[DATA_COMM_CAP_FILE_SIZE] = {
+        'D', 'C', 'A', 'P', DATA_COMM_CAP_VERSION, DATA_COMM_CAP_FLAGS,
+        (uint8_t)(MAX_DATA_LENGTH >> 8), (uint8_t)MAX_DATA_LENGTH,
+        (uint8_t)(FRAME_HEADER >> 8), (uint8_t)FRAME_HEADER,
+        (uint8_t)(FRAME_END >> 8), (uint8_t)FRAME_END
+    };
     
-    /* 3. 命令字节（1字节） */
-    buffer[index++] = cmd;
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
     
-    /* 4. 数据载荷（len字节） */
-    if (data && len > 0) {
-        memcpy(&buffer[index], data, len);
-        index += len;
+    handle->cap_mask = 0;
+    handle->cap_sink = sink;
+    handle->cap_link = link;
+    handle->cap_rx_len = 0;
+    capture_emit(handle, DATA_COMM_CAP_FILE, DATA_COMM_CAPTURE_TIME(), 0, info, sizeof(info));
+    handle->cap_mask = mask;
+}
+
+/**
+  * @brief  输出暂存的逐字节接收数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_capture_flush(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
+    }
+    capture_rx_flush(handle);
+}
+
+/**
+  * @brief  停止抓包
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_capture_stop(DataCommHandle *handle)
+{
+    if (handle == NULL) {
+        handle = &g_default_handle;
     }
+    capture_rx_flush(handle);
+    handle->cap_mask = 0;
+}
+
+#if DATA_COMM_CAPTURE_RING_SIZE > 0
+/**
+  * @brief  从内置环形缓冲区取出完整记录
+  * @param  buf  : 输出缓冲区
+  * @param  size : 输出缓冲区长度
+  * @retval 取出的字节数
+  */
+size_t data_comm_capture_read(uint8_t *buf, size_t size)
+{
+    size_t n = 0;
+    uint32_t rec, pos, first;
     
-#if USE_CRC16
-    /* 5. CRC16校验（2字节）- 从长度字段开始计算 */
-    uint16_t crc = crc16_ccitt(&buffer[2], index - 2);
-    buffer[index++] = (crc >> 8) & 0xFF;
-    buffer[index++] = crc & 0xFF;
-#endif
+    if (buf == NULL) {
+        return 0;
+    }
     
-    /* 6. 帧尾（2字节） */
-    buffer[index++] = (FRAME_END >> 8) & 0xFF;
-    buffer[index++] = FRAME_END & 0xFF;
+    DATA_COMM_CAPTURE_LOCK();
+    while (g_cap_ring.head != g_cap_ring.tail) {
+        pos = g_cap_ring.tail + 2;
+        rec = DATA_COMM_CAP_HEAD_SIZE + (((uint32_t)g_cap_ring.buf[pos % DATA_COMM_CAPTURE_RING_SIZE] << 8) |
+                                         g_cap_ring.buf[(pos + 1) % DATA_COMM_CAPTURE_RING_SIZE]);
+        if (rec > size - n) {
+            break;
+        }
+        pos = g_cap_ring.tail % DATA_COMM_CAPTURE_RING_SIZE;
+        first = DATA_COMM_CAPTURE_RING_SIZE - pos;
+        if (first > rec) {
+            first = rec;
+        }
+        memcpy(&buf[n], &g_cap_ring.buf[pos], first);
+        memcpy(&buf[n + first], g_cap_ring.buf, rec - first);
+        n += rec;
+        g_cap_ring.tail += rec;
+    }
+    DATA_COMM_CAPTURE_UNLOCK();
     
-    /* 调用用户发送函数 */
-    user_transmit(buffer, index);
+    return n;
+}
+
+/**
+  * @brief  获取内置环形缓冲区丢弃的记录数
+  * @retval 丢弃的记录数
+  */
+uint32_t data_comm_capture_dropped(void)
+{
+    return g_cap_ring.dropped;
+}
+#endif
+#endif
+
+/* ========================= 兼容接口实现（默认实例） ========================= */
+/**
+  * @brief  初始化通信协议模块（默认实例）
+  * @param  无
+  * @retval 无
+  * @note   默认实例的发送和接收回调分别为user_transmit()和user_packet_handler()
+  */
+void data_comm_init(void)
+{
+    DataCommConfig config = {default_transmit, default_packet_handler, NULL, DEFAULT_TRANSMIT_ASYNC, NULL, NULL};
     
-    return index;
+    data_comm_init_ex(&g_default_handle, &config);
 }
 
 /**
-  * @brief  解析接收到的单个字节
+  * @brief  打包并发送数据（默认实例）
+  * @param  cmd  : 命令字节（1字节）
+  * @param  data : 数据载荷指针
+  * @param  len  : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 实际发送（或入队）的字节数，发送队列已满时返回0
+  */
+uint16_t data_comm_send(uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    return data_comm_send_ex(&g_default_handle, cmd, data, len);
+}
+
+/**
+  * @brief  解析接收到的单个字节（默认实例）
   * @param  byte : 接收到的字节
   * @retval 无
-  * @note   将接收到的每个字节传入此函数，内部自动进行协议解析
   */
 void data_comm_parse_byte(uint8_t byte)
 {
-    switch (g_ctx.state) {
-        case STATE_WAIT_HEADER1:
-            if (byte == ((FRAME_HEADER >> 8) & 0xFF)) {
-                g_ctx.state = STATE_WAIT_HEADER2;
-            }
-            break;
-            
-        case STATE_WAIT_HEADER2:
-            if (byte == (FRAME_HEADER & 0xFF)) {
-                g_ctx.state = STATE_WAIT_LENGTH_HIGH;
-                g_ctx.crc_index = 0;
-            } else {
-                g_ctx.state = STATE_WAIT_HEADER1;
-            }
-            break;
-            
-        case STATE_WAIT_LENGTH_HIGH:
-            g_ctx.pkg_length = byte << 8;
-            g_ctx.crc_buffer[g_ctx.crc_index++] = byte;
-            g_ctx.state = STATE_WAIT_LENGTH_LOW;
-            break;
-            
-        case STATE_WAIT_LENGTH_LOW:
-            g_ctx.pkg_length |= byte;
-            g_ctx.crc_buffer[g_ctx.crc_index++] = byte;
-            
-            /* 长度检查 */
-            if (g_ctx.pkg_length == 0 || g_ctx.pkg_length > (MAX_DATA_LENGTH + 1)) {
-                g_ctx.state = STATE_WAIT_HEADER1;
-                return;
-            }
-            g_ctx.state = STATE_WAIT_CMD;
-            break;
-            
-        case STATE_WAIT_CMD:
-            g_ctx.cmd = byte;
-            g_ctx.crc_buffer[g_ctx.crc_index++] = byte;
-            g_ctx.data_index = 0;
-            
-            /* 如果只有命令字节，没有数据 */
-            if (g_ctx.pkg_length == 1) {
-#if USE_CRC16
-                g_ctx.state = STATE_WAIT_CRC1;
-#else
-                g_ctx.state = STATE_WAIT_END1;
-#endif
-            } else {
-                g_ctx.state = STATE_READ_DATA;
-            }
-            break;
-            
-        case STATE_READ_DATA:
-            g_ctx.data[g_ctx.data_index] = byte;
-            g_ctx.crc_buffer[g_ctx.crc_index++] = byte;
-            g_ctx.data_index++;
-            
-            /* 数据接收完成 */
-            if (g_ctx.data_index >= (g_ctx.pkg_length - 1)) {
-#if USE_CRC16
-                g_ctx.state = STATE_WAIT_CRC1;
-#else
-                g_ctx.state = STATE_WAIT_END1;
-#endif
-            }
-            break;
-            
-#if USE_CRC16
-        case STATE_WAIT_CRC1:
-            g_ctx.recv_crc = byte << 8;
-            g_ctx.state = STATE_WAIT_CRC2;
-            break;
-            
-        case STATE_WAIT_CRC2:
-            g_ctx.recv_crc |= byte;
-            
-            /* CRC校验 */
-            uint16_t calc_crc = crc16_ccitt(g_ctx.crc_buffer, g_ctx.crc_index);
-            if (calc_crc != g_ctx.recv_crc) {
-                /* CRC错误，重新开始 */
-                g_ctx.state = STATE_WAIT_HEADER1;
-                return;
-            }
-            g_ctx.state = STATE_WAIT_END1;
-            break;
-#endif
-            
-        case STATE_WAIT_END1:
-            if (byte == ((FRAME_END >> 8) & 0xFF)) {
-                g_ctx.state = STATE_WAIT_END2;
-            } else {
-                g_ctx.state = STATE_WAIT_HEADER1;
-            }
-            break;
-            
-        case STATE_WAIT_END2:
-            if (byte == (FRAME_END & 0xFF)) {
-                /* 完整数据包接收成功，调用用户处理函数 */
-                user_packet_handler(g_ctx.cmd, g_ctx.data, g_ctx.data_index);
-            }
-            g_ctx.state = STATE_WAIT_HEADER1;
-            break;
-            
-        default:
-            g_ctx.state = STATE_WAIT_HEADER1;
-            break;
-    }
+    data_comm_parse_byte_ex(&g_default_handle, byte);
+}
+
+/**
+  * @brief  批量解析接收到的数据块（默认实例）
+  * @param  buf : 数据块指针
+  * @param  len : 数据块长度
+  * @retval 无
+  */
+void data_comm_parse_buffer(const uint8_t *buf, size_t len)
+{
+    data_comm_parse_buffer_ex(&g_default_handle, buf, len);
 }
 
 /* ========================= 用户需要实现的函数 ========================= */
 /**
-  * @brief  数据发送函数（用户必须实现）
+  * @brief  数据发送函数（用户必须实现，可直接修改此处或在其他文件中重新实现）
   * @param  data : 待发送数据缓冲区
   * @param  len  : 数据长度
   * @retval 无
   * @note   用户需根据实际硬件实现此函数
   *         示例：HAL_UART_Transmit(&huart1, data, len, 100);
   */
-void user_transmit(uint8_t *data, uint16_t len)
+DATA_COMM_WEAK void user_transmit(uint8_t *data, uint16_t len)
 {
     /* 此函数需要用户根据实际硬件实现 */
+    (void)data;
+    (void)len;
 }
 
 /**
@@ -273,7 +3102,101 @@ void user_transmit(uint8_t *data, uint16_t len)
   * @retval 无
   * @note   当接收到完整数据包时被调用
   */
-void user_packet_handler(uint8_t cmd, uint8_t *data, uint16_t len)
+DATA_COMM_WEAK void user_packet_handler(uint8_t cmd, uint8_t *data, uint16_t len)
 {
     /* 此函数需要用户实现数据包处理逻辑 */
-}
\ No newline at end of file
+    (void)cmd;
+    (void)data;
+    (void)len;
+}
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  异步发送函数（启用发送队列时用户必须实现）
+  * @param  data : 待发送数据缓冲区（发送完成前保持有效）
+  * @param  len  : 数据长度
+  * @retval 无
+  * @note   启动DMA发送后立即返回，发送完成中断中调用data_comm_tx_complete_isr(NULL)
+  *         示例：HAL_UART_Transmit_DMA(&huart1, data, len);
+  */
+DATA_COMM_WEAK void user_transmit_async(uint8_t *data, uint16_t len)
+{
+    /* 此函数需要用户根据实际硬件实现 */
+    (void)data;
+    (void)len;
+}
+#endif
+
+#if DATA_COMM_STATS && DATA_COMM_STATS_CYCLES
+/**
+  * @brief  读取周期计数器（启用解析耗时统计时用户必须实现）
+  * @param  无
+  * @retval 自由运行的32位周期计数
+  * @note   Cortex-M3/M4示例（需先使能DWT）：return DWT->CYCCNT;
+  */
+DATA_COMM_WEAK uint32_t user_cycle_count(void)
+{
+    /* 此函数需要用户根据实际硬件实现 */
+    return 0;
+}
+#endif
+
+#if DATA_COMM_CAPTURE
+/**
+  * @brief  读取抓包时间戳（启用抓包时可选实现）
+  * @param  无
+  * @retval 自由运行的32位时间
+  * @note   示例：return TIM2->CNT;（1MHz自由运行定时器）
+  */
+DATA_COMM_WEAK uint32_t user_capture_time(void)
+{
+    return 0;
+}
+#endif
+
+#if DATA_COMM_TX_PRIO > 0 && DATA_COMM_STATS
+/**
+  * @brief  读取发送排队时延时间戳（启用发送优先级统计时用户必须实现）
+  * @param  无
+  * @retval 自由运行的32位时间
+  * @note   示例：return TIM2->CNT;（1MHz自由运行定时器）
+  */
+DATA_COMM_WEAK uint32_t user_tx_time(void)
+{
+    /* 此函数需要用户根据实际硬件实现 */
+    return 0;
+}
+#endif
+
+#if DATA_COMM_CHECKSUM
+/**
+  * @brief  外设CRC计算（使用data_comm_checksum_hw时可选实现）
+  * @param  crc  : 当前CRC值
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval 更新后的CRC值
+  * @note   默认用软件CRC16计算；示例（STM32 CRC外设，16位多项式0x1021）：
+  *         CRC->INIT = crc; CRC->CR = CRC_CR_POLYSIZE_0 | CRC_CR_RESET;
+  *         逐字节写入*(volatile uint8_t *)&CRC->DR，最后return CRC->DR & 0xFFFF;
+  */
+DATA_COMM_WEAK uint32_t user_checksum_hw(uint32_t crc, const uint8_t *data, uint16_t len)
+{
+    return data_comm_crc16((uint16_t)crc, data, len);
+}
+
+/**
+  * @brief  启动外设CRC异步计算（使用data_comm_checksum_hw时可选实现）
+  * @param  handle : 协议实例句柄
+  * @param  data   : 待计算数据
+  * @param  len    : 数据长度
+  * @retval 0-未启动，由user_checksum_hw()同步计算
+  * @note   用DMA把data喂入CRC外设时返回1，DMA完成中断中调用data_comm_checksum_done(handle, CRC->DR & 0xFFFF)
+  */
+DATA_COMM_WEAK uint8_t user_checksum_hw_start(DataCommHandle *handle, const uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)data;
+    (void)len;
+    return 0;
+}
+#endif
\ No newline at end of file
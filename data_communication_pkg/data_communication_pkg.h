@@ -15,16 +15,237 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* ========================= 用户配置参数区 ========================= */
 /**
   * @brief  协议参数配置
   * @note   用户可根据实际需求修改以下参数
   */
+#ifndef FRAME_HEADER
 #define FRAME_HEADER      0xAA55      // 帧头（2字节）
+#endif
+#ifndef FRAME_END
 #define FRAME_END         0x55AA      // 帧尾（2字节）
+#endif
+#ifndef MAX_DATA_LENGTH
 #define MAX_DATA_LENGTH   256         // 最大数据载荷长度（字节）
+#endif
+#ifndef USE_CRC16
 #define USE_CRC16         1           // 是否启用CRC16校验（0-禁用，1-启用）
+#endif
+#ifndef CRC16_METHOD
+#define CRC16_METHOD      CRC16_METHOD_TABLE  // CRC16计算方式（见下方可选值）
+#endif
+#ifndef DATA_COMM_CHECKSUM
+#define DATA_COMM_CHECKSUM 0          // 是否可按实例选择校验算法（CRC16/CRC32/Fletcher-16/硬件CRC，需USE_CRC16=1）
+#endif
+#ifndef DATA_COMM_FRAMING
+#define DATA_COMM_FRAMING DATA_COMM_FRAMING_HEADER // 帧格式（见下方可选值，收发双方须一致）
+#endif
+#ifndef DATA_COMM_RESYNC
+#define DATA_COMM_RESYNC          0   // 帧校验失败后是否在已接收字节中重新搜索帧头（仅帧头帧尾格式）
+#endif
+#ifndef DATA_COMM_TX_QUEUE_SIZE
+#define DATA_COMM_TX_QUEUE_SIZE   0   // 异步发送队列帧槽数（0-禁用，否则须为2的幂，如2/4/8）
+#endif
+#ifndef DATA_COMM_TX_PRIO
+#define DATA_COMM_TX_PRIO         0   // 发送优先级数（0-禁用，2~8，需DATA_COMM_TX_QUEUE_SIZE>0，每级一个发送队列，0级最高）
+#endif
+#ifndef DATA_COMM_CMD_REGISTER_MAX
+#define DATA_COMM_CMD_REGISTER_MAX 0  // 每个实例可运行时注册的命令数（0-禁用data_comm_register，仅用常量分发表）
+#endif
+#ifndef DATA_COMM_RX_QUEUE_SIZE
+#define DATA_COMM_RX_QUEUE_SIZE   0   // 接收数据包队列槽数（0-中断中直接回调，否则须为2的幂，由data_comm_poll()处理）
+#endif
+#ifndef DATA_COMM_BATCH
+#define DATA_COMM_BATCH           0   // 是否启用小消息合并发送/拆分接收（0-禁用，1-启用）
+#endif
+#ifndef DATA_COMM_BATCH_SIZE
+#define DATA_COMM_BATCH_SIZE      MAX_DATA_LENGTH // 合并帧载荷上限（字节），达到后立即发送
+#endif
+#ifndef DATA_COMM_BATCH_TIMEOUT
+#define DATA_COMM_BATCH_TIMEOUT   2   // 合并等待时限（data_comm_tick()的时间单位，如ms），超时后发送
+#endif
+#ifndef DATA_COMM_BATCH_CMD
+#define DATA_COMM_BATCH_CMD       0xFD // 合并帧使用的命令字节
+#endif
+#ifndef DATA_COMM_RELIABLE
+#define DATA_COMM_RELIABLE        0   // 是否启用可靠传输（序号+确认+滑动窗口重传，0-禁用，1-启用）
+#endif
+#ifndef DATA_COMM_REL_WINDOW
+#define DATA_COMM_REL_WINDOW      8   // 可靠传输发送窗口（未确认帧数，须为2的幂且不超过32）
+#endif
+#ifndef DATA_COMM_REL_RTO
+#define DATA_COMM_REL_RTO         20  // 重传超时（data_comm_tick()的时间单位，如ms）
+#endif
+#ifndef DATA_COMM_REL_CMD
+#define DATA_COMM_REL_CMD         0xFC // 可靠数据帧使用的命令字节
+#endif
+#ifndef DATA_COMM_REL_ACK_CMD
+#define DATA_COMM_REL_ACK_CMD     0xFB // 确认帧使用的命令字节
+#endif
+#ifndef DATA_COMM_STATS
+#define DATA_COMM_STATS           0   // 是否启用收发统计计数（0-禁用，1-启用）
+#endif
+#ifndef DATA_COMM_STATS_CYCLES
+#define DATA_COMM_STATS_CYCLES    0   // 是否统计每帧解析耗时（需DATA_COMM_STATS，调用user_cycle_count()）
+#endif
+#ifndef DATA_COMM_STATS_CMD
+#define DATA_COMM_STATS_CMD       0xFE // data_comm_send_stats()发送统计数据使用的命令字节
+#endif
+#ifndef DATA_COMM_STREAM
+#define DATA_COMM_STREAM          0   // 是否启用流式接收（载荷边收边交给回调，可超过MAX_DATA_LENGTH，仅帧头帧尾格式）
+#endif
+#ifndef DATA_COMM_STREAM_MAX_LENGTH
+#define DATA_COMM_STREAM_MAX_LENGTH 4096 // 流式接收单帧载荷上限（字节，不超过65534）
+#endif
+#ifndef DATA_COMM_FRAG
+#define DATA_COMM_FRAG            0   // 是否启用大数据块分片发送/重组（0-禁用，1-启用）
+#endif
+#ifndef DATA_COMM_FRAG_CMD
+#define DATA_COMM_FRAG_CMD        0xFA // 分片帧使用的命令字节
+#endif
+#ifndef DATA_COMM_CAPTURE
+#define DATA_COMM_CAPTURE         0   // 是否启用收发抓包记录（0-禁用，1-启用）
+#endif
+#ifndef DATA_COMM_CAPTURE_RING_SIZE
+#define DATA_COMM_CAPTURE_RING_SIZE 0 // 内置RAM环形抓包缓冲区字节数（0-不使用，否则须为2的幂，各实例共用）
+#endif
+#ifndef DATA_COMM_CAPTURE_CHUNK
+#define DATA_COMM_CAPTURE_CHUNK   32  // 逐字节接收时合并为一条记录的最大字节数
+#endif
+
+/**
+  * @brief  CRC16计算方式可选值
+  * @note   BITWISE: 逐位计算，无查找表，最省Flash
+  *         TABLE  : 单表逐字节查表，512字节Flash
+  *         SLICE4 : 4字节并行查表（slice-by-4），2KB Flash
+  *         SLICE8 : 8字节并行查表（slice-by-8），4KB Flash
+  *         逐字节解析时各方式均按单字节查表更新，slice方式仅加速整块计算（发送打包）
+  */
+#define CRC16_METHOD_BITWISE  0
+#define CRC16_METHOD_TABLE    1
+#define CRC16_METHOD_SLICE4   2
+#define CRC16_METHOD_SLICE8   3
+
+#define CRC16_INIT        0xFFFF      // CRC16-CCITT初始值
+
+/**
+  * @brief  帧格式可选值
+  * @note   HEADER: 帧头(2) + 长度(2) + 命令(1) + 数据(n) + CRC16(2) + 帧尾(2)
+  *         COBS  : COBS编码[长度(2) + 命令(1) + 数据(n) + CRC16(2)] + 分隔符0x00
+  *                 编码后帧内不含0x00，任何错误最多丢失到下一个分隔符，保证重新同步
+  */
+#define DATA_COMM_FRAMING_HEADER  0
+#define DATA_COMM_FRAMING_COBS    1
+
+#if DATA_COMM_CHECKSUM && !USE_CRC16
+#error "DATA_COMM_CHECKSUM需要USE_CRC16=1"
+#endif
+/* 校验字段最大字节数：CRC16为2，可选校验算法时按最长的CRC32预留4 */
+#define DATA_COMM_CRC_SIZE        (USE_CRC16 ? (DATA_COMM_CHECKSUM ? 4 : 2) : 0)
+
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+/* 帧开销：COBS编码开销 + 长度(2) + 命令(1) + CRC(2/4) + 分隔符(1) */
+#define DATA_COMM_COBS_PREFIX     (1 + (MAX_DATA_LENGTH + 3 + DATA_COMM_CRC_SIZE) / 254)
+#define DATA_COMM_FRAME_OVERHEAD  (DATA_COMM_COBS_PREFIX + 4 + DATA_COMM_CRC_SIZE)
+#else
+/* 帧开销：帧头(2) + 长度(2) + 命令(1) + CRC(2/4) + 帧尾(2) */
+#define DATA_COMM_FRAME_OVERHEAD  (7 + DATA_COMM_CRC_SIZE)
+#endif
+#define DATA_COMM_FRAME_SIZE      (MAX_DATA_LENGTH + DATA_COMM_FRAME_OVERHEAD) // 最大帧长度
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+#if (DATA_COMM_TX_QUEUE_SIZE & (DATA_COMM_TX_QUEUE_SIZE - 1)) != 0 || DATA_COMM_TX_QUEUE_SIZE > 128
+#error "DATA_COMM_TX_QUEUE_SIZE必须为2的幂且不超过128"
+#endif
+#if DATA_COMM_TX_PRIO > 0
+#if DATA_COMM_TX_PRIO < 2 || DATA_COMM_TX_PRIO > 8
+#error "DATA_COMM_TX_PRIO必须为2~8"
+#endif
+#define DATA_COMM_TX_CLASSES      DATA_COMM_TX_PRIO
+#else
+#define DATA_COMM_TX_CLASSES      1
+#endif
+#define DATA_COMM_TX_SLOTS        (DATA_COMM_TX_QUEUE_SIZE * DATA_COMM_TX_CLASSES)
+#else
+#if DATA_COMM_TX_PRIO > 0
+#error "DATA_COMM_TX_PRIO需要DATA_COMM_TX_QUEUE_SIZE>0"
+#endif
+#define DATA_COMM_TX_SLOTS        1
+#endif
+
+#if DATA_COMM_BATCH && (DATA_COMM_BATCH_SIZE > MAX_DATA_LENGTH || DATA_COMM_BATCH_SIZE < 2)
+#error "DATA_COMM_BATCH_SIZE必须在2~MAX_DATA_LENGTH之间"
+#endif
+
+#if DATA_COMM_RELIABLE
+#if (DATA_COMM_REL_WINDOW & (DATA_COMM_REL_WINDOW - 1)) != 0 || DATA_COMM_REL_WINDOW > 32
+#error "DATA_COMM_REL_WINDOW必须为2的幂且不超过32"
+#endif
+#define DATA_COMM_REL_HEADER      5   // 可靠数据帧头：会话号(1) + 标志(1) + 序号(1) + 窗口起点(1) + 命令(1)
+#define DATA_COMM_REL_FLAG_SYN    0x01 // 会话建立标志：数据帧表示发送端尚未收到本会话的确认，确认帧表示接收窗口由该标志的数据帧建立
+#define DATA_COMM_REL_MAX_DATA    (MAX_DATA_LENGTH - DATA_COMM_REL_HEADER) // 可靠传输单条消息最大长度
+#endif
+
+#if DATA_COMM_STREAM
+#if DATA_COMM_FRAMING != DATA_COMM_FRAMING_HEADER
+#error "DATA_COMM_STREAM仅支持帧头帧尾格式"
+#endif
+#if DATA_COMM_STREAM_MAX_LENGTH < MAX_DATA_LENGTH || DATA_COMM_STREAM_MAX_LENGTH > 65534
+#error "DATA_COMM_STREAM_MAX_LENGTH必须在MAX_DATA_LENGTH~65534之间"
+#endif
+#endif
+
+#if DATA_COMM_FRAG
+#define DATA_COMM_FRAG_HEADER     10  // 分片头：数据块编号(1) + 命令(1) + 偏移(4) + 总长度(4)
+#define DATA_COMM_FRAG_DATA       (MAX_DATA_LENGTH - DATA_COMM_FRAG_HEADER) // 每个分片携带的数据长度
+#if MAX_DATA_LENGTH <= DATA_COMM_FRAG_HEADER
+#error "启用DATA_COMM_FRAG时MAX_DATA_LENGTH必须大于DATA_COMM_FRAG_HEADER"
+#endif
+#endif
+
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+#if (DATA_COMM_RX_QUEUE_SIZE & (DATA_COMM_RX_QUEUE_SIZE - 1)) != 0 || DATA_COMM_RX_QUEUE_SIZE > 128
+#error "DATA_COMM_RX_QUEUE_SIZE必须为2的幂且不超过128"
+#endif
+#endif
+
+/**
+  * @brief  抓包记录格式
+  * @note   记录头(8)：类型(1) + 链路号(1) + 数据长度(2) + 时间戳(4)，多字节字段大端序，后接数据
+  *         FILE : 魔数"DCAP"(4) + 版本(1) + 配置标志(1) + MAX_DATA_LENGTH(2) + FRAME_HEADER(2) + FRAME_END(2)
+  *         RX   : 接收到的原始字节（逐字节解析时合并为不超过DATA_COMM_CAPTURE_CHUNK字节一条，时间戳为首字节）
+  *         TX   : 发送的完整帧
+  *         FRAME: 校验通过的帧：命令(1) + 数据载荷
+  *         记录首尾相接、只追加，可直接写入文件，由host/data_comm_replay.c回放
+  */
+#define DATA_COMM_CAP_FILE        0
+#define DATA_COMM_CAP_RX          1
+#define DATA_COMM_CAP_TX          2
+#define DATA_COMM_CAP_FRAME       3
+#define DATA_COMM_CAP_MASK_RX     (1u << DATA_COMM_CAP_RX)     // data_comm_capture_start()记录内容选择
+#define DATA_COMM_CAP_MASK_TX     (1u << DATA_COMM_CAP_TX)
+#define DATA_COMM_CAP_MASK_FRAME  (1u << DATA_COMM_CAP_FRAME)
+#define DATA_COMM_CAP_MASK_ALL    (DATA_COMM_CAP_MASK_RX | DATA_COMM_CAP_MASK_TX | DATA_COMM_CAP_MASK_FRAME)
+#define DATA_COMM_CAP_HEAD_SIZE   8   // 记录头长度
+#define DATA_COMM_CAP_FILE_SIZE   12  // FILE记录数据长度
+#define DATA_COMM_CAP_VERSION     1   // 记录格式版本
+
+/* FILE记录配置标志：回放时须与回放程序的协议配置一致 */
+#define DATA_COMM_CAP_FLAGS       ((DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS ? 0x01 : 0) | \
+                                   (USE_CRC16 ? 0x02 : 0) | (DATA_COMM_RESYNC ? 0x04 : 0) | \
+                                   (DATA_COMM_BATCH ? 0x08 : 0) | (DATA_COMM_RELIABLE ? 0x10 : 0))
+
+#if DATA_COMM_CAPTURE
+#if DATA_COMM_CAPTURE_RING_SIZE > 0 && (DATA_COMM_CAPTURE_RING_SIZE & (DATA_COMM_CAPTURE_RING_SIZE - 1)) != 0
+#error "DATA_COMM_CAPTURE_RING_SIZE必须为2的幂"
+#endif
+#if DATA_COMM_CAPTURE_CHUNK < 1 || DATA_COMM_CAPTURE_CHUNK > 255
+#error "DATA_COMM_CAPTURE_CHUNK必须在1~255之间"
+#endif
+#endif
 
 /* ========================= 数据类型定义 ========================= */
 /**
@@ -38,11 +259,681 @@ typedef enum {
     PKG_END_ERR           // 帧尾错误
 } PkgStatus;
 
+/**
+  * @brief  解析状态机状态定义
+  */
+typedef enum {
+    STATE_WAIT_HEADER1,       // 等待帧头第1字节
+    STATE_WAIT_HEADER2,       // 等待帧头第2字节
+    STATE_WAIT_LENGTH_HIGH,   // 等待长度高字节
+    STATE_WAIT_LENGTH_LOW,    // 等待长度低字节
+    STATE_WAIT_CMD,           // 等待命令字节
+    STATE_READ_DATA,          // 读取数据载荷
+    STATE_WAIT_CRC1,          // 等待CRC高字节（4字节校验值时为前3字节）
+    STATE_WAIT_CRC2,          // 等待CRC低字节
+    STATE_WAIT_END1,          // 等待帧尾第1字节
+    STATE_WAIT_END2           // 等待帧尾第2字节
+} ParseState;
+
+/**
+  * @brief  解析上下文结构体
+  */
+typedef struct {
+    ParseState state;                    // 当前解析状态
+    uint16_t data_index;                 // 数据索引
+    uint16_t pkg_length;                 // 数据包长度（CMD+DATA）
+    uint8_t cmd;                         // 命令字节
+    uint8_t data[MAX_DATA_LENGTH];       // 数据缓冲区
+#if DATA_COMM_CHECKSUM
+    uint32_t recv_crc;                   // 接收到的校验值
+    uint32_t calc_crc;                   // 边接收边计算的校验状态（长度+命令+数据）
+    uint8_t crc_count;                   // 已接收的校验值字节数
+#else
+    uint16_t recv_crc;                   // 接收到的CRC
+    uint16_t calc_crc;                   // 边接收边计算的CRC（长度+命令+数据）
+#endif
+#if DATA_COMM_FRAMING == DATA_COMM_FRAMING_COBS
+    uint8_t cobs_remaining;              // COBS当前块剩余数据字节数
+    uint8_t cobs_zero;                   // COBS当前块结束后是否隐含0x00
+#endif
+#if DATA_COMM_STREAM
+    uint8_t streaming;                   // 当前帧是否以流式交付
+    uint16_t stream_fill;                // 逐字节接收时data中暂存、尚未交给chunk回调的字节数
+#endif
+} ParseContext;
+
+/**
+  * @brief  接收队列中的数据包槽
+  */
+typedef struct {
+    uint8_t cmd;                         // 命令字节
+    uint16_t len;                        // 数据载荷长度
+    uint8_t data[MAX_DATA_LENGTH];       // 数据载荷
+} DataCommPacket;
+
+/**
+  * @brief  收发统计计数
+  * @note   需DATA_COMM_STATS为1；计数均为uint32_t，溢出后回绕
+  */
+typedef struct {
+    uint32_t frames_ok;                  // 校验通过的帧数
+    uint32_t header_err;                 // 帧头错误次数
+    uint32_t length_err;                 // 长度错误次数（COBS格式含帧被截断）
+    uint32_t crc_err;                    // CRC错误次数
+    uint32_t end_err;                    // 帧尾错误次数
+    uint32_t discard_bytes;              // 搜索帧头（COBS格式为等待分隔符）时丢弃的字节数
+    uint32_t rx_overflow;                // 接收队列已满而丢弃的帧数
+    uint32_t cmd_unknown;                // 无处理函数而丢弃的数据包数
+    uint32_t cmd_len_err;                // 载荷长度不符合分发表而丢弃的数据包数
+    uint32_t tx_frames;                  // 已发送（或入队）的帧数
+    uint32_t tx_bytes;                   // 已发送（或入队）的字节数
+    uint32_t tx_queue_hwm;               // 发送队列最高水位（帧数）
+    uint32_t parse_cycles_last;          // 最近一帧的解析耗时（user_cycle_count()计数）
+    uint32_t parse_cycles_max;           // 单帧解析耗时最大值
+    uint32_t parse_cycles_total;         // 所有帧解析耗时累计，除以frames_ok得平均值
+} DataCommStats;
+
+#define DATA_COMM_STATS_SIZE      60  // data_comm_send_stats()载荷长度：DataCommStats的15个计数
+
+/**
+  * @brief  发送优先级统计计数
+  * @note   需DATA_COMM_TX_PRIO>0且DATA_COMM_STATS为1；时延为入队到开始发送（交给transmit_async）的时间，
+  *         单位为user_tx_time()的计数单位
+  */
+typedef struct {
+    uint32_t frames;                     // 已开始发送的帧数
+    uint32_t bytes;                      // 已开始发送的字节数
+    uint32_t queue_full;                 // 队列已满而拒绝的发送次数
+    uint32_t rate_limited;               // 超出速率限制而拒绝的发送次数
+    uint32_t queue_hwm;                  // 队列最高水位（帧数）
+    uint32_t latency_last;               // 最近一帧的排队时延
+    uint32_t latency_max;                // 排队时延最大值
+    uint32_t latency_total;              // 排队时延累计，除以frames得平均值
+} DataCommTxClassStats;
+
+#if DATA_COMM_STATS && MAX_DATA_LENGTH < DATA_COMM_STATS_SIZE
+#error "启用DATA_COMM_STATS时MAX_DATA_LENGTH不能小于DATA_COMM_STATS_SIZE"
+#endif
+
+#if DATA_COMM_RELIABLE
+/**
+  * @brief  可靠传输发送窗口槽
+  */
+typedef struct {
+    uint8_t state;                       // 槽状态：0-空闲，1-等待确认，2-已被选择确认
+    uint8_t cmd;                         // 命令字节
+    uint8_t sent;                        // 是否已发送过（发送队列满时为0，由data_comm_tick()补发）
+    uint8_t fast;                        // 本次发送后是否已快速重传过
+    uint16_t len;                        // 数据载荷长度
+    uint32_t sent_time;                  // 最近一次发送时间
+    uint8_t data[DATA_COMM_REL_MAX_DATA];// 数据载荷（确认前保留，用于重传）
+} DataCommRelSlot;
+#endif
+
+typedef struct DataCommHandle DataCommHandle;
+
+/**
+  * @brief  实例发送函数类型
+  * @param  handle : 协议实例句柄
+  * @param  data   : 待发送的完整帧
+  * @param  len    : 帧长度
+  */
+typedef void (*DataCommTransmitFunc)(DataCommHandle *handle, uint8_t *data, uint16_t len);
+
+/**
+  * @brief  实例数据包接收回调类型
+  * @param  handle : 协议实例句柄
+  * @param  cmd    : 命令字节
+  * @param  data   : 数据载荷缓冲区
+  * @param  len    : 数据载荷长度
+  */
+typedef void (*DataCommPacketFunc)(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len);
+
+/**
+  * @brief  抓包输出函数类型
+  * @param  handle   : 协议实例句柄
+  * @param  head     : 记录头（FRAME记录为记录头+命令字节）
+  * @param  head_len : 记录头长度
+  * @param  data     : 记录数据
+  * @param  data_len : 记录数据长度
+  * @note   依次写出head和data即为一条完整记录
+  */
+typedef void (*DataCommCaptureFunc)(DataCommHandle *handle, const uint8_t *head, uint8_t head_len,
+                                    const uint8_t *data, uint16_t data_len);
+
+/**
+  * @brief  流式接收回调
+  * @note   流式帧（DATA_COMM_STREAM）和分片数据块（DATA_COMM_FRAG）共用，在解析上下文（通常为中断）中调用
+  *         begin: 一帧/一个数据块开始，total为载荷总长度；返回1以流式接收，返回0则该帧照常缓存后交付
+  *                （超过MAX_DATA_LENGTH的帧被丢弃，数据块被忽略）
+  *         chunk: 按顺序交付的一段载荷，data仅在回调期间有效；流式帧的数据在end(ok=1)之前尚未通过CRC校验
+  *         end  : 结束，ok为1表示完整且校验通过，为0表示出错中止，已交付的数据应作废
+  */
+typedef struct {
+    uint8_t (*begin)(DataCommHandle *handle, uint8_t cmd, uint32_t total);
+    void (*chunk)(DataCommHandle *handle, const uint8_t *data, uint16_t len);
+    void (*end)(DataCommHandle *handle, uint8_t ok);
+} DataCommStreamOps;
+
+/**
+  * @brief  校验算法
+  * @note   需DATA_COMM_CHECKSUM为1，用data_comm_set_checksum()为实例选择，收发双方须一致
+  *         校验范围为长度+命令+数据：state = update(init, ...)可分段调用，final(state)为发送的校验值
+  *         start  : 可选，发送时把整帧交给外设（如DMA喂入的硬件CRC）异步计算，返回1表示已启动，
+  *                  完成后调用data_comm_checksum_done()；返回0则改用update同步计算。接收总是用update
+  */
+typedef struct {
+    uint8_t size;                                         // 校验值字节数（2或4）
+    uint32_t init;                                        // 初始状态
+    uint32_t (*update)(uint32_t state, const uint8_t *data, uint16_t len); // 累计一段数据
+    uint32_t (*final)(uint32_t state);                    // 由状态得到校验值（NULL表示即为状态）
+    uint8_t (*start)(DataCommHandle *handle, const uint8_t *data, uint16_t len); // 异步计算（可为NULL）
+} DataCommChecksum;
+
+/**
+  * @brief  命令分发表项
+  * @note   分发表为256项数组，以命令字节为下标，可定义为const放在Flash中：
+  *         static const DataCommCmdEntry table[256] = {
+  *             DATA_COMM_CMD(0x01, on_sensor, 4, 4),
+  *             DATA_COMM_CMD(0x02, on_led,    1, 1),
+  *         };
+  */
+typedef struct {
+    DataCommPacketFunc handler;          // 命令处理函数（NULL表示该命令未注册）
+    uint16_t min_len;                    // 允许的最小载荷长度
+    uint16_t max_len;                    // 允许的最大载荷长度
+} DataCommCmdEntry;
+
+/* 分发表项初始化宏 */
+#define DATA_COMM_CMD(cmd, handler, min_len, max_len)  [(cmd)] = { (handler), (min_len), (max_len) }
+
+/**
+  * @brief  协议实例配置结构体
+  */
+typedef struct {
+    DataCommTransmitFunc transmit;       // 发送函数（为NULL时不发送）
+    DataCommPacketFunc packet_handler;   // 数据包接收回调（为NULL时丢弃）
+    void *user_data;                     // 用户私有数据（如UART句柄），回调中通过handle->config.user_data取得
+    DataCommTransmitFunc transmit_async; // 异步发送函数（需DATA_COMM_TX_QUEUE_SIZE>0，为NULL时使用同步transmit）
+    const DataCommCmdEntry *cmd_table;   // 常量命令分发表（256项，为NULL时全部交给packet_handler）
+    const DataCommStreamOps *stream;     // 流式接收回调（需DATA_COMM_STREAM或DATA_COMM_FRAG，为NULL时不使用）
+} DataCommConfig;
+
+/**
+  * @brief  协议实例结构体
+  * @note   由用户静态分配，每路通信链路（UART/SPI等）一个实例
+  *         成员仅供库内部使用，用户只需读取config.user_data
+  */
+struct DataCommHandle {
+    DataCommConfig config;                   // 实例配置
+    ParseContext rx;                         // 接收解析上下文
+    uint32_t cmd_unknown;                    // 无处理函数而丢弃的数据包数
+    uint32_t cmd_len_err;                    // 载荷长度不符合分发表而丢弃的数据包数
+#if DATA_COMM_CMD_REGISTER_MAX > 0
+    uint8_t cmd_index[256];                  // 命令字节 -> 注册项序号+1（0表示未注册）
+    DataCommCmdEntry cmd_entries[DATA_COMM_CMD_REGISTER_MAX]; // 运行时注册项
+#endif
+    uint8_t tx_buffer[DATA_COMM_TX_SLOTS][DATA_COMM_FRAME_SIZE]; // 发送帧缓冲区（异步发送时为帧槽环形队列）
+    uint8_t tx_reserved;                     // 发送缓冲区是否已被data_comm_reserve()预留
+    uint16_t tx_reserve_len;                 // 预留的载荷长度
+#if DATA_COMM_CHECKSUM
+    const DataCommChecksum *checksum;        // 校验算法（NULL表示内置CRC16）
+    uint8_t *volatile csum_frame;            // 等待异步校验完成的帧（NULL表示无）
+    uint16_t csum_index;                     // 该帧校验字段的位置
+#endif
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+    uint16_t tx_frame_len[DATA_COMM_TX_SLOTS]; // 各帧槽的帧长度
+    volatile uint8_t tx_head[DATA_COMM_TX_CLASSES]; // 各级队首计数（正在发送的帧，仅发送完成中断修改）
+    volatile uint8_t tx_tail[DATA_COMM_TX_CLASSES]; // 各级队尾计数（下一空闲帧槽，仅发送函数修改）
+    volatile uint8_t tx_active;              // 是否有帧正在发送
+#endif
+#if DATA_COMM_TX_PRIO > 0
+    volatile uint8_t tx_cur;                 // 正在发送的帧所在优先级
+    uint8_t tx_class;                        // 发送函数使用的优先级（data_comm_set_tx_prio()）
+    uint32_t tx_rate[DATA_COMM_TX_PRIO];     // 各级速率限制（字节/data_comm_tick()时间单位，0表示不限制）
+    uint32_t tx_burst[DATA_COMM_TX_PRIO];    // 各级令牌桶容量（字节）
+    int32_t tx_tokens[DATA_COMM_TX_PRIO];    // 各级剩余令牌（字节，为负时拒绝发送）
+#if DATA_COMM_STATS
+    uint32_t tx_enqueue_time[DATA_COMM_TX_SLOTS]; // 各帧槽的入队时间
+    DataCommTxClassStats tx_class_stats[DATA_COMM_TX_PRIO]; // 各级统计计数
+#endif
+#endif
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+    DataCommPacket rx_queue[DATA_COMM_RX_QUEUE_SIZE]; // 接收数据包环形队列
+    volatile uint8_t rx_head;                // 队首计数（仅data_comm_poll()修改）
+    volatile uint8_t rx_tail;                // 队尾计数（仅解析函数修改）
+    volatile uint32_t rx_overflow;           // 队列已满而丢弃的帧数
+#endif
+#if DATA_COMM_BATCH || DATA_COMM_RELIABLE || DATA_COMM_TX_PRIO > 0
+    uint32_t tick_now;                       // 最近一次data_comm_tick()传入的时间
+#endif
+#if DATA_COMM_BATCH
+    uint8_t batch_buf[DATA_COMM_BATCH_SIZE]; // 待发送的合并帧载荷
+    uint16_t batch_len;                      // 合并帧载荷已用长度
+    uint8_t batch_count;                     // 合并帧内的消息数
+    uint32_t batch_start;                    // 合并帧内第一条消息的时间
+#endif
+#if DATA_COMM_RELIABLE
+    DataCommRelSlot rel_tx[DATA_COMM_REL_WINDOW]; // 发送窗口（按序号对窗口取模）
+    uint8_t rel_session;                     // 发送会话号（0表示尚未建立）
+    uint8_t rel_syn;                         // 发送会话建立中：尚未收到带DATA_COMM_REL_FLAG_SYN的确认
+    volatile uint8_t rel_snd_una;            // 最早未确认的序号（窗口起点，仅确认处理修改）
+    volatile uint8_t rel_snd_nxt;            // 下一个待分配的序号（仅data_comm_rel_send()修改）
+    uint32_t rel_retransmits;                // 重传次数
+    uint8_t rel_rx_session;                  // 接收会话号（0表示尚未收到）
+    uint8_t rel_rx_syn;                      // 接收窗口由会话建立帧开始，尚未收到本会话的普通数据帧
+    uint32_t rel_resyncs;                    // 接收窗口重新开始的次数（对端新会话或会话建立帧）
+    uint8_t rel_rcv_nxt;                     // 期望接收的下一个序号
+    uint32_t rel_rcv_mask;                   // 已接收位图：bit i对应序号rel_rcv_nxt + i
+    volatile uint8_t rel_ack_pending;        // 是否需要发送确认帧
+#endif
+#if DATA_COMM_FRAG
+    uint8_t frag_tx_id;                      // 最近发送的数据块编号
+    uint8_t frag_rx_active;                  // 是否正在重组数据块
+    uint8_t frag_rx_id;                      // 正在重组的数据块编号
+    uint32_t frag_rx_next;                   // 期望的下一分片偏移
+    uint32_t frag_rx_total;                  // 正在重组的数据块总长度
+    uint32_t frag_rx_err;                    // 因分片丢失、乱序而中止的数据块数
+#endif
+#if DATA_COMM_STATS
+    DataCommStats stats;                     // 收发统计计数
+#if DATA_COMM_STATS_CYCLES
+    uint32_t cycles_start;                   // 本次解析调用开始时的周期计数
+    uint32_t cycles_acc;                     // 当前帧已累计的解析耗时
+#endif
+#endif
+#if DATA_COMM_CAPTURE
+    DataCommCaptureFunc cap_sink;            // 抓包输出（NULL表示内置环形缓冲区）
+    uint8_t cap_mask;                        // 记录内容（0表示未启用）
+    uint8_t cap_link;                        // 链路号，写入每条记录
+    uint8_t cap_rx_len;                      // 待输出的逐字节接收数据长度
+    uint32_t cap_rx_time;                    // 待输出接收数据首字节的时间戳
+    uint8_t cap_rx_buf[DATA_COMM_CAPTURE_CHUNK]; // 逐字节接收数据暂存
+#endif
+};
+
+/**
+  * @brief  分散载荷片段（用于data_comm_sendv）
+  */
+typedef struct {
+    const uint8_t *data;                 // 片段数据指针
+    uint16_t len;                        // 片段长度
+} DataCommIovec;
+
 /* ========================= API函数接口 ========================= */
+/**
+  * @brief  初始化协议实例
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  config : 实例配置（回调函数等）
+  * @retval 无
+  */
+void data_comm_init_ex(DataCommHandle *handle, const DataCommConfig *config);
+
+/**
+  * @brief  打包并发送数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 实际发送（或入队）的字节数，发送队列已满时返回0
+  * @note   实例配置了transmit_async时帧进入发送队列后立即返回（非阻塞）
+  *         同一实例的发送函数只能在同一执行上下文（如主循环）中调用
+  */
+uint16_t data_comm_send_ex(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len);
+
+/**
+  * @brief  分散载荷打包并发送（scatter-gather）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  iov    : 载荷片段数组
+  * @param  iovcnt : 片段数量
+  * @retval 实际发送（或入队）的字节数（载荷总长度超过MAX_DATA_LENGTH或队列已满时返回0）
+  * @note   各片段按顺序直接拷贝到发送帧内，调用者无需先拼接
+  */
+uint16_t data_comm_sendv(DataCommHandle *handle, uint8_t cmd, const DataCommIovec *iov, uint8_t iovcnt);
+
+/**
+  * @brief  预留发送帧内的载荷空间（零拷贝组帧）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  len    : 需要预留的最大载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 载荷写入位置指针（失败返回NULL）
+  * @note   调用者直接在返回的指针处序列化载荷，然后调用data_comm_commit()发送
+  */
+uint8_t *data_comm_reserve(DataCommHandle *handle, uint16_t len);
+
+/**
+  * @brief  提交预留的载荷并发送
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  len    : 实际写入的载荷长度（不超过预留长度）
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  * @note   就地填写长度、命令、CRC和帧尾，无论成功与否都会释放预留
+  */
+uint16_t data_comm_commit(DataCommHandle *handle, uint8_t cmd, uint16_t len);
+
+/**
+  * @brief  取消预留，不发送
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_cancel(DataCommHandle *handle);
+
+/**
+  * @brief  查询当前可立即发送的帧数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 异步发送：发送队列空闲帧槽数；同步发送：1（可发送）或0（已被预留）
+  */
+uint8_t data_comm_tx_free(DataCommHandle *handle);
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  异步发送完成回调
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  * @note   在DMA/串口发送完成中断中调用，释放当前帧槽并立即启动队列中的下一帧
+  *         启用DATA_COMM_TX_PRIO时下一帧取自优先级最高的非空队列
+  */
+void data_comm_tx_complete_isr(DataCommHandle *handle);
+#endif
+
+#if DATA_COMM_TX_PRIO > 0
+/**
+  * @brief  设置发送函数使用的优先级
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级（0最高，~DATA_COMM_TX_PRIO-1）
+  * @retval 0-成功，-1-参数错误或发送缓冲区已被预留
+  * @note   作用于data_comm_send_ex()/data_comm_sendv()/data_comm_reserve()及合并、可靠、分片等所有发送，
+  *         初始化后为最低优先级DATA_COMM_TX_PRIO-1
+  */
+int8_t data_comm_set_tx_prio(DataCommHandle *handle, uint8_t prio);
+
+/**
+  * @brief  以指定优先级打包并发送数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级（0最高）
+  * @param  cmd    : 命令字节（1字节）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 实际入队的字节数，该级队列已满或超出速率限制时返回0
+  * @note   高优先级帧在当前帧发送完成后立即发送（正在发送的帧不会被打断），
+  *         最坏排队时延为一个最长低优先级帧的发送时间；未配置transmit_async时直接同步发送
+  */
+uint16_t data_comm_send_prio(DataCommHandle *handle, uint8_t prio, uint8_t cmd, uint8_t *data, uint16_t len);
+
+/**
+  * @brief  设置优先级的速率限制（令牌桶）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级
+  * @param  rate   : 每个data_comm_tick()时间单位补充的字节数（0表示不限制）
+  * @param  burst  : 令牌桶容量（字节，允许的突发量）
+  * @retval 无
+  * @note   入队时检查：剩余令牌不为负即可入队，并扣除帧长度；令牌在data_comm_tick()中补充，
+  *         设置后令牌桶为满
+  */
+void data_comm_set_tx_rate(DataCommHandle *handle, uint8_t prio, uint32_t rate, uint32_t burst);
+
+#if DATA_COMM_STATS
+/**
+  * @brief  获取优先级统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  prio   : 优先级
+  * @param  stats  : 输出统计计数快照
+  * @retval 无
+  * @note   由data_comm_reset_stats()一并清零
+  */
+void data_comm_get_tx_class_stats(DataCommHandle *handle, uint8_t prio, DataCommTxClassStats *stats);
+#endif
+#endif
+
+/**
+  * @brief  解析接收到的单个字节
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  byte   : 接收到的字节
+  * @retval 无
+  */
+void data_comm_parse_byte_ex(DataCommHandle *handle, uint8_t byte);
+
+/**
+  * @brief  批量解析接收到的数据块
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  buf    : 数据块指针
+  * @param  len    : 数据块长度
+  * @retval 无
+  */
+void data_comm_parse_buffer_ex(DataCommHandle *handle, const uint8_t *buf, size_t len);
+
+/**
+  * @brief  设置常量命令分发表
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  table  : 256项分发表（以命令字节为下标，可为const放在Flash中），NULL表示不使用
+  * @retval 无
+  */
+void data_comm_set_cmd_table(DataCommHandle *handle, const DataCommCmdEntry *table);
+
+#if DATA_COMM_CMD_REGISTER_MAX > 0
+/**
+  * @brief  运行时注册命令处理函数
+  * @param  handle  : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd     : 命令字节
+  * @param  handler : 处理函数（NULL表示注销该命令）
+  * @param  min_len : 允许的最小载荷长度
+  * @param  max_len : 允许的最大载荷长度
+  * @retval 0-成功，-1-注册表已满
+  * @note   运行时注册优先于常量分发表，建议在初始化阶段完成注册
+  */
+int8_t data_comm_register(DataCommHandle *handle, uint8_t cmd, DataCommPacketFunc handler,
+                          uint16_t min_len, uint16_t max_len);
+#endif
+
+/**
+  * @brief  获取未处理命令计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 既不在分发表中、也没有packet_handler可交付而丢弃的数据包数量
+  */
+uint32_t data_comm_cmd_unknown(DataCommHandle *handle);
+
+/**
+  * @brief  获取命令长度错误计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 载荷长度超出分发表中min_len~max_len范围而丢弃的数据包数量
+  */
+uint32_t data_comm_cmd_len_err(DataCommHandle *handle);
+
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+/**
+  * @brief  处理接收队列中的数据包
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 本次处理的数据包数量
+  * @note   在主循环中调用；解析在中断中进行，数据包回调在调用本函数的上下文中执行
+  */
+uint8_t data_comm_poll(DataCommHandle *handle);
+
+/**
+  * @brief  获取接收队列溢出丢弃的帧数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 自初始化以来因队列已满而丢弃的完整帧数量
+  */
+uint32_t data_comm_rx_overflow(DataCommHandle *handle);
+#endif
+
+#if DATA_COMM_BATCH
+/**
+  * @brief  合并发送一条短消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（不能为DATA_COMM_BATCH_CMD）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~MAX_DATA_LENGTH）
+  * @retval 0-成功（已并入合并帧或已发送），-1-失败（参数错误或发送队列已满）
+  * @note   消息先暂存在合并帧中，合并帧装满或等待超过DATA_COMM_BATCH_TIMEOUT时发送
+  *         放不进合并帧的长消息直接作为普通帧发送（先发送已合并的消息，保持顺序）
+  */
+int8_t data_comm_batch_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief  立即发送合并帧中暂存的消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 0-成功（或没有暂存消息），-1-发送队列已满，消息继续暂存
+  */
+int8_t data_comm_batch_flush(DataCommHandle *handle);
+
+#endif
+
+#if DATA_COMM_RELIABLE
+/**
+  * @brief  可靠发送一条消息
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 命令字节（对端收到后按此命令分发）
+  * @param  data   : 数据载荷指针
+  * @param  len    : 数据载荷长度（0~DATA_COMM_REL_MAX_DATA）
+  * @retval 0-成功（已进入发送窗口），-1-失败（参数错误或发送窗口已满）
+  * @note   消息保留在发送窗口中直到对端确认，超时未确认由data_comm_tick()重传
+  */
+int8_t data_comm_rel_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief  查询发送窗口中尚未确认的消息数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 未确认消息数（0表示全部已送达）
+  */
+uint8_t data_comm_rel_pending(DataCommHandle *handle);
+
+/**
+  * @brief  获取重传次数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 自初始化以来的重传帧数
+  */
+uint32_t data_comm_rel_retransmits(DataCommHandle *handle);
+
+/**
+  * @brief  获取接收窗口重新开始的次数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 对端建立会话（含首次通信和复位后重新建立）使本端接收窗口从头开始的次数
+  */
+uint32_t data_comm_rel_resyncs(DataCommHandle *handle);
+#endif
+
+#if DATA_COMM_BATCH || DATA_COMM_RELIABLE || DATA_COMM_TX_PRIO > 0
+/**
+  * @brief  协议定时处理
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  now    : 当前时间（如HAL_GetTick()），单位与DATA_COMM_BATCH_TIMEOUT、DATA_COMM_REL_RTO一致
+  * @retval 无
+  * @note   在主循环中周期调用：补充发送速率令牌，发送超时的合并帧，发送确认帧，重传超时未确认的可靠消息
+  */
+void data_comm_tick(DataCommHandle *handle, uint32_t now);
+#endif
+
+#if DATA_COMM_FRAG
+/**
+  * @brief  分片发送数据块
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  cmd    : 数据块的命令字节（对端begin回调收到的cmd）
+  * @param  data   : 数据块（发送完成前保持有效）
+  * @param  len    : 数据块长度
+  * @param  offset : 从该偏移继续发送（首次为0）
+  * @retval 已发送到的偏移：等于len表示全部发送，小于len表示发送队列已满，稍后以返回值为offset再次调用
+  * @note   每个分片载荷为DATA_COMM_FRAG_HEADER字节分片头 + 最多DATA_COMM_FRAG_DATA字节数据，
+  *         命令字节为DATA_COMM_FRAG_CMD；接收端按顺序交给config.stream回调，无需整块缓存
+  */
+uint32_t data_comm_blob_send(DataCommHandle *handle, uint8_t cmd, const uint8_t *data, uint32_t len, uint32_t offset);
+
+/**
+  * @brief  获取因分片丢失或乱序而中止的数据块数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 中止的数据块数
+  */
+uint32_t data_comm_blob_errors(DataCommHandle *handle);
+#endif
+
+#if DATA_COMM_STATS
+/**
+  * @brief  获取收发统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  stats  : 输出统计计数快照
+  * @retval 无
+  */
+void data_comm_get_stats(DataCommHandle *handle, DataCommStats *stats);
+
+/**
+  * @brief  清零收发统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_reset_stats(DataCommHandle *handle);
+
+/**
+  * @brief  通过本链路发送统计计数
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 实际发送（或入队）的字节数（失败返回0）
+  * @note   命令字节为DATA_COMM_STATS_CMD，载荷为DataCommStats各成员依次按大端序排列
+  */
+uint16_t data_comm_send_stats(DataCommHandle *handle);
+
+/**
+  * @brief  统计查询命令处理函数
+  * @param  handle : 协议实例句柄
+  * @param  cmd    : 命令字节（未使用）
+  * @param  data   : 数据载荷（未使用）
+  * @param  len    : 数据载荷长度（未使用）
+  * @retval 无
+  * @note   放入命令分发表后，对端发送该命令即可取回统计计数：
+  *         DATA_COMM_CMD(DATA_COMM_STATS_CMD, data_comm_stats_handler, 0, 0)
+  */
+void data_comm_stats_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len);
+#endif
+
+#if DATA_COMM_CAPTURE
+/**
+  * @brief  开始抓包
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  link   : 链路号（区分多个实例写入同一输出的记录）
+  * @param  mask   : 记录内容，DATA_COMM_CAP_MASK_RX/TX/FRAME的组合
+  * @param  sink   : 输出函数（NULL表示写入内置环形缓冲区，需DATA_COMM_CAPTURE_RING_SIZE>0）
+  * @retval 无
+  * @note   须在data_comm_init_ex()之后调用；先输出一条FILE记录
+  */
+void data_comm_capture_start(DataCommHandle *handle, uint8_t link, uint8_t mask, DataCommCaptureFunc sink);
+
+/**
+  * @brief  输出暂存的逐字节接收数据
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  * @note   校验通过的帧和data_comm_parse_buffer_ex()会自动先输出暂存数据，
+  *         转储前（如故障处理中）调用一次即可得到完整记录
+  */
+void data_comm_capture_flush(DataCommHandle *handle);
+
+/**
+  * @brief  停止抓包（先输出暂存的接收数据）
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @retval 无
+  */
+void data_comm_capture_stop(DataCommHandle *handle);
+
+#if DATA_COMM_CAPTURE_RING_SIZE > 0
+/**
+  * @brief  从内置环形缓冲区取出记录
+  * @param  buf  : 输出缓冲区
+  * @param  size : 输出缓冲区长度
+  * @retval 取出的字节数（只取完整记录，从最早的记录开始）
+  * @note   缓冲区满时自动覆盖最早的完整记录，取出的数据总是从记录边界开始
+  */
+size_t data_comm_capture_read(uint8_t *buf, size_t size);
+
+/**
+  * @brief  获取内置环形缓冲区因覆盖或过长而丢弃的记录数
+  * @retval 丢弃的记录数
+  */
+uint32_t data_comm_capture_dropped(void);
+#endif
+#endif
+
+/* ========================= 兼容接口（默认实例） ========================= */
 /**
   * @brief  初始化通信协议模块
   * @param  无
   * @retval 无
+  * @note   初始化默认实例，发送和接收分别回调user_transmit()和user_packet_handler()
   */
 void data_comm_init(void);
 
@@ -51,7 +942,7 @@ void data_comm_init(void);
   * @param  cmd  : 命令字节（1字节）
   * @param  data : 数据载荷指针
   * @param  len  : 数据载荷长度（0~MAX_DATA_LENGTH）
-  * @retval 实际发送的字节数
+  * @retval 实际发送（或入队）的字节数，发送队列已满时返回0
   */
 uint16_t data_comm_send(uint8_t cmd, uint8_t *data, uint16_t len);
 
@@ -63,6 +954,57 @@ uint16_t data_comm_send(uint8_t cmd, uint8_t *data, uint16_t len);
   */
 void data_comm_parse_byte(uint8_t byte);
 
+/**
+  * @brief  批量解析接收到的数据块
+  * @param  buf : 数据块指针
+  * @param  len : 数据块长度
+  * @retval 无
+  * @note   适用于DMA半满/全满中断和串口空闲中断，一次传入整段数据
+  *         解析结果与逐字节调用data_comm_parse_byte()完全一致
+  */
+void data_comm_parse_buffer(const uint8_t *buf, size_t len);
+
+/* ========================= 工具函数 ========================= */
+#if USE_CRC16
+/**
+  * @brief  增量计算CRC16-CCITT
+  * @param  crc  : 上一次的CRC值（首次计算传入CRC16_INIT）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval 更新后的CRC16值
+  * @note   多项式: 0x1021，计算方式由CRC16_METHOD选择
+  *         分段调用结果与整块调用一致，可用于边接收边校验
+  */
+uint16_t data_comm_crc16(uint16_t crc, const uint8_t *data, uint16_t len);
+#endif
+
+#if DATA_COMM_CHECKSUM
+/* 内置校验算法（check值为"123456789"的校验结果） */
+extern const DataCommChecksum data_comm_checksum_crc16;      // CRC16-CCITT，与USE_CRC16的帧格式相同，check 0x29B1
+extern const DataCommChecksum data_comm_checksum_crc32;      // CRC32（IEEE 802.3），4字节校验值，check 0xCBF43926
+extern const DataCommChecksum data_comm_checksum_fletcher16; // Fletcher-16，无查找表，check 0x1EDE
+extern const DataCommChecksum data_comm_checksum_hw;         // 外设CRC：user_checksum_hw()/user_checksum_hw_start()
+
+/**
+  * @brief  选择实例的校验算法
+  * @param  handle   : 协议实例句柄（NULL表示默认实例）
+  * @param  checksum : 校验算法（NULL表示内置CRC16，即USE_CRC16的默认行为）
+  * @retval 无
+  * @note   复位接收状态机；收发双方须使用相同算法，可在握手后切换
+  */
+void data_comm_set_checksum(DataCommHandle *handle, const DataCommChecksum *checksum);
+
+/**
+  * @brief  异步校验计算完成
+  * @param  handle : 协议实例句柄（NULL表示默认实例）
+  * @param  value  : 校验值（即final之后的值）
+  * @retval 无
+  * @note   由start启动的外设完成后调用（可在DMA完成中断中），填写校验字段并发送该帧；
+  *         完成前该实例的发送函数返回0
+  */
+void data_comm_checksum_done(DataCommHandle *handle, uint32_t value);
+#endif
+
 /* ========================= 用户实现接口 ========================= */
 /**
   * @brief  数据发送函数（用户必须实现）
@@ -83,6 +1025,81 @@ void user_transmit(uint8_t *data, uint16_t len);
   */
 void user_packet_handler(uint8_t cmd, uint8_t *data, uint16_t len);
 
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+/**
+  * @brief  异步发送函数（启用发送队列时用户必须实现）
+  * @param  data : 待发送数据缓冲区（发送完成前保持有效）
+  * @param  len  : 数据长度
+  * @retval 无
+  * @note   启动DMA发送后立即返回，发送完成中断中调用data_comm_tx_complete_isr(NULL)
+  */
+void user_transmit_async(uint8_t *data, uint16_t len);
+#endif
+
+#if DATA_COMM_STATS && DATA_COMM_STATS_CYCLES
+/**
+  * @brief  读取周期计数器（启用解析耗时统计时用户必须实现）
+  * @param  无
+  * @retval 自由运行的32位周期计数
+  * @note   示例：return DWT->CYCCNT;
+  *         也可在编译选项中定义DATA_COMM_CYCLE_COUNT()直接读取寄存器，省去函数调用
+  */
+uint32_t user_cycle_count(void);
+#endif
+
+#if DATA_COMM_RELIABLE
+/**
+  * @brief  读取可靠传输会话号（启用可靠传输且未定义DATA_COMM_REL_SESSION()时用户必须实现，库中没有默认定义）
+  * @param  无
+  * @retval 每次上电不同的会话号（0会被替换为1）
+  * @note   首次可靠发送时调用一次；确认帧按会话号区分，复位前线路上残留的旧确认不会被当作本次的确认。
+  *         也可在编译选项中定义DATA_COMM_REL_SESSION()直接读取硬件随机数
+  */
+uint8_t user_rel_session(void);
+#endif
+
+#if DATA_COMM_CHECKSUM
+/**
+  * @brief  外设CRC计算（使用data_comm_checksum_hw时可选实现，默认为软件CRC16）
+  * @param  crc  : 当前CRC值（首次为CRC16_INIT）
+  * @param  data : 数据缓冲区
+  * @param  len  : 数据长度
+  * @retval 更新后的CRC值
+  * @note   外设须配置为CRC16-CCITT（多项式0x1021，不反转），每次调用先写入crc作为初值，
+  *         使多个实例和收发方向可交替使用同一外设
+  */
+uint32_t user_checksum_hw(uint32_t crc, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief  启动外设CRC异步计算整帧（使用data_comm_checksum_hw时可选实现，默认返回0）
+  * @param  handle : 协议实例句柄
+  * @param  data   : 待计算数据（长度+命令+数据，完成前保持有效）
+  * @param  len    : 数据长度
+  * @retval 1-已启动，完成后调用data_comm_checksum_done(handle, crc)  0-未启动（改为同步计算）
+  */
+uint8_t user_checksum_hw_start(DataCommHandle *handle, const uint8_t *data, uint16_t len);
+#endif
+
+#if DATA_COMM_CAPTURE
+/**
+  * @brief  读取抓包时间戳（启用抓包时可选实现，默认返回0）
+  * @param  无
+  * @retval 自由运行的32位时间（如微秒计数）
+  * @note   也可在编译选项中定义DATA_COMM_CAPTURE_TIME()直接读取定时器
+  */
+uint32_t user_capture_time(void);
+#endif
+
+#if DATA_COMM_TX_PRIO > 0 && DATA_COMM_STATS
+/**
+  * @brief  读取发送排队时延时间戳（启用发送优先级统计时用户必须实现，默认返回0）
+  * @param  无
+  * @retval 自由运行的32位时间（如微秒计数或DWT->CYCCNT）
+  * @note   在发送函数和发送完成中断中调用；也可在编译选项中定义DATA_COMM_TX_TIME()直接读取定时器
+  */
+uint32_t user_tx_time(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
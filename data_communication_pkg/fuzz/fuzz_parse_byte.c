@@ -0,0 +1,306 @@
+/**
+  ******************************************************************************
+  * @file    fuzz_parse_byte.c
+  * @brief   data_comm_parse_byte()模糊测试
+  * @note    同一输入分别送入：
+  *            默认实例 - data_comm_parse_byte()逐字节解析（交付到user_packet_handler桩）
+  *            独立实例 - data_comm_parse_buffer_ex()分块批量解析
+  *          两种方式交付的数据包（数量+内容哈希）必须完全一致，任何不一致或越界访问都会中止
+  *          启用DATA_COMM_STREAM/DATA_COMM_FRAG时两个实例都配置流式回调（奇数命令流式接收），
+  *          流式事件（begin/逐字节内容/end）的哈希也必须一致
+  *          启用DATA_COMM_CHECKSUM时两个实例按输入长度除以4的余数选择校验算法
+  *          Clang下与libFuzzer链接（-fsanitize=fuzzer）；其他编译器使用文件末尾的独立main
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FUZZ_CHUNK   32      // 批量解析的分块长度，覆盖批量快速路径跨块的情况
+
+static DataCommHandle g_fuzz_handle;
+static uint32_t g_fuzz_packets;
+static uint32_t g_fuzz_hash;
+
+static void fuzz_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    (void)data;
+    (void)len;
+}
+
+static void fuzz_packet_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    if (len > MAX_DATA_LENGTH) {
+        abort();
+    }
+    g_fuzz_packets++;
+    g_fuzz_hash = stub_hash_packet(g_fuzz_hash, cmd, data, len);
+}
+
+#if DATA_COMM_STREAM || DATA_COMM_FRAG
+/*
+ * 流式事件哈希：[0]为默认实例，[1]为g_fuzz_handle
+ * chunk内容按字节累计到g_stream_part，与分块方式无关；逐字节解析会暂存未满的部分，
+ * 输入在帧中途结束时两种方式已交付的内容不同，所以只在end时并入g_stream_hash
+ */
+static uint32_t g_stream_hash[2];
+static uint32_t g_stream_part[2];
+static uint8_t g_stream_open[2];
+
+static uint32_t *stream_hash(DataCommHandle *handle)
+{
+    return &g_stream_hash[handle == &g_fuzz_handle];
+}
+
+static uint8_t fuzz_stream_begin(DataCommHandle *handle, uint8_t cmd, uint32_t total)
+{
+    uint8_t b[5] = {cmd, (uint8_t)(total >> 24), (uint8_t)(total >> 16), (uint8_t)(total >> 8), (uint8_t)total};
+    
+    if ((cmd & 1) == 0) {
+        return 0;
+    }
+    if (g_stream_open[handle == &g_fuzz_handle]) {
+        abort();    /* begin/end必须成对 */
+    }
+    g_stream_open[handle == &g_fuzz_handle] = 1;
+    g_stream_part[handle == &g_fuzz_handle] = 0;
+    *stream_hash(handle) = stub_hash_packet(*stream_hash(handle), 'B', b, sizeof(b));
+    return 1;
+}
+
+static void fuzz_stream_chunk(DataCommHandle *handle, const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+    
+    if (len == 0 || !g_stream_open[handle == &g_fuzz_handle]) {
+        abort();
+    }
+    for (i = 0; i < len; i++) {
+        g_stream_part[handle == &g_fuzz_handle] = stub_hash_packet(g_stream_part[handle == &g_fuzz_handle], 'C', &data[i], 1);
+    }
+}
+
+static void fuzz_stream_end(DataCommHandle *handle, uint8_t ok)
+{
+    if (!g_stream_open[handle == &g_fuzz_handle]) {
+        abort();
+    }
+    g_stream_open[handle == &g_fuzz_handle] = 0;
+    *stream_hash(handle) ^= g_stream_part[handle == &g_fuzz_handle];
+    *stream_hash(handle) = stub_hash_packet(*stream_hash(handle), 'E', &ok, 1);
+}
+
+static void fuzz_default_handler(DataCommHandle *handle, uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    user_packet_handler(cmd, data, len);
+}
+
+static const DataCommStreamOps g_fuzz_stream = {fuzz_stream_begin, fuzz_stream_chunk, fuzz_stream_end};
+#endif
+
+#if DATA_COMM_CHECKSUM
+/* 按输入长度选择的校验算法：生成器按所选算法组帧后把长度截断到对应余数 */
+static const DataCommChecksum *const g_fuzz_checksum[4] = {
+    NULL, &data_comm_checksum_crc32, &data_comm_checksum_fletcher16, &data_comm_checksum_hw
+};
+#endif
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    DataCommConfig config;
+    size_t i, chunk;
+    
+    memset(&config, 0, sizeof(config));
+    config.transmit = fuzz_transmit;
+    config.packet_handler = fuzz_packet_handler;
+    
+    data_comm_init();
+#if DATA_COMM_STREAM || DATA_COMM_FRAG
+    /* 默认实例仍交付到user_packet_handler()桩，另加流式回调 */
+    {
+        DataCommConfig def = {fuzz_transmit, fuzz_default_handler, NULL, NULL, NULL, &g_fuzz_stream};
+        
+        data_comm_init_ex(NULL, &def);
+    }
+    config.stream = &g_fuzz_stream;
+    memset(g_stream_hash, 0, sizeof(g_stream_hash));
+    memset(g_stream_part, 0, sizeof(g_stream_part));
+    memset(g_stream_open, 0, sizeof(g_stream_open));
+#endif
+    data_comm_init_ex(&g_fuzz_handle, &config);
+#if DATA_COMM_CHECKSUM
+    data_comm_set_checksum(NULL, g_fuzz_checksum[size % 4]);
+    data_comm_set_checksum(&g_fuzz_handle, g_fuzz_checksum[size % 4]);
+#endif
+    stub_reset();
+    g_fuzz_packets = 0;
+    g_fuzz_hash = stub_rx_hash;
+    
+    /* 逐字节解析 */
+    for (i = 0; i < size; i++) {
+        data_comm_parse_byte(data[i]);
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+        data_comm_poll(NULL);
+#endif
+    }
+    
+    /* 分块批量解析 */
+    for (i = 0; i < size; i += chunk) {
+        chunk = (size - i < FUZZ_CHUNK) ? size - i : FUZZ_CHUNK;
+        data_comm_parse_buffer_ex(&g_fuzz_handle, data + i, chunk);
+#if DATA_COMM_RX_QUEUE_SIZE > 0
+        data_comm_poll(&g_fuzz_handle);
+#endif
+    }
+    
+    if (stub_rx_packets != g_fuzz_packets || stub_rx_hash != g_fuzz_hash) {
+        abort();
+    }
+#if DATA_COMM_STREAM || DATA_COMM_FRAG
+    if (g_stream_hash[0] != g_stream_hash[1] || g_stream_open[0] != g_stream_open[1]) {
+        abort();
+    }
+#endif
+    return 0;
+}
+
+#ifndef DATA_COMM_FUZZ_LIBFUZZER
+/* ========================= 独立运行入口 ========================= */
+/*
+ * 无libFuzzer时的回归测试入口：
+ *   fuzz_parse_byte file...      依次运行指定的输入文件（如libFuzzer产生的crash文件）
+ *   fuzz_parse_byte [-n 次数]     运行随机生成的输入：合法帧 + 随机字节 + 随机位翻转
+ */
+static uint32_t g_rand = 2463534242u;
+
+static uint32_t fuzz_rand(void)
+{
+    g_rand ^= g_rand << 13;
+    g_rand ^= g_rand >> 17;
+    g_rand ^= g_rand << 5;
+    return g_rand;
+}
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static size_t g_stream_size;
+
+static void stream_transmit(DataCommHandle *handle, uint8_t *data, uint16_t len)
+{
+    (void)handle;
+    if (g_stream_len + len <= g_stream_size) {
+        memcpy(g_stream + g_stream_len, data, len);
+        g_stream_len += len;
+    }
+}
+
+/**
+  * @brief  生成一段随机输入：以合法帧为主，夹杂随机字节，最后做少量位翻转
+  */
+static size_t fuzz_generate(uint8_t *buf, size_t size)
+{
+    static DataCommHandle gen;
+    static uint8_t payload[MAX_DATA_LENGTH];
+    DataCommConfig config;
+    uint16_t len, k;
+    uint32_t flips;
+#if DATA_COMM_CHECKSUM
+    uint32_t sel;
+#endif
+    
+    memset(&config, 0, sizeof(config));
+    config.transmit = stream_transmit;
+    data_comm_init_ex(&gen, &config);
+#if DATA_COMM_CHECKSUM
+    sel = fuzz_rand() % 4;
+    data_comm_set_checksum(&gen, g_fuzz_checksum[sel]);
+#endif
+    
+    g_stream = buf;
+    g_stream_size = size;
+    g_stream_len = 0;
+    while (g_stream_len + DATA_COMM_FRAME_SIZE < size) {
+        if (fuzz_rand() % 4 == 0) {
+            /* 随机字节 */
+            len = (uint16_t)(fuzz_rand() % 16);
+            for (k = 0; k < len; k++) {
+                buf[g_stream_len++] = (uint8_t)fuzz_rand();
+            }
+#if DATA_COMM_FRAG
+        } else if (fuzz_rand() % 8 == 0) {
+            /* 分片数据块（超过DATA_COMM_FRAG_DATA时为两个分片，可能因缓冲区满而截断） */
+            len = (uint16_t)(fuzz_rand() % (MAX_DATA_LENGTH + 1));
+            for (k = 0; k < len; k++) {
+                payload[k] = (uint8_t)fuzz_rand();
+            }
+            data_comm_blob_send(&gen, (uint8_t)fuzz_rand(), payload, len, 0);
+#endif
+        } else {
+            /* 合法帧，偏向短帧 */
+            len = (uint16_t)(fuzz_rand() % ((fuzz_rand() % 4 == 0) ? MAX_DATA_LENGTH + 1 : 16));
+            for (k = 0; k < len; k++) {
+                payload[k] = (uint8_t)fuzz_rand();
+            }
+            data_comm_send_ex(&gen, (uint8_t)fuzz_rand(), payload, len);
+        }
+    }
+    
+    flips = fuzz_rand() % 8;
+    while (flips-- && g_stream_len > 0) {
+        buf[fuzz_rand() % g_stream_len] ^= (uint8_t)(1u << (fuzz_rand() % 8));
+    }
+#if DATA_COMM_CHECKSUM
+    while (g_stream_len > 4 && g_stream_len % 4 != sel) {
+        g_stream_len--;
+    }
+#endif
+    return g_stream_len;
+}
+
+static int fuzz_run_file(const char *path)
+{
+    static uint8_t buf[1 << 20];
+    FILE *fp = fopen(path, "rb");
+    size_t n;
+    
+    if (fp == NULL) {
+        printf("cannot open %s\n", path);
+        return 1;
+    }
+    n = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    LLVMFuzzerTestOneInput(buf, n);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[8 * DATA_COMM_FRAME_SIZE];
+    unsigned long runs = 2000, n;
+    int i;
+    
+    if (argc >= 3 && strcmp(argv[1], "-n") == 0) {
+        runs = strtoul(argv[2], NULL, 0);
+    } else if (argc >= 2) {
+        for (i = 1; i < argc; i++) {
+            if (fuzz_run_file(argv[i]) != 0) {
+                return 1;
+            }
+        }
+        printf("%d inputs OK\n", argc - 1);
+        return 0;
+    }
+    
+    for (n = 0; n < runs; n++) {
+        LLVMFuzzerTestOneInput(buf, fuzz_generate(buf, 1 + fuzz_rand() % sizeof(buf)));
+    }
+    printf("%lu random inputs OK, %u packets in last input\n", runs, g_fuzz_packets);
+    return 0;
+}
+#endif
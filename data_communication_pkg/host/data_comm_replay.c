@@ -0,0 +1,221 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_replay.c
+  * @brief   抓包文件回放工具（Linux）
+  * @note    用mmap映射抓包文件（格式见data_communication_pkg.h的抓包记录格式），
+  *          把指定链路的RX记录依次送入默认实例：
+  *            byte - 逐字节调用data_comm_parse_byte()
+  *            buf  - 按原记录分块调用data_comm_parse_buffer()
+  *          两种方式交付的数据包必须一致；文件中有该链路的FRAME记录时，
+  *          交付的数据包还必须与现场记录的帧一致（用于复现现场问题）。
+  *          输出每种方式的吞吐率，可用于真实流量上的性能回归。
+  *          data_comm_replay [-l 链路号] [-r 重复次数] 抓包文件
+  *          回放程序的协议配置须与抓包时一致（FILE记录中的配置标志不符时报错）
+  ******************************************************************************
+  */
+
+#define _DEFAULT_SOURCE
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* 抓包文件扫描结果 */
+typedef struct {
+    uint32_t rx_records;
+    uint64_t rx_bytes;
+    uint32_t tx_records;
+    uint32_t frames;                     // 该链路FRAME记录数
+    uint32_t frame_hash;                 // 该链路FRAME记录的累计哈希（与stub_rx_hash算法相同）
+    uint32_t file_records;
+} CaptureInfo;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint16_t rec_len(const uint8_t *rec)
+{
+    return (uint16_t)((rec[2] << 8) | rec[3]);
+}
+
+/**
+  * @brief  检查记录链完整性并统计指定链路的记录
+  * @retval 0: 成功  -1: 文件损坏或配置不符
+  */
+static int capture_scan(const uint8_t *p, size_t size, uint8_t link, CaptureInfo *info)
+{
+    size_t off = 0;
+    const uint8_t *rec;
+    uint16_t len;
+
+    memset(info, 0, sizeof(*info));
+    info->frame_hash = stub_rx_hash;
+    while (off < size) {
+        rec = p + off;
+        if (size - off < DATA_COMM_CAP_HEAD_SIZE || size - off - DATA_COMM_CAP_HEAD_SIZE < rec_len(rec)) {
+            fprintf(stderr, "truncated record at offset %zu\n", off);
+            return -1;
+        }
+        len = rec_len(rec);
+        switch (rec[0]) {
+            case DATA_COMM_CAP_FILE:
+                if (len < DATA_COMM_CAP_FILE_SIZE || memcmp(&rec[8], "DCAP", 4) != 0) {
+                    fprintf(stderr, "bad file record at offset %zu\n", off);
+                    return -1;
+                }
+                if (rec[12] != DATA_COMM_CAP_VERSION || rec[13] != DATA_COMM_CAP_FLAGS ||
+                    ((rec[14] << 8) | rec[15]) != MAX_DATA_LENGTH ||
+                    ((rec[16] << 8) | rec[17]) != FRAME_HEADER || ((rec[18] << 8) | rec[19]) != FRAME_END) {
+                    fprintf(stderr, "capture (version %u, flags 0x%02X, max %u) does not match this build "
+                            "(version %u, flags 0x%02X, max %u)\n", rec[12], rec[13], (rec[14] << 8) | rec[15],
+                            DATA_COMM_CAP_VERSION, DATA_COMM_CAP_FLAGS, MAX_DATA_LENGTH);
+                    return -1;
+                }
+                info->file_records++;
+                break;
+            case DATA_COMM_CAP_RX:
+                if (rec[1] == link) {
+                    info->rx_records++;
+                    info->rx_bytes += len;
+                }
+                break;
+            case DATA_COMM_CAP_TX:
+                if (rec[1] == link) {
+                    info->tx_records++;
+                }
+                break;
+            case DATA_COMM_CAP_FRAME:
+                if (len < 1) {
+                    fprintf(stderr, "bad frame record at offset %zu\n", off);
+                    return -1;
+                }
+                if (rec[1] == link) {
+                    info->frames++;
+                    info->frame_hash = stub_hash_packet(info->frame_hash, rec[8], &rec[9], (uint16_t)(len - 1));
+                }
+                break;
+            default:
+                fprintf(stderr, "unknown record type %u at offset %zu\n", rec[0], off);
+                return -1;
+        }
+        off += DATA_COMM_CAP_HEAD_SIZE + len;
+    }
+    return 0;
+}
+
+/**
+  * @brief  回放一遍指定链路的RX记录
+  * @param  bulk : 0-逐字节解析  1-按记录批量解析
+  */
+static void capture_replay(const uint8_t *p, size_t size, uint8_t link, int bulk)
+{
+    size_t off = 0;
+    const uint8_t *rec, *data;
+    uint16_t len, i;
+
+    while (off < size) {
+        rec = p + off;
+        len = rec_len(rec);
+        data = rec + DATA_COMM_CAP_HEAD_SIZE;
+        if (rec[0] == DATA_COMM_CAP_RX && rec[1] == link) {
+            if (bulk) {
+                data_comm_parse_buffer(data, len);
+            } else {
+                for (i = 0; i < len; i++) {
+                    data_comm_parse_byte(data[i]);
+                }
+            }
+        }
+        off += DATA_COMM_CAP_HEAD_SIZE + len;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static const char *mode_name[] = {"byte", "buf"};
+    const char *path = NULL;
+    uint8_t link = 0;
+    int repeat = 1, opt, fd, bulk, r, fail = 0;
+    uint32_t packets[2], hash[2];
+    struct stat st;
+    const uint8_t *p;
+    CaptureInfo info;
+    double t;
+
+    while ((opt = getopt(argc, argv, "l:r:")) != -1) {
+        switch (opt) {
+            case 'l': link = (uint8_t)atoi(optarg); break;
+            case 'r': repeat = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-l link] [-r repeat] capture_file\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-l link] [-r repeat] capture_file\n", argv[0]);
+        return 2;
+    }
+    path = argv[optind];
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        return 2;
+    }
+    if (st.st_size == 0) {
+        fprintf(stderr, "%s: empty capture\n", path);
+        return 2;
+    }
+    p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        return 2;
+    }
+    madvise((void *)p, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    stub_reset();
+    if (capture_scan(p, (size_t)st.st_size, link, &info) != 0) {
+        return 2;
+    }
+    printf("%s: %lld bytes, link %u: %u RX records (%llu bytes), %u TX records, %u frame records%s\n",
+           path, (long long)st.st_size, link, info.rx_records, (unsigned long long)info.rx_bytes,
+           info.tx_records, info.frames, info.file_records ? "" : " (no file record, config not checked)");
+
+    for (bulk = 0; bulk < 2; bulk++) {
+        t = now_seconds();
+        for (r = 0; r < repeat; r++) {
+            stub_reset();
+            data_comm_init();
+            capture_replay(p, (size_t)st.st_size, link, bulk);
+        }
+        t = now_seconds() - t;
+        packets[bulk] = stub_rx_packets;
+        hash[bulk] = stub_rx_hash;
+        printf("  %-4s %8u packets  %8.1f MB/s\n", mode_name[bulk], packets[bulk],
+               t > 0 ? (double)info.rx_bytes * repeat / t / 1e6 : 0.0);
+    }
+
+    if (packets[0] != packets[1] || hash[0] != hash[1]) {
+        printf("FAIL: byte-wise and bulk replay delivered different packets\n");
+        fail = 1;
+    }
+    if (info.frames > 0 && (packets[0] != info.frames || hash[0] != info.frame_hash)) {
+        printf("FAIL: replay delivered %u packets, capture recorded %u frames%s\n", packets[0], info.frames,
+               packets[0] == info.frames ? " with different contents" : "");
+        fail = 1;
+    }
+
+    munmap((void *)p, (size_t)st.st_size);
+    return fail;
+}
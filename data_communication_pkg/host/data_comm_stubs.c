@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_stubs.c
+  * @brief   主机端构建用的用户函数桩
+  ******************************************************************************
+  */
+
+#include "data_communication_pkg.h"
+#include "data_comm_stubs.h"
+#include <stdlib.h>
+
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+uint32_t stub_tx_frames;
+uint32_t stub_tx_bytes;
+uint32_t stub_rx_packets;
+uint32_t stub_rx_hash = FNV_OFFSET;
+
+void stub_reset(void)
+{
+    stub_tx_frames = 0;
+    stub_tx_bytes = 0;
+    stub_rx_packets = 0;
+    stub_rx_hash = FNV_OFFSET;
+}
+
+uint32_t stub_hash_packet(uint32_t hash, uint8_t cmd, const uint8_t *data, uint16_t len)
+{
+    uint16_t i;
+    
+    hash = (hash ^ cmd) * FNV_PRIME;
+    hash = (hash ^ (uint8_t)(len >> 8)) * FNV_PRIME;
+    hash = (hash ^ (uint8_t)len) * FNV_PRIME;
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/* ========================= 用户函数桩 ========================= */
+void user_transmit(uint8_t *data, uint16_t len)
+{
+    (void)data;
+    stub_tx_frames++;
+    stub_tx_bytes += len;
+}
+
+void user_packet_handler(uint8_t cmd, uint8_t *data, uint16_t len)
+{
+    /* 解析器不应交付超过最大长度的数据包 */
+    if (len > MAX_DATA_LENGTH) {
+        abort();
+    }
+    stub_rx_packets++;
+    stub_rx_hash = stub_hash_packet(stub_rx_hash, cmd, data, len);
+}
+
+#if DATA_COMM_TX_QUEUE_SIZE > 0
+void user_transmit_async(uint8_t *data, uint16_t len)
+{
+    /* 立即完成发送，便于主机端测试队列逻辑 */
+    (void)data;
+    stub_tx_frames++;
+    stub_tx_bytes += len;
+    data_comm_tx_complete_isr(NULL);
+}
+#endif
+
+#if DATA_COMM_RELIABLE
+uint8_t user_rel_session(void)
+{
+    return 1;
+}
+#endif
@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    data_comm_stubs.h
+  * @brief   主机端构建用的用户函数桩
+  * @note    覆盖data_communication_pkg.c中的弱符号user_xxx()，记录默认实例的收发情况；
+  *          CHECK供bench/下各测试共用，失败时打印位置并以1退出
+  ******************************************************************************
+  */
+
+#ifndef __DATA_COMM_STUBS_H
+#define __DATA_COMM_STUBS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ========================= 检查宏 ========================= */
+#define CHECK(cond)  do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); exit(1); } } while (0)
+
+/* ========================= 桩函数记录 ========================= */
+extern uint32_t stub_tx_frames;     // user_transmit()调用次数
+extern uint32_t stub_tx_bytes;      // user_transmit()发送字节数
+extern uint32_t stub_rx_packets;    // user_packet_handler()调用次数
+extern uint32_t stub_rx_hash;       // 所有收到数据包（命令+长度+数据）的FNV-1a累计哈希
+
+/**
+  * @brief  清零桩函数记录
+  */
+void stub_reset(void);
+
+/**
+  * @brief  把一个数据包累加到FNV-1a哈希
+  * @param  hash : 当前哈希值
+  * @param  cmd  : 命令字节
+  * @param  data : 数据载荷
+  * @param  len  : 数据载荷长度
+  * @retval 新的哈希值
+  */
+uint32_t stub_hash_packet(uint32_t hash, uint8_t cmd, const uint8_t *data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DATA_COMM_STUBS_H */